@@ -0,0 +1,166 @@
+#include "AIScheduler.h"
+#include "Profiler.h"
+#include <algorithm>
+
+AIScheduler::AIScheduler() :
+	m_frame(0),
+	m_cursor(0),
+	m_fixedAgentBudget(1000),
+	m_lodScale(1),
+	m_budget(1000.0f),
+	m_costPerAgent(1.0f),
+	m_maximumPendingTime(0.5f),
+	m_nearDistance(100.0f),
+	m_farDistance(300.0f),
+	m_updateStart(0),
+	m_deterministic(false)
+{}
+
+AIScheduler::~AIScheduler()
+{}
+
+void AIScheduler::Init(unsigned int capacity)
+{
+	m_pendingTime.assign(capacity, 0.0f);
+	m_due.assign(capacity, 0);
+	m_agents.reserve(capacity);
+	m_overdue.reserve(capacity);
+	m_deltaTimes.reserve(capacity);
+	m_frame = 0;
+	m_cursor = 0;
+	m_lodScale = 1;
+}
+
+// -------------------
+// Descripción: Función que elige los agentes que se actualizan este cuadro, sin pasar nunca del presupuesto. Primero
+// entran los que llevan más del tiempo máximo pendiente (los más antiguos antes), después los cercanos o visibles y el
+// resto de pendientes en orden circular. Si algún atrasado se queda fuera, los intervalos se alargan al doble para el
+// cuadro siguiente; cuando sobra la mitad del presupuesto se vuelven a acortar.
+// -------------------
+void AIScheduler::Schedule(const float* posX, const float* posZ, unsigned int count, Camera& cam, float dt)
+{
+	m_agents.clear();
+	m_deltaTimes.clear();
+	m_overdue.clear();
+
+	if (count == 0)
+		return;
+
+	++m_frame;
+
+	glm::vec3 cameraPos = cam.GetCameraPos();
+	glm::vec3 forward = cam.GetCameraForward();
+	glm::vec2 forwardXZ = glm::length(glm::vec2(forward.x, forward.z)) > 0.0f ? glm::normalize(glm::vec2(forward.x, forward.z)) : glm::vec2(0.0f, 1.0f);
+
+	float nearSquared = m_nearDistance * m_nearDistance;
+	float farSquared = m_farDistance * m_farDistance;
+	float maximumPendingTime = m_maximumPendingTime * m_lodScale;
+
+	// Número de agentes que caben en el presupuesto según lo que costó cada uno en los cuadros anteriores. En las
+	// repeticiones la elección no puede depender del reloj: se usa el presupuesto fijo en agentes.
+	unsigned int maximumAgents = m_deterministic ? std::max(1u, m_fixedAgentBudget) :
+		std::max(1u, (unsigned int)(m_budget / std::max(m_costPerAgent, 0.001f)));
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		m_pendingTime[i] += dt;
+
+		float dx = posX[i] - cameraPos.x;
+		float dz = posZ[i] - cameraPos.z;
+		float distanceSquared = dx * dx + dz * dz;
+
+		// Los agentes dentro del cono de visión suben un nivel de detalle
+		bool visible = dx * forwardXZ.x + dz * forwardXZ.y > 0.5f * std::sqrt(distanceSquared);
+
+		unsigned int interval;
+
+		if (distanceSquared < nearSquared)
+			interval = LOD_NEAR_INTERVAL;
+		else if (distanceSquared < farSquared)
+			interval = visible ? LOD_NEAR_INTERVAL : LOD_MEDIUM_INTERVAL;
+		else
+			interval = visible ? LOD_MEDIUM_INTERVAL : LOD_FAR_INTERVAL;
+
+		bool nearby = interval == LOD_NEAR_INTERVAL;
+
+		// Escalonar por índice para que los agentes lejanos no se actualicen todos en el mismo cuadro
+		m_due[i] = (m_frame + i) % (interval * m_lodScale) == 0 ? (nearby ? 2 : 1) : 0;
+
+		if (m_pendingTime[i] >= maximumPendingTime)
+		{
+			m_overdue.push_back(i);
+			m_due[i] = 0;
+		}
+	}
+
+	// Los atrasados primero, del más antiguo al más reciente (a igual tiempo, por índice para que sea reproducible)
+	const std::vector<float>& pendingTime = m_pendingTime;
+
+	std::sort(m_overdue.begin(), m_overdue.end(), [&pendingTime](unsigned int a, unsigned int b)
+	{
+		return pendingTime[a] != pendingTime[b] ? pendingTime[a] > pendingTime[b] : a < b;
+	});
+
+	bool overBudget = m_overdue.size() > maximumAgents;
+
+	for (unsigned int i = 0; i < m_overdue.size() && m_agents.size() < maximumAgents; ++i)
+	{
+		m_agents.push_back(m_overdue[i]);
+		m_deltaTimes.push_back(m_pendingTime[m_overdue[i]]);
+		m_pendingTime[m_overdue[i]] = 0.0f;
+	}
+
+	for (unsigned int i = 0; i < count && m_agents.size() < maximumAgents; ++i)
+	{
+		if (m_due[i] != 2)
+			continue;
+
+		m_agents.push_back(i);
+		m_deltaTimes.push_back(m_pendingTime[i]);
+		m_pendingTime[i] = 0.0f;
+		m_due[i] = 0;
+	}
+
+	// Repartir lo que queda del presupuesto entre los agentes lejanos, continuando donde se quedó el cuadro anterior
+	if (m_cursor >= count)
+		m_cursor = 0;
+
+	for (unsigned int visited = 0; visited < count && m_agents.size() < maximumAgents; ++visited)
+	{
+		unsigned int i = m_cursor;
+		m_cursor = m_cursor + 1 < count ? m_cursor + 1 : 0;
+
+		if (m_due[i] == 0)
+			continue;
+
+		m_agents.push_back(i);
+		m_deltaTimes.push_back(m_pendingTime[i]);
+		m_pendingTime[i] = 0.0f;
+		m_due[i] = 0;
+	}
+
+	// Los atrasados que no cupieron siguen pendientes; con intervalos más largos habrá menos agentes en turno
+	if (overBudget)
+		m_lodScale = std::min(m_lodScale * 2, (unsigned int)MAXIMUM_LOD_SCALE);
+	else if (m_lodScale > 1 && m_agents.size() * 2 < maximumAgents)
+		m_lodScale /= 2;
+}
+
+void AIScheduler::BeginUpdate()
+{
+	m_updateStart = SDL_GetPerformanceCounter();
+}
+
+// -------------------
+// Descripción: Función que mide lo que costó la actualización y ajusta el coste estimado por agente
+// (en modo determinista la estimación no se usa para planificar, solo se informa)
+// -------------------
+void AIScheduler::EndUpdate()
+{
+	float elapsed = (float)((SDL_GetPerformanceCounter() - m_updateStart) * 1000000.0 / SDL_GetPerformanceFrequency());
+
+	if (!m_agents.empty())
+		m_costPerAgent = 0.9f * m_costPerAgent + 0.1f * (elapsed / m_agents.size());
+
+	Profiler::GetInstance().AddSample("AI update", elapsed / 1000.0f);
+}
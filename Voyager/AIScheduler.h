@@ -0,0 +1,56 @@
+#pragma once
+#ifndef __AISCHEDULER_H__
+#define __AISCHEDULER_H__
+
+#include "Camera.h"
+#include "Dependencies/SDL2/include/SDL.h"
+#include <vector>
+
+// Planificador del nivel de detalle de la IA: decide qué agentes se actualizan en cada cuadro según su
+// distancia y si están a la vista. Los agentes lejanos se actualizan cada N cuadros con el tiempo acumulado
+// y el total de agentes por cuadro se limita para respetar un presupuesto fijo en microsegundos. Si ni así caben los que
+// llevan demasiado tiempo sin actualizarse, los intervalos se alargan hasta que vuelvan a caber. En modo determinista
+// (repeticiones) el límite es un número fijo de agentes, porque el coste medido con el reloj cambia en cada ejecución.
+class AIScheduler
+{
+public:
+	AIScheduler();
+	~AIScheduler();
+
+	void Init(unsigned int capacity);
+	void Schedule(const float* posX, const float* posZ, unsigned int count, Camera& cam, float dt);
+
+	void BeginUpdate();
+	void EndUpdate();
+
+	void SetBudget(float microseconds) { m_budget = microseconds; }
+	void SetLodDistances(float nearDistance, float farDistance) { m_nearDistance = nearDistance; m_farDistance = farDistance; }
+	void SetDeterministic(bool deterministic) { m_deterministic = deterministic; }
+	void SetFixedAgentBudget(unsigned int agents) { m_fixedAgentBudget = agents; }
+
+	const std::vector<unsigned int>& GetAgents() { return m_agents; }
+	const std::vector<float>& GetDeltaTimes() { return m_deltaTimes; }
+	float GetBudget() { return m_budget; }
+	float GetCostPerAgent() { return m_costPerAgent; }
+	unsigned int GetLodScale() { return m_lodScale; }
+
+private:
+	// Cada cuántos cuadros se actualiza un agente en cada nivel de detalle
+	enum { LOD_NEAR_INTERVAL = 1, LOD_MEDIUM_INTERVAL = 4, LOD_FAR_INTERVAL = 16 };
+	// Factor máximo por el que se multiplican los intervalos (y el tiempo máximo pendiente) cuando no hay presupuesto
+	enum { MAXIMUM_LOD_SCALE = 8 };
+
+	std::vector<float> m_pendingTime;
+	std::vector<unsigned char> m_due;
+	std::vector<unsigned int> m_agents;
+	std::vector<unsigned int> m_overdue;
+	std::vector<float> m_deltaTimes;
+
+	unsigned int m_frame, m_cursor, m_fixedAgentBudget, m_lodScale;
+	float m_budget, m_costPerAgent, m_maximumPendingTime;
+	float m_nearDistance, m_farDistance;
+	Uint64 m_updateStart;
+	bool m_deterministic;
+};
+
+#endif // !__AISCHEDULER_H__
@@ -0,0 +1,186 @@
+#include "AsteroidBelt.h"
+#include "Random.h"
+#include "Dependencies/glm-0.9.9-a2/glm/gtc/constants.hpp"
+#include "Dependencies/glm-0.9.9-a2/glm/gtc/packing.hpp"
+#include <cmath>
+#include <cstddef>
+
+static_assert(sizeof(AsteroidBelt::Instance) == 24, "InstancingVert.vs expects 24 bytes per asteroid");
+
+AsteroidBelt::Settings::Settings() :
+	m_count(20000),
+	m_center(300.0f, 148.0f, 390.0f),
+	m_radius(400.0f),
+	m_spread(60.0f, 222.0f, 60.0f),
+	m_minScale(0.35f),
+	m_maxScale(0.6f),
+	m_rotationAxis(0.5f, 0.7f, 0.9f),
+	m_axisJitter(0.0f),
+	m_minSpeed(0.05f),
+	m_maxSpeed(0.3f)
+{}
+
+AsteroidBelt::AsteroidBelt() :
+	m_model(nullptr),
+	m_cullMode(CULL_NONE)
+{}
+
+AsteroidBelt::~AsteroidBelt()
+{}
+
+// -------------------
+// Descripción: Función que crea el búfer de instancias con el formato compacto, lo engancha a las mallas del modelo y
+// genera el anillo. El búfer es estático: el giro lo anima el sombreador.
+// -------------------
+void AsteroidBelt::Init(Model& asteroid, const Settings& settings)
+{
+	m_model = &asteroid;
+	m_settings = settings;
+
+	InitLayout(m_instances, m_settings.m_count, GL_STATIC_DRAW);
+	InitLayout(m_visibleInstances, m_settings.m_count, GL_STREAM_DRAW);
+	m_cullSet.m_source = &m_instances;
+	m_cullSet.m_visible = &m_visibleInstances;
+	SetCullMode(m_cullMode);
+
+	Generate();
+}
+
+// -------------------
+// Descripción: Función que (re)coloca todas las instancias según Settings. Nueve valores aleatorios por asteroide,
+// generados de una vez desde el flujo de los asteroides (el mismo cinturón para la misma semilla).
+// -------------------
+void AsteroidBelt::Generate()
+{
+	const unsigned int RANDOMS_PER_ASTEROID = 9;
+	unsigned int count = m_settings.m_count;
+	std::vector<float> randoms(count * RANDOMS_PER_ASTEROID);
+	RandomStream random = Random::GetInstance().GetStream(Random::STREAM_ASTEROIDS, 0);
+	random.Fill(randoms.data(), (unsigned int)randoms.size(), -1.0f, 1.0f);
+
+	glm::vec3 baseAxis = glm::normalize(m_settings.m_rotationAxis);
+	float modelRadius = m_model != nullptr ? m_model->GetBoundingRadius() : 1.0f;
+	m_instances.Resize(count);
+	m_cullSet.Resize(count);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const float* r = &randoms[i * RANDOMS_PER_ASTEROID];
+		float angle = (float)i / (float)count * glm::two_pi<float>();
+
+		Instance instance;
+		instance.m_position = m_settings.m_center + glm::vec3(sin(angle), 0.0f, cos(angle)) * m_settings.m_radius;
+		instance.m_position += glm::vec3(r[0], r[1], r[2]) * m_settings.m_spread;
+		instance.m_scale = glm::mix(m_settings.m_minScale, m_settings.m_maxScale, r[3] * 0.5f + 0.5f);
+
+		glm::vec3 axis = baseAxis + glm::vec3(r[6], r[7], r[8]) * m_settings.m_axisJitter;
+		EncodeAxis(glm::length(axis) > 0.0001f ? glm::normalize(axis) : baseAxis, instance.m_axis);
+
+		float speed = glm::mix(m_settings.m_minSpeed, m_settings.m_maxSpeed, r[5] * 0.5f + 0.5f);
+		instance.m_spin[0] = glm::packHalf1x16(speed);
+		instance.m_spin[1] = glm::packHalf1x16(r[4] * glm::pi<float>());
+
+		m_instances.Set(i, &instance);
+
+		// El giro es alrededor del origen del modelo: la esfera no depende de la rotación y sirve para todo el cuadro
+		m_cullSet.SetSphere(i, instance.m_position, instance.m_scale * modelRadius);
+	}
+
+	m_instances.Upload();
+}
+
+// -------------------
+// Descripción: Función que elige dónde se recorta el cinturón. Con recorte, las mallas se enganchan al búfer compacto y
+// hay que llamar al Cull del modo elegido cada cuadro antes de dibujar; en la GPU además dibujan con los comandos
+// indirectos del conjunto, cuyo número de instancias escribe el sombreador de cálculo.
+// -------------------
+void AsteroidBelt::SetCullMode(CullMode mode)
+{
+	m_cullMode = mode;
+
+	if (m_model == nullptr)
+		return;
+
+	if (m_cullMode == CULL_GPU && m_gpuCullSet.m_commandBuffer == 0)
+		m_gpuCullSet.Init(m_instances, m_visibleInstances, *m_model);
+
+	m_model->SetInstances(m_cullMode == CULL_NONE ? &m_instances : &m_visibleInstances);
+	m_model->SetIndirect(m_cullMode == CULL_GPU ? m_gpuCullSet.m_commandBuffer : 0, sizeof(DrawElementsIndirectCommand));
+}
+
+void AsteroidBelt::Cull(FrustumCuller& culler, const OcclusionCuller* occlusion)
+{
+	if (m_cullMode != CULL_CPU || m_model == nullptr)
+		return;
+
+	culler.CullInstances(m_cullSet, occlusion);
+	m_visibleInstances.Upload();
+}
+
+void AsteroidBelt::Cull(GpuCuller& culler)
+{
+	if (m_cullMode != CULL_GPU || m_model == nullptr)
+		return;
+
+	culler.Cull(m_gpuCullSet);
+}
+
+void AsteroidBelt::Draw(Camera& cam)
+{
+	if (m_model != nullptr)
+		m_model->DrawInstanced(cam);
+}
+
+void AsteroidBelt::Submit(RenderQueue& queue)
+{
+	if (m_model != nullptr)
+		m_model->SubmitInstanced(queue);
+}
+
+// Los dos búferes (todas las instancias y las visibles) comparten el formato de InstancingVert.vs
+void AsteroidBelt::InitLayout(InstanceBuffer& buffer, unsigned int capacity, GLenum usage)
+{
+	buffer.Init(sizeof(Instance), capacity, usage);
+	buffer.AddAttribute(POSITION_SCALE_ATTRIBUTE, 4, GL_FLOAT, offsetof(Instance, m_position));
+	buffer.AddAttribute(AXIS_ATTRIBUTE, 2, GL_SHORT, offsetof(Instance, m_axis), GL_TRUE);
+	buffer.AddAttribute(SPIN_ATTRIBUTE, 2, GL_HALF_FLOAT, offsetof(Instance, m_spin));
+}
+
+// -------------------
+// Descripción: Función que calcula en la CPU la misma matriz que InstancingVert.vs construye para un asteroide en el
+// instante 'time' (para colisiones, depuración o pruebas)
+// -------------------
+glm::mat4 AsteroidBelt::GetTransform(const Instance& instance, float time)
+{
+	float spin = glm::unpackHalf1x16(instance.m_spin[1]) + glm::unpackHalf1x16(instance.m_spin[0]) * time;
+	return glm::translate(instance.m_position) * glm::scale(glm::vec3(instance.m_scale)) * glm::rotate(spin, DecodeAxis(instance.m_axis));
+}
+
+// -------------------
+// Descripción: Función que proyecta un vector unitario sobre un octaedro y lo despliega en el cuadrado [-1, 1]^2, de modo
+// que dos snorm16 bastan para guardar la dirección (error angular de unas centésimas de grado)
+// -------------------
+void AsteroidBelt::EncodeAxis(const glm::vec3& axis, int16_t encoded[2])
+{
+	glm::vec3 n = axis / (std::abs(axis.x) + std::abs(axis.y) + std::abs(axis.z));
+	glm::vec2 e(n.x, n.y);
+
+	if (n.z < 0.0f)
+	{
+		e.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+		e.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+	}
+
+	encoded[0] = (int16_t)glm::round(glm::clamp(e.x, -1.0f, 1.0f) * 32767.0f);
+	encoded[1] = (int16_t)glm::round(glm::clamp(e.y, -1.0f, 1.0f) * 32767.0f);
+}
+
+glm::vec3 AsteroidBelt::DecodeAxis(const int16_t encoded[2])
+{
+	glm::vec2 e(glm::max(encoded[0] / 32767.0f, -1.0f), glm::max(encoded[1] / 32767.0f, -1.0f));
+	glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+	float t = glm::max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -t : t;
+	n.y += n.y >= 0.0f ? -t : t;
+	return glm::normalize(n);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef __ASTEROIDBELT_H__
+#define __ASTEROIDBELT_H__
+
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "FrustumCuller.h"
+#include "GpuCuller.h"
+#include "InstanceBuffer.h"
+#include <cstdint>
+#include "Model.h"
+#include "RenderQueue.h"
+
+// Cinturón de asteroides: un anillo de instancias de un mismo Model. Cuántos hay y dónde están sale de Settings
+// (los valores por defecto reproducen el cinturón original) y de la semilla de la partida (Random::STREAM_ASTEROIDS).
+// Cada asteroide ocupa 24 bytes en lugar de una mat4 (64): InstancingVert.vs reconstruye la matriz y hace girar la roca
+// con el tiempo del CameraBlock, así que el búfer se sube una sola vez y el cinturón se anima sin tocar la CPU.
+class AsteroidBelt
+{
+public:
+	// Sin recorte se dibuja el búfer estático entero; en la CPU o en la GPU se dibuja el búfer compacto de las visibles
+	enum CullMode { CULL_NONE, CULL_CPU, CULL_GPU };
+
+	// Posiciones de los atributos de instancia en InstancingVert.vs
+	enum { POSITION_SCALE_ATTRIBUTE = 3, AXIS_ATTRIBUTE = 4, SPIN_ATTRIBUTE = 5 };
+
+	struct Instance
+	{
+		glm::vec3 m_position;
+		float m_scale;				// escala uniforme
+		int16_t m_axis[2];			// eje de giro en codificación octaédrica (snorm16)
+		uint16_t m_spin[2];			// velocidad angular (rad/s) y fase inicial (rad), en half float
+	};
+
+	struct Settings
+	{
+		Settings();
+
+		unsigned int m_count;
+		glm::vec3 m_center;
+		float m_radius;
+		glm::vec3 m_spread;			// desplazamiento aleatorio máximo alrededor del anillo en cada eje
+		float m_minScale, m_maxScale;
+		glm::vec3 m_rotationAxis;
+		float m_axisJitter;			// cuánto se desvía al azar el eje de cada asteroide de m_rotationAxis
+		float m_minSpeed, m_maxSpeed;	// velocidad angular en radianes por segundo
+	};
+
+	AsteroidBelt();
+	~AsteroidBelt();
+
+	void Init(Model& asteroid, const Settings& settings = Settings());
+	void Generate();
+	void SetCullMode(CullMode mode);
+	void Cull(FrustumCuller& culler, const OcclusionCuller* occlusion = nullptr);
+	void Cull(GpuCuller& culler);
+	void Draw(Camera& cam);
+	void Submit(RenderQueue& queue);
+
+	Settings& GetSettings() { return m_settings; }
+	InstanceBuffer& GetInstances() { return m_instances; }
+	CullMode GetCullMode() { return m_cullMode; }
+	const Instance& GetInstance(unsigned int index) { return *(const Instance*)m_instances.GetInstance(index); }
+	static glm::mat4 GetTransform(const Instance& instance, float time);
+
+private:
+	Model* m_model;
+	Settings m_settings;
+	InstanceBuffer m_instances;
+
+	// Con recorte activo el modelo dibuja desde m_visibleInstances, que se rellena cada cuadro con las visibles
+	// (desde la CPU con m_cullSet o en la GPU con m_gpuCullSet y dibujo indirecto)
+	InstanceBuffer m_visibleInstances;
+	CullInstanceSet m_cullSet;
+	GpuCullSet m_gpuCullSet;
+	CullMode m_cullMode;
+
+	// Private functions
+	static void InitLayout(InstanceBuffer& buffer, unsigned int capacity, GLenum usage);
+	static void EncodeAxis(const glm::vec3& axis, int16_t encoded[2]);
+	static glm::vec3 DecodeAxis(const int16_t encoded[2]);
+};
+
+#endif // !__ASTEROIDBELT_H__
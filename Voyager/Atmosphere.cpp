@@ -1,5 +1,5 @@
 #include "Atmosphere.h"
-#include "Utils.h"
+#include "Random.h"
 #include "Renderer.h"
 #include "Audio.h"
 
@@ -8,7 +8,8 @@ Atmosphere::Atmosphere() :
 	m_flashTimer(0.0f),
 	m_thunderFlash(false),
 	m_flashDuration(0),
-	m_nightMode(false)
+	m_nightMode(false),
+	m_random(Random::GetInstance().GetStream(Random::STREAM_ATMOSPHERE, 0))
 {}
 
 Atmosphere::~Atmosphere()
@@ -70,17 +71,20 @@ void Atmosphere::Restart()
 	m_flashDuration = 0;
 	m_nightMode = false;
 	m_activateThunderstorms = false;
+
+	// Volver a empezar la secuencia de tormentas (la semilla puede haber cambiado para una repeticin)
+	m_random = Random::GetInstance().GetStream(Random::STREAM_ATMOSPHERE, 0);
 }
 
 void Atmosphere::Thunderstorm()
 {
-	int m_dryThunderChance = Utils::GetInstance().RandomNumBetween1And100();
+	int m_dryThunderChance = m_random.RangeInt(1, 100);
 
 	// Compruebe la probabilidad de trueno (70% de probabilidad)
 	if (m_dryThunderChance >= 30)
 	{
 		// Genere una duracin para destellos de tormenta y reproduzca sonido de tormenta
-		m_flashDuration = Utils::GetInstance().RandomNumBetweenTwo(1, 7);
+		m_flashDuration = m_random.RangeInt(1, 7);
 		m_playThunderstorm = true;
 		Audio::GetInstance().PlaySound(Audio::GetInstance().GetSoundsMap().find("ThunderStorm")->second);
 	}
@@ -2,6 +2,8 @@
 #ifndef __ATMOSPHERE_H__
 #define __ATMOSPHERE_H__
 
+#include "Random.h"
+
 class Atmosphere
 {
 public:
@@ -27,6 +29,7 @@ private:
 	int m_flashDuration;
 	float m_flashTimer;
 	float m_dayTimer;
+	RandomStream m_random;
 
 	// Private functions
 	void Thunderstorm();
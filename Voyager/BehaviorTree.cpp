@@ -0,0 +1,214 @@
+#include "BehaviorTree.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+BehaviorTree::BehaviorTree()
+{}
+
+BehaviorTree::~BehaviorTree()
+{}
+
+// -------------------
+// Descripción: Función que registra una hoja (condición o acción) con el nombre que usan los archivos de árbol
+// -------------------
+void BehaviorTree::RegisterLeaf(const std::string& name, BehaviorLeaf leaf)
+{
+	m_leafNames[name] = (uint16_t)m_leaves.size();
+	m_leaves.push_back(leaf);
+}
+
+bool BehaviorTree::LoadFromFile(const char* path)
+{
+	std::ifstream file(path);
+
+	if (!file.is_open())
+	{
+		printf("ERROR: Unable to open behavior tree file: %s\n", path);
+		return false;
+	}
+
+	std::stringstream source;
+	source << file.rdbuf();
+
+	if (!LoadFromString(source.str()))
+	{
+		printf("ERROR: Unable to compile behavior tree file: %s\n", path);
+		return false;
+	}
+
+	return true;
+}
+
+// -------------------
+// Descripción: Función que compila la descripción de texto al arreglo plano de nodos.
+// Las líneas ya vienen en preorden; una pila de ancestros cierra los subárboles cuando baja la sangría.
+// -------------------
+bool BehaviorTree::LoadFromString(const std::string& source)
+{
+	std::vector<Node> nodes;
+	std::vector<std::pair<int, unsigned int> > ancestors;
+	std::istringstream lines(source);
+	std::string line;
+	int lineNumber = 0;
+
+	while (std::getline(lines, line))
+	{
+		++lineNumber;
+
+		// La sangría cuenta tabulaciones o pares de espacios
+		int depth = 0;
+		size_t column = 0;
+
+		while (column < line.size())
+		{
+			if (line[column] == '\t')
+			{
+				++depth;
+				++column;
+			}
+			else if (line.compare(column, 2, "  ") == 0)
+			{
+				++depth;
+				column += 2;
+			}
+			else if (line[column] == ' ')
+				++column;
+			else
+				break;
+		}
+
+		std::istringstream words(line.substr(column));
+		std::string type, name;
+		words >> type >> name;
+
+		if (type.empty() || type[0] == '#')
+			continue;
+
+		Node node;
+		node.m_leaf = 0;
+		node.m_end = 0;
+
+		if (type == "sequence")
+			node.m_type = NODE_SEQUENCE;
+		else if (type == "selector")
+			node.m_type = NODE_SELECTOR;
+		else if (type == "parallel")
+			node.m_type = NODE_PARALLEL;
+		else if (type == "inverter")
+			node.m_type = NODE_INVERTER;
+		else if (type == "condition" || type == "action")
+		{
+			auto leaf = m_leafNames.find(name);
+
+			if (leaf == m_leafNames.end())
+			{
+				printf("ERROR: Behavior tree line %d: unknown leaf '%s'.\n", lineNumber, name.c_str());
+				return false;
+			}
+
+			node.m_type = NODE_LEAF;
+			node.m_leaf = leaf->second;
+		}
+		else
+		{
+			printf("ERROR: Behavior tree line %d: unknown node type '%s'.\n", lineNumber, type.c_str());
+			return false;
+		}
+
+		if (nodes.empty() ? depth != 0 : (ancestors.empty() || depth > ancestors.back().first + 1 || depth == 0))
+		{
+			printf("ERROR: Behavior tree line %d: bad indentation.\n", lineNumber);
+			return false;
+		}
+
+		// Cerrar los subárboles de los nodos que no son ancestros de este
+		while (!ancestors.empty() && ancestors.back().first >= depth)
+		{
+			nodes[ancestors.back().second].m_end = (uint16_t)nodes.size();
+			ancestors.pop_back();
+		}
+
+		if (!ancestors.empty() && nodes[ancestors.back().second].m_type == NODE_LEAF)
+		{
+			printf("ERROR: Behavior tree line %d: leaves cannot have children.\n", lineNumber);
+			return false;
+		}
+
+		ancestors.push_back(std::make_pair(depth, (unsigned int)nodes.size()));
+		nodes.push_back(node);
+	}
+
+	while (!ancestors.empty())
+	{
+		nodes[ancestors.back().second].m_end = (uint16_t)nodes.size();
+		ancestors.pop_back();
+	}
+
+	if (nodes.empty())
+		return false;
+
+	// Los nodos compuestos necesitan al menos un hijo
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+	{
+		if (nodes[i].m_type != NODE_LEAF && nodes[i].m_end == i + 1)
+		{
+			printf("ERROR: Behavior tree node %u has no children.\n", i);
+			return false;
+		}
+	}
+
+	m_nodes = nodes;
+	return true;
+}
+
+// -------------------
+// Descripción: Función que evalúa el árbol para un lote de agentes que lo comparten.
+// Todos recorren el mismo arreglo de nodos, que se mantiene en caché durante todo el lote.
+// -------------------
+void BehaviorTree::TickBatch(void* owner, const unsigned int* agents, const float* deltaTimes, unsigned int count)
+{
+	if (m_nodes.empty())
+		return;
+
+	for (unsigned int k = 0; k < count; ++k)
+		Tick(0, owner, agents[k], deltaTimes[k]);
+}
+
+BehaviorStatus BehaviorTree::Tick(unsigned int node, void* owner, unsigned int agent, float dt)
+{
+	const Node& current = m_nodes[node];
+
+	switch (current.m_type)
+	{
+	case NODE_LEAF:
+		return m_leaves[current.m_leaf](owner, agent, dt);
+
+	case NODE_INVERTER:
+		return Tick(node + 1, owner, agent, dt) == BT_SUCCESS ? BT_FAILURE : BT_SUCCESS;
+
+	case NODE_SEQUENCE:
+		for (unsigned int child = node + 1; child < current.m_end; child = m_nodes[child].m_end)
+		{
+			if (Tick(child, owner, agent, dt) == BT_FAILURE)
+				return BT_FAILURE;
+		}
+
+		return BT_SUCCESS;
+
+	case NODE_SELECTOR:
+		for (unsigned int child = node + 1; child < current.m_end; child = m_nodes[child].m_end)
+		{
+			if (Tick(child, owner, agent, dt) == BT_SUCCESS)
+				return BT_SUCCESS;
+		}
+
+		return BT_FAILURE;
+
+	default:
+		for (unsigned int child = node + 1; child < current.m_end; child = m_nodes[child].m_end)
+			Tick(child, owner, agent, dt);
+
+		return BT_SUCCESS;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef __BEHAVIORTREE_H__
+#define __BEHAVIORTREE_H__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+enum BehaviorStatus { BT_FAILURE, BT_SUCCESS };
+
+// Hoja del árbol: recibe al dueño de los datos (sus arreglos SoA hacen de pizarra), el índice del agente y su dt
+typedef BehaviorStatus(*BehaviorLeaf)(void* owner, unsigned int agent, float dt);
+
+// Árbol de comportamiento compilado en un arreglo plano de nodos en preorden. El primer hijo de un nodo es el
+// siguiente en el arreglo y cada nodo guarda dónde termina su subárbol, así se recorre sin punteros.
+// Los árboles se describen en archivos de texto (un nodo por línea, la sangría indica la profundidad):
+//
+//   selector
+//     sequence
+//       condition IsDead
+//       action Respawn
+//     parallel
+//       action Navigate
+//
+// 'sequence' falla en el primer hijo que falla, 'selector' acierta en el primero que acierta, 'parallel' ejecuta
+// todos los hijos y siempre acierta, 'inverter' invierte a su único hijo.
+class BehaviorTree
+{
+public:
+	BehaviorTree();
+	~BehaviorTree();
+
+	void RegisterLeaf(const std::string& name, BehaviorLeaf leaf);
+	bool LoadFromFile(const char* path);
+	bool LoadFromString(const std::string& source);
+
+	void TickBatch(void* owner, const unsigned int* agents, const float* deltaTimes, unsigned int count);
+
+	bool IsLoaded() { return !m_nodes.empty(); }
+	unsigned int GetNodeCount() { return (unsigned int)m_nodes.size(); }
+
+private:
+	enum NodeType { NODE_SEQUENCE, NODE_SELECTOR, NODE_PARALLEL, NODE_INVERTER, NODE_LEAF };
+
+	struct Node
+	{
+		uint8_t m_type;
+		uint16_t m_leaf;
+		uint16_t m_end;
+	};
+
+	std::vector<Node> m_nodes;
+	std::vector<BehaviorLeaf> m_leaves;
+	std::map<std::string, uint16_t> m_leafNames;
+
+	// Private functions
+	BehaviorStatus Tick(unsigned int node, void* owner, unsigned int agent, float dt);
+};
+
+#endif // !__BEHAVIORTREE_H__
@@ -0,0 +1,249 @@
+#include "CharacterController.h"
+#include <algorithm>
+#include <cmath>
+
+CharacterController::CharacterController() :
+	m_radius(1.0f),
+	m_height(5.0f),
+	m_stepHeight(0.5f),
+	m_minGroundNormalY(0.7f),
+	m_skin(0.02f),
+	m_grounded(false),
+	m_groundNormal(0.0f, 1.0f, 0.0f)
+{}
+
+CharacterController::~CharacterController()
+{}
+
+void CharacterController::Init(float radius, float height, float stepHeight, float maxSlopeDegrees)
+{
+	m_radius = radius;
+	m_height = std::max(height, radius * 2.0f);
+	m_stepHeight = stepHeight;
+	m_minGroundNormalY = std::cos(glm::radians(maxSlopeDegrees));
+}
+
+// -------------------
+// Descripción: Función que mueve la cápsula desde 'position' (pies) con el desplazamiento pedido y devuelve la posición final.
+// Orden: subir el escalón, deslizar en horizontal, bajar (gravedad + escalón) y pegarse al suelo si se estaba apoyado.
+// -------------------
+glm::vec3 CharacterController::Move(Terrain& terrain, const glm::vec3& position, const glm::vec3& displacement)
+{
+	glm::vec3 pos = position;
+	glm::vec3 horizontal(displacement.x, 0.0f, displacement.z);
+	bool wasGrounded = m_grounded;
+	SweepHit hit;
+
+	// Si se empezó bajo el terreno (reaparición, teletransporte) se saca hacia arriba
+	float ground = terrain.GetHeightOfTerrain(pos.x, pos.z);
+
+	if (pos.y < ground)
+		pos.y = ground;
+
+	// Subir el escalón antes de avanzar, limitado por el techo
+	float stepUp = 0.0f;
+
+	if (wasGrounded && glm::dot(horizontal, horizontal) > 0.0f)
+	{
+		stepUp = m_stepHeight;
+
+		if (SweepCapsule(terrain, pos, glm::vec3(0.0f, stepUp, 0.0f), hit))
+			stepUp *= hit.m_t;
+
+		pos.y += stepUp;
+	}
+
+	pos = SlideMove(terrain, pos, horizontal, true);
+
+	// Bajar lo subido más el movimiento vertical; al estar apoyado se baja un escalón más para seguir las bajadas
+	float vertical = displacement.y - stepUp;
+	float snap = (wasGrounded && displacement.y <= 0.0f) ? m_stepHeight : 0.0f;
+	glm::vec3 down(0.0f, vertical - snap, 0.0f);
+
+	m_grounded = false;
+
+	if (down.y < 0.0f && SweepCapsule(terrain, pos, down, hit))
+	{
+		if (hit.m_normal.y >= m_minGroundNormalY)
+		{
+			pos += down * hit.m_t;
+			m_grounded = true;
+			m_groundNormal = hit.m_normal;
+		}
+		else
+		{
+			// Pendiente demasiado empinada: resbalar por ella
+			pos = SlideMove(terrain, pos, glm::vec3(0.0f, std::min(vertical, 0.0f), 0.0f), false);
+		}
+	}
+	else if (down.y < 0.0f)
+	{
+		pos.y += vertical;
+	}
+	else if (vertical > 0.0f)
+	{
+		pos = SlideMove(terrain, pos, glm::vec3(0.0f, vertical, 0.0f), false);
+	}
+
+	return pos;
+}
+
+// -------------------
+// Descripción: Función que avanza la cápsula deslizándose por las superficies que toca (como mucho MAX_SLIDE_ITERATIONS barridos).
+// Con 'walkableOnly' las superficies más empinadas que el límite se tratan como paredes verticales.
+// -------------------
+glm::vec3 CharacterController::SlideMove(Terrain& terrain, const glm::vec3& position, const glm::vec3& displacement, bool walkableOnly)
+{
+	glm::vec3 pos = position;
+	glm::vec3 remaining = displacement;
+	SweepHit hit;
+
+	for (int i = 0; i < MAX_SLIDE_ITERATIONS; ++i)
+	{
+		if (glm::dot(remaining, remaining) < 1e-10f)
+			break;
+
+		if (!SweepCapsule(terrain, pos, remaining, hit))
+		{
+			pos += remaining;
+			break;
+		}
+
+		pos += remaining * hit.m_t;
+
+		glm::vec3 normal = hit.m_normal;
+
+		if (walkableOnly && normal.y < m_minGroundNormalY)
+		{
+			normal.y = 0.0f;
+			float length = glm::length(normal);
+			normal = length > 0.0f ? normal / length : -glm::normalize(remaining);
+		}
+
+		// Quitar la parte del movimiento que va contra la superficie
+		remaining *= 1.0f - hit.m_t;
+		remaining -= normal * glm::dot(remaining, normal);
+	}
+
+	return pos;
+}
+
+// -------------------
+// Descripción: Función que barre la cápsula como dos esferas (pies y cabeza) contra las mallas estáticas y la de los pies
+// contra el terreno. Devuelve el primer contacto, retrasado un poco para no quedar pegado a la superficie.
+// -------------------
+bool CharacterController::SweepCapsule(Terrain& terrain, const glm::vec3& position, const glm::vec3& displacement, SweepHit& hit)
+{
+	glm::vec3 spheres[2] = { position + glm::vec3(0.0f, m_radius, 0.0f), position + glm::vec3(0.0f, m_height - m_radius, 0.0f) };
+
+	float length = glm::length(displacement);
+	bool found = false;
+	hit.m_t = 1.0f;
+
+	if (length <= 0.0f)
+		return false;
+
+	SweepHit candidate;
+
+	if (SweepTerrain(terrain, spheres[0], spheres[0] + displacement, candidate) && candidate.m_t <= hit.m_t)
+	{
+		hit = candidate;
+		found = true;
+	}
+
+	for (auto iter = m_staticMeshes.begin(); iter != m_staticMeshes.end(); ++iter)
+	{
+		for (int s = 0; s < 2; ++s)
+		{
+			float t;
+			glm::vec3 normal;
+
+			if ((*iter)->SweepSphere(spheres[s], spheres[s] + displacement, m_radius, t, normal) && t <= hit.m_t && glm::dot(normal, displacement) < 0.0f)
+			{
+				hit.m_t = t;
+				hit.m_normal = normal;
+				found = true;
+			}
+		}
+	}
+
+	if (found)
+		hit.m_t = std::max(0.0f, hit.m_t - m_skin / length);
+
+	return found;
+}
+
+// -------------------
+// Descripción: Función que recorre el camino de la esfera sobre el mapa de alturas (como mucho MAX_TERRAIN_SAMPLES muestras,
+// separadas a lo sumo media celda) y afina el contacto por bisección
+// -------------------
+bool CharacterController::SweepTerrain(Terrain& terrain, const glm::vec3& start, const glm::vec3& end, SweepHit& hit)
+{
+	const float sampleSpacing = 1.5f;
+
+	glm::vec3 segment = end - start;
+
+	// Empezar hundido solo cuenta como contacto si el movimiento se mete más en el terreno
+	if (start.y - m_radius < terrain.GetHeightOfTerrain(start.x, start.z))
+	{
+		hit.m_normal = GetTerrainNormal(terrain, start.x, start.z);
+		hit.m_t = 0.0f;
+		return glm::dot(segment, hit.m_normal) < 0.0f;
+	}
+
+	float horizontal = glm::length(glm::vec2(segment.x, segment.z));
+	int samples = std::min((int)MAX_TERRAIN_SAMPLES, std::max(1, (int)std::ceil(horizontal / sampleSpacing)));
+	float previous = 0.0f;
+
+	for (int i = 1; i <= samples; ++i)
+	{
+		float current = (float)i / samples;
+		glm::vec3 pos = start + segment * current;
+
+		if (pos.y - m_radius >= terrain.GetHeightOfTerrain(pos.x, pos.z))
+		{
+			previous = current;
+			continue;
+		}
+
+		float low = previous, high = current;
+
+		for (int j = 0; j < TERRAIN_REFINE_STEPS; ++j)
+		{
+			float middle = 0.5f * (low + high);
+			glm::vec3 probe = start + segment * middle;
+
+			if (probe.y - m_radius < terrain.GetHeightOfTerrain(probe.x, probe.z))
+				high = middle;
+			else
+				low = middle;
+		}
+
+		glm::vec3 contact = start + segment * low;
+		hit.m_t = low;
+		hit.m_normal = GetTerrainNormal(terrain, contact.x, contact.z);
+		return true;
+	}
+
+	return false;
+}
+
+// -------------------
+// Descripción: Función que calcula la normal del terreno con diferencias a un solo lado, quedándose por eje con la más suave.
+// Así, al pie de un acantilado, la pared de al lado no hace que el suelo plano parezca una pendiente empinada.
+// -------------------
+glm::vec3 CharacterController::GetTerrainNormal(Terrain& terrain, float x, float z)
+{
+	const float offset = 0.5f;
+
+	float center = terrain.GetHeightOfTerrain(x, z);
+	float left = center - terrain.GetHeightOfTerrain(x - offset, z);
+	float right = terrain.GetHeightOfTerrain(x + offset, z) - center;
+	float back = center - terrain.GetHeightOfTerrain(x, z - offset);
+	float front = terrain.GetHeightOfTerrain(x, z + offset) - center;
+
+	float slopeX = std::fabs(left) < std::fabs(right) ? left : right;
+	float slopeZ = std::fabs(back) < std::fabs(front) ? back : front;
+
+	return glm::normalize(glm::vec3(-slopeX, offset, -slopeZ));
+}
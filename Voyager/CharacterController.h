@@ -0,0 +1,50 @@
+#pragma once
+#ifndef __CHARACTERCONTROLLER_H__
+#define __CHARACTERCONTROLLER_H__
+
+#include "Terrain.h"
+#include "Model.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <vector>
+
+// Controlador de personaje con cápsula: barre la cápsula contra el terreno y las mallas estáticas (rocas, asta),
+// se desliza por las superficies, no sube pendientes demasiado empinadas, sube escalones pequeños y detecta el suelo.
+// La posición es la de los pies. Se hace un número fijo de iteraciones para que el costo por cuadro sea predecible.
+class CharacterController
+{
+public:
+	CharacterController();
+	~CharacterController();
+
+	void Init(float radius, float height, float stepHeight, float maxSlopeDegrees);
+	glm::vec3 Move(Terrain& terrain, const glm::vec3& position, const glm::vec3& displacement);
+
+	void AddStaticMesh(Model* model) { m_staticMeshes.push_back(model); }
+	void ClearStaticMeshes() { m_staticMeshes.clear(); }
+
+	bool IsGrounded() { return m_grounded; }
+	glm::vec3& GetGroundNormal() { return m_groundNormal; }
+	float GetHeight() { return m_height; }
+
+private:
+	enum { MAX_SLIDE_ITERATIONS = 4, MAX_TERRAIN_SAMPLES = 16, TERRAIN_REFINE_STEPS = 5 };
+
+	struct SweepHit
+	{
+		float m_t;
+		glm::vec3 m_normal;
+	};
+
+	std::vector<Model*> m_staticMeshes;
+	float m_radius, m_height, m_stepHeight, m_minGroundNormalY, m_skin;
+	bool m_grounded;
+	glm::vec3 m_groundNormal;
+
+	// Private functions
+	glm::vec3 SlideMove(Terrain& terrain, const glm::vec3& position, const glm::vec3& displacement, bool walkableOnly);
+	bool SweepCapsule(Terrain& terrain, const glm::vec3& position, const glm::vec3& displacement, SweepHit& hit);
+	bool SweepTerrain(Terrain& terrain, const glm::vec3& start, const glm::vec3& end, SweepHit& hit);
+	glm::vec3 GetTerrainNormal(Terrain& terrain, float x, float z);
+};
+
+#endif // !__CHARACTERCONTROLLER_H__
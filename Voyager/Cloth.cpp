@@ -1,9 +1,15 @@
 #include "Cloth.h"
+#include "GLState.h"
 #include "Dependencies/glew/include/GL/glew.h"
 #include "Dependencies/glm-0.9.9-a2/glm/gtc/type_ptr.hpp"
 
 Cloth::Cloth() :
-	m_position(1.0f)
+	m_position(1.0f),
+	m_vao(0),
+	m_vbo(0),
+	m_elementSize(0),
+	m_referenceStep(1.0f / 60.0f),
+	m_referenceTimeStepSquared(0.25f)
 {}
 
 Cloth::~Cloth()
@@ -96,6 +102,39 @@ void Cloth::Draw(Camera& cam)
 	m_shader.ActivateProgram();
 	m_textureComponent.ActivateTexture();
 
+	UpdateMesh();
+
+	// La vista y la proyección llegan por CameraBlock (SceneUniforms)
+	m_shader.SetMat4("model", glm::translate(m_position));
+
+	GLState::GetInstance().BindVertexArray(m_vao);
+	GLState::GetInstance().DrawElements(GL_TRIANGLE_STRIP, m_elementSize);
+}
+
+// -------------------
+// Descripción: función que actualiza la malla de la tela y la envía a la cola de dibujo (ver RenderQueue)
+// -------------------
+void Cloth::Submit(RenderQueue& queue)
+{
+	UpdateMesh();
+
+	DrawPacket packet;
+	packet.m_shader = &m_shader;
+	packet.m_vao = m_vao;
+	packet.m_mode = GL_TRIANGLE_STRIP;
+	packet.m_count = m_elementSize;
+	packet.m_model = glm::translate(m_position);
+	packet.m_textures[0] = m_textureComponent.GetTexture();
+	packet.m_totalTextures = 1;
+
+	queue.Submit(RenderQueue::PASS_OPAQUE, packet);
+}
+
+// -------------------
+// Descripción: función que recalcula las normales y sube los vértices de la tela (crea el VAO la primera vez)
+// -------------------
+void Cloth::UpdateMesh()
+{
 	// Restablecer normales
 	for (auto p = m_particles.begin(); p != m_particles.end(); ++p)
 		(*p).ZeroNormal();
@@ -116,18 +155,13 @@ void Cloth::Draw(Camera& cam)
 		}
 	}
 
-	static GLuint vertexArrayObject = 0;
-	static GLuint vertexBuffer = 0;
-	static GLuint texture;
-	static int elementSize;
-
-	if (vertexArrayObject == 0)
+	if (m_vao == 0)
 	{
-		glGenVertexArrays(1, &vertexArrayObject);
-		glBindVertexArray(vertexArrayObject);
+		glGenVertexArrays(1, &m_vao);
+		GLState::GetInstance().BindVertexArray(m_vao);
 
-		glGenBuffers(1, &vertexBuffer);
-		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glGenBuffers(1, &m_vbo);
+		GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
 		GLuint positionAttributeLocation = glGetAttribLocation(m_shader.GetShaderProgram(), "position");
 		GLuint uvAttributeLocation = glGetAttribLocation(m_shader.GetShaderProgram(), "uv");
@@ -159,12 +193,13 @@ void Cloth::Draw(Camera& cam)
 				indices.push_back(index + m_numParticlesWidth);
 		}
 
-		elementSize = indices.size();
+		m_elementSize = (GLsizei)indices.size();
 
 		GLuint elementArrayBuffer;
 		glGenBuffers(1, &elementArrayBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementArrayBuffer);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, elementSize * sizeof(int), &(indices[0]), GL_STATIC_DRAW);
+		GLState::GetInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementArrayBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_elementSize * sizeof(int), &(indices[0]), GL_STATIC_DRAW);
+		GLState::GetInstance().BindVertexArray(0);
 	}
 
 	std::vector<Vert> vertexData;
@@ -178,27 +213,19 @@ void Cloth::Draw(Camera& cam)
 		}
 	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
 	glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(Vert), glm::value_ptr(vertexData[0].m_pos), GL_STREAM_DRAW);
-
-	glm::mat4 view = cam.GetViewMatrix();
-	glm::mat4 model = glm::translate(m_position);
-	glm::mat4 mvp = cam.GetProjectionMatrix() * view * model;
-	glUniformMatrix4fv(glGetUniformLocation(m_shader.GetShaderProgram(), "mvp"), 1, false, glm::value_ptr(mvp));
-	glUniformMatrix4fv(glGetUniformLocation(m_shader.GetShaderProgram(), "view"), 1, false, glm::value_ptr(view));
-
-	glBindVertexArray(vertexArrayObject);
-	glDrawElements(GL_TRIANGLE_STRIP, elementSize, GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
-
-	m_shader.DeactivateProgram();
 }
 
 // -------------------
 // Descripci�n: Funci�n que actualiza las part�culas de un pa�o cada cuadro
 // -------------------
-void Cloth::Update()
+void Cloth::Update(float dt)
 {
+	// Las fuerzas se ajustaron con 0.25 por paso a 60 pasos por segundo; se escala para que el paño no dependa del paso
+	float scale = dt / m_referenceStep;
+	float timeStepSquared = m_referenceTimeStepSquared * scale * scale;
+
 	for (unsigned int i = 0; i < 3; ++i)
 	{
 		for (auto iter = m_constraints.begin(); iter != m_constraints.end(); ++iter)
@@ -207,7 +234,7 @@ void Cloth::Update()
 
 	// Calcular la posici�n de cada part�cula.
 	for (auto p = m_particles.begin(); p != m_particles.end(); ++p)
-		(*p).VerletIntegration();
+		(*p).VerletIntegration(timeStepSquared);
 }
 
 // -------------------
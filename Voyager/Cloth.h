@@ -8,6 +8,7 @@
 #include "Shader.h"
 #include "Camera.h"
 #include "Texture.h"
+#include "RenderQueue.h"
 
 class Cloth
 {
@@ -17,7 +18,8 @@ public:
 
 	void Configure(float w, float h, int totalParticlesW, int totalParticlesH);
 	void Draw(Camera& cam);
-	void Update();
+	void Submit(RenderQueue& queue);
+	void Update(float dt);
 	void AddForce(glm::vec3 dir);
 	void WindForce(glm::vec3 dir);
 
@@ -40,8 +42,12 @@ private:
 	GLuint shaderId;
 	Texture m_textureComponent;
 	glm::vec3 m_position;
+	GLuint m_vao, m_vbo;
+	GLsizei m_elementSize;
+	float m_referenceStep, m_referenceTimeStepSquared;
 
 	// Private functions
+	void UpdateMesh();
 	int GetParticleIndex(int x, int y) { return y * m_numParticlesWidth + x; }
 	ClothParticle* GetParticle(int x, int y) { return &m_particles[GetParticleIndex(x, y)]; }
 	void CreateConstraint(ClothParticle* p1, ClothParticle* p2) { m_constraints.push_back(Constraint(p1, p2)); }
@@ -10,19 +10,18 @@ ClothParticle::ClothParticle(glm::vec3 pos) :
 	m_acceleration(glm::vec3(0.0f)),
 	m_movable(true),
 	m_accumulatedNormal(glm::vec3(0.0f)),
-	m_damping(0.1f),
-	m_timeStep(0.25f)
+	m_damping(0.1f)
 {}
 
 ClothParticle::~ClothParticle()
 {}
 
-void ClothParticle::VerletIntegration()
+void ClothParticle::VerletIntegration(float timeStepSquared)
 {
 	if (m_movable)
 	{
 		glm::vec3 temp = m_pos;
-		m_pos = m_pos + (m_pos - m_oldPos) * (1.0f - m_damping) + m_acceleration * m_timeStep;
+		m_pos = m_pos + (m_pos - m_oldPos) * (1.0f - m_damping) + m_acceleration * timeStepSquared;
 		m_oldPos = temp;
 		m_acceleration = glm::vec3(0.0f, 0.0f, 0.0f);
 	}
@@ -13,7 +13,7 @@ public:
 	ClothParticle(glm::vec3 pos);
 	~ClothParticle();
 
-	void VerletIntegration();
+	void VerletIntegration(float timeStepSquared);
 	void AddForce(glm::vec3 force) { m_acceleration += force / m_mass; }
 	glm::vec3& GetPos() { return m_pos; }
 	glm::vec3& GetNormal() { return m_accumulatedNormal; }
@@ -24,7 +24,7 @@ public:
 	void Pin() { m_movable = false; }
 
 private:
-	float m_damping, m_timeStep;
+	float m_damping;
 	bool m_movable;
 	float m_mass;
 	glm::vec3 m_pos, m_oldPos, m_acceleration, m_accumulatedNormal;
@@ -0,0 +1,399 @@
+#include "CollisionWorld.h"
+#include "EnemyManager.h"
+#include "ProjectileSystem.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define COLLISION_SSE
+#include <emmintrin.h>
+#endif
+
+// -------------------
+// Descripción: Función que prueba un rayo (dirección normalizada) contra cuatro esferas a la vez.
+// Escribe en 't' la distancia de entrada de cada una o FLT_MAX si no la toca (0 si el origen está dentro).
+// -------------------
+static void RaySpheres4(const glm::vec3& origin, const glm::vec3& dir, const float* centerX, const float* centerY, const float* centerZ,
+	const float* radius, float* t)
+{
+#if defined(COLLISION_SSE)
+	__m128 mx = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_loadu_ps(centerX));
+	__m128 my = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_loadu_ps(centerY));
+	__m128 mz = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_loadu_ps(centerZ));
+	__m128 r = _mm_loadu_ps(radius);
+
+	__m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, _mm_set1_ps(dir.x)), _mm_mul_ps(my, _mm_set1_ps(dir.y))), _mm_mul_ps(mz, _mm_set1_ps(dir.z)));
+	__m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my)), _mm_mul_ps(mz, mz)), _mm_mul_ps(r, r));
+	__m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), c);
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 hitTime = _mm_sub_ps(_mm_sub_ps(zero, b), _mm_sqrt_ps(_mm_max_ps(discriminant, zero)));
+
+	__m128 inside = _mm_cmple_ps(c, zero);
+	__m128 miss = _mm_or_ps(_mm_cmplt_ps(discriminant, zero), _mm_cmpgt_ps(b, zero));
+	hitTime = _mm_or_ps(_mm_and_ps(inside, zero), _mm_andnot_ps(inside, hitTime));
+	miss = _mm_andnot_ps(inside, miss);
+
+	_mm_storeu_ps(t, _mm_or_ps(_mm_and_ps(miss, _mm_set1_ps(FLT_MAX)), _mm_andnot_ps(miss, hitTime)));
+#else
+	for (int i = 0; i < 4; ++i)
+	{
+		glm::vec3 m = origin - glm::vec3(centerX[i], centerY[i], centerZ[i]);
+		float b = glm::dot(m, dir);
+		float c = glm::dot(m, m) - radius[i] * radius[i];
+		float discriminant = b * b - c;
+
+		if (c <= 0.0f)
+			t[i] = 0.0f;
+		else if (discriminant < 0.0f || b > 0.0f)
+			t[i] = FLT_MAX;
+		else
+			t[i] = -b - std::sqrt(discriminant);
+	}
+#endif
+}
+
+// -------------------
+// Descripción: Función que prueba un rayo contra cuatro cajas a la vez (método de las placas con la dirección inversa)
+// -------------------
+static void RayBoxes4(const glm::vec3& origin, const glm::vec3& invDir, const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ, float* t)
+{
+#if defined(COLLISION_SSE)
+	__m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+	__m128 ix = _mm_set1_ps(invDir.x), iy = _mm_set1_ps(invDir.y), iz = _mm_set1_ps(invDir.z);
+
+	__m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minX), ox), ix);
+	__m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxX), ox), ix);
+	__m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minY), oy), iy);
+	__m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxY), oy), iy);
+	__m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minZ), oz), iz);
+	__m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxZ), oz), iz);
+
+	__m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)), _mm_min_ps(t1z, t2z));
+	__m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)), _mm_max_ps(t1z, t2z));
+
+	tNear = _mm_max_ps(tNear, _mm_setzero_ps());
+	__m128 hit = _mm_cmpge_ps(tFar, tNear);
+
+	_mm_storeu_ps(t, _mm_or_ps(_mm_and_ps(hit, tNear), _mm_andnot_ps(hit, _mm_set1_ps(FLT_MAX))));
+#else
+	for (int i = 0; i < 4; ++i)
+	{
+		glm::vec3 t1 = (glm::vec3(minX[i], minY[i], minZ[i]) - origin) * invDir;
+		glm::vec3 t2 = (glm::vec3(maxX[i], maxY[i], maxZ[i]) - origin) * invDir;
+		glm::vec3 low = glm::min(t1, t2);
+		glm::vec3 high = glm::max(t1, t2);
+
+		float tNear = std::max(std::max(std::max(low.x, low.y), low.z), 0.0f);
+		float tFar = std::min(std::min(high.x, high.y), high.z);
+
+		t[i] = tFar >= tNear ? tNear : FLT_MAX;
+	}
+#endif
+}
+
+CollisionWorld::CollisionWorld()
+{
+	m_tree.SetMargin(0.5f);
+}
+
+CollisionWorld::~CollisionWorld()
+{}
+
+int CollisionWorld::AllocateCollider()
+{
+	if (!m_freeColliders.empty())
+	{
+		int collider = m_freeColliders.back();
+		m_freeColliders.pop_back();
+		return collider;
+	}
+
+	m_colliders.push_back(Collider());
+	return (int)m_colliders.size() - 1;
+}
+
+int CollisionWorld::AddSphere(ColliderLayer layer, unsigned int entity, const glm::vec3& center, float radius)
+{
+	int collider = AllocateCollider();
+	Collider& c = m_colliders[collider];
+
+	c.m_shape = SHAPE_SPHERE;
+	c.m_layer = (uint8_t)layer;
+	c.m_entity = entity;
+	c.m_a = center;
+	c.m_b = glm::vec3(radius, 0.0f, 0.0f);
+
+	AABB aabb;
+	aabb.m_min = center - glm::vec3(radius);
+	aabb.m_max = center + glm::vec3(radius);
+	c.m_proxy = m_tree.CreateProxy(aabb, (unsigned int)collider);
+
+	return collider;
+}
+
+int CollisionWorld::AddBox(ColliderLayer layer, unsigned int entity, const glm::vec3& min, const glm::vec3& max)
+{
+	int collider = AllocateCollider();
+	Collider& c = m_colliders[collider];
+
+	c.m_shape = SHAPE_BOX;
+	c.m_layer = (uint8_t)layer;
+	c.m_entity = entity;
+	c.m_a = min;
+	c.m_b = max;
+
+	AABB aabb;
+	aabb.m_min = min;
+	aabb.m_max = max;
+	c.m_proxy = m_tree.CreateProxy(aabb, (unsigned int)collider);
+
+	return collider;
+}
+
+void CollisionWorld::MoveSphere(int collider, const glm::vec3& center)
+{
+	Collider& c = m_colliders[collider];
+	glm::vec3 displacement = center - c.m_a;
+	c.m_a = center;
+
+	AABB aabb;
+	aabb.m_min = center - glm::vec3(c.m_b.x);
+	aabb.m_max = center + glm::vec3(c.m_b.x);
+	m_tree.MoveProxy(c.m_proxy, aabb, displacement);
+}
+
+void CollisionWorld::MoveBox(int collider, const glm::vec3& min, const glm::vec3& max)
+{
+	Collider& c = m_colliders[collider];
+	glm::vec3 displacement = min - c.m_a;
+	c.m_a = min;
+	c.m_b = max;
+
+	AABB aabb;
+	aabb.m_min = min;
+	aabb.m_max = max;
+	m_tree.MoveProxy(c.m_proxy, aabb, displacement);
+}
+
+void CollisionWorld::Remove(int collider)
+{
+	m_tree.DestroyProxy(m_colliders[collider].m_proxy);
+	m_colliders[collider].m_proxy = -1;
+	m_freeColliders.push_back(collider);
+}
+
+void CollisionWorld::Clear()
+{
+	m_tree.Clear();
+	m_colliders.clear();
+	m_freeColliders.clear();
+	m_enemyColliders.clear();
+	m_droneColliders.clear();
+}
+
+// -------------------
+// Descripción: Función que reajusta el árbol a las posiciones de este cuadro: crea, mueve o quita las esferas
+// de los enemigos vivos. Solo se reinsertan las hojas que salen de su caja gorda.
+// -------------------
+void CollisionWorld::SyncEnemies(EnemyManager& enemies)
+{
+	m_enemyColliders.resize(enemies.GetCapacity(), -1);
+
+	for (unsigned int i = 0; i < enemies.GetCapacity(); ++i)
+	{
+		bool alive = i < enemies.GetCount() && enemies.IsAlive(i);
+
+		if (alive && m_enemyColliders[i] < 0)
+			m_enemyColliders[i] = AddSphere(COLLIDER_ENEMY, i, enemies.GetPos(i), enemies.GetRadius());
+		else if (alive)
+			MoveSphere(m_enemyColliders[i], enemies.GetPos(i));
+		else if (m_enemyColliders[i] >= 0)
+		{
+			Remove(m_enemyColliders[i]);
+			m_enemyColliders[i] = -1;
+		}
+	}
+}
+
+// -------------------
+// Descripción: Función que hace lo mismo con los drones en vuelo del grupo de proyectiles (el resto de proyectiles
+// son demasiado pequeños para ser blanco de un rayo). La entidad de la esfera es el hueco del proyectil.
+// -------------------
+void CollisionWorld::SyncProjectiles(ProjectileSystem& projectiles)
+{
+	m_droneColliders.resize(projectiles.GetCapacity(), -1);
+
+	for (unsigned int i = 0; i < projectiles.GetCapacity(); ++i)
+	{
+		bool drone = projectiles.IsActive(i) && projectiles.GetType(i) == PROJECTILE_DRONE;
+
+		if (drone && m_droneColliders[i] < 0)
+			m_droneColliders[i] = AddSphere(COLLIDER_DRONE, i, projectiles.GetPos(i), projectiles.GetRadius(PROJECTILE_DRONE));
+		else if (drone)
+			MoveSphere(m_droneColliders[i], projectiles.GetPos(i));
+		else if (m_droneColliders[i] >= 0)
+		{
+			Remove(m_droneColliders[i]);
+			m_droneColliders[i] = -1;
+		}
+	}
+}
+
+// -------------------
+// Descripción: Función que lanza un lote de rayos (escopeta, francotirador, visibilidad...) y devuelve el impacto
+// más cercano de cada uno. El árbol no cambia durante la consulta, así que los rayos se reparten entre hilos.
+// -------------------
+void CollisionWorld::RaycastBatch(const Ray* rays, unsigned int count, float maxDistance, unsigned int layerMask, RaycastHit* hits)
+{
+	JobSystem::GetInstance().ParallelFor(count, RAY_BATCH_SIZE, [this, rays, maxDistance, layerMask, hits](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int i = begin; i < end; ++i)
+			CastRay(rays[i], maxDistance, layerMask, hits[i]);
+	});
+}
+
+bool CollisionWorld::Raycast(const Ray& ray, float maxDistance, unsigned int layerMask, RaycastHit& hit)
+{
+	CastRay(ray, maxDistance, layerMask, hit);
+	return hit.m_collider >= 0;
+}
+
+// -------------------
+// Descripción: Función que recorre el árbol con una pila, descartando los nodos más lejanos que el mejor impacto.
+// Las hojas se acumulan por forma y se prueban de cuatro en cuatro.
+// -------------------
+void CollisionWorld::CastRay(const Ray& ray, float maxDistance, unsigned int layerMask, RaycastHit& hit) const
+{
+	hit.m_collider = -1;
+	hit.m_layer = 0;
+	hit.m_entity = 0;
+	hit.m_distance = maxDistance;
+	hit.m_point = ray.pos;
+
+	if (m_tree.GetRoot() == DynamicAABBTree::NULL_NODE || glm::dot(ray.dir, ray.dir) <= 0.0f)
+		return;
+
+	glm::vec3 dir = glm::normalize(ray.dir);
+	glm::vec3 invDir = 1.0f / dir;
+	const DynamicAABBTree::Node* nodes = m_tree.GetNodes();
+
+	float best = maxDistance;
+	int bestCollider = -1;
+
+	// Candidatos pendientes en SoA (los carriles sobrantes de la última tanda se calculan pero se ignoran)
+	float sphereX[4] = {}, sphereY[4] = {}, sphereZ[4] = {}, sphereR[4] = {};
+	float boxMinX[4] = {}, boxMinY[4] = {}, boxMinZ[4] = {}, boxMaxX[4] = {}, boxMaxY[4] = {}, boxMaxZ[4] = {};
+	int sphereIds[4], boxIds[4];
+	int sphereCount = 0, boxCount = 0;
+	float t[4];
+
+	auto flushSpheres = [&]()
+	{
+		RaySpheres4(ray.pos, dir, sphereX, sphereY, sphereZ, sphereR, t);
+
+		for (int i = 0; i < sphereCount; ++i)
+		{
+			if (t[i] < best)
+			{
+				best = t[i];
+				bestCollider = sphereIds[i];
+			}
+		}
+
+		sphereCount = 0;
+	};
+
+	auto flushBoxes = [&]()
+	{
+		RayBoxes4(ray.pos, invDir, boxMinX, boxMinY, boxMinZ, boxMaxX, boxMaxY, boxMaxZ, t);
+
+		for (int i = 0; i < boxCount; ++i)
+		{
+			if (t[i] < best)
+			{
+				best = t[i];
+				bestCollider = boxIds[i];
+			}
+		}
+
+		boxCount = 0;
+	};
+
+	int stack[TRAVERSAL_STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = m_tree.GetRoot();
+
+	while (stackSize > 0)
+	{
+		const DynamicAABBTree::Node& node = nodes[stack[--stackSize]];
+
+		// Placas contra la caja del nodo, recortadas al mejor impacto hasta ahora
+		glm::vec3 t1 = (node.m_aabb.m_min - ray.pos) * invDir;
+		glm::vec3 t2 = (node.m_aabb.m_max - ray.pos) * invDir;
+		glm::vec3 low = glm::min(t1, t2);
+		glm::vec3 high = glm::max(t1, t2);
+		float tNear = std::max(std::max(std::max(low.x, low.y), low.z), 0.0f);
+		float tFar = std::min(std::min(std::min(high.x, high.y), high.z), best);
+
+		if (tNear > tFar)
+			continue;
+
+		if (!node.IsLeaf())
+		{
+			if (stackSize + 2 > TRAVERSAL_STACK_SIZE)
+			{
+				printf("ERROR: Collision tree traversal stack overflow.\n");
+				break;
+			}
+
+			stack[stackSize++] = node.m_child1;
+			stack[stackSize++] = node.m_child2;
+			continue;
+		}
+
+		int id = (int)node.m_userData;
+		const Collider& collider = m_colliders[id];
+
+		if (!(collider.m_layer & layerMask))
+			continue;
+
+		if (collider.m_shape == SHAPE_SPHERE)
+		{
+			sphereX[sphereCount] = collider.m_a.x; sphereY[sphereCount] = collider.m_a.y; sphereZ[sphereCount] = collider.m_a.z;
+			sphereR[sphereCount] = collider.m_b.x;
+			sphereIds[sphereCount++] = id;
+
+			if (sphereCount == 4)
+				flushSpheres();
+		}
+		else
+		{
+			boxMinX[boxCount] = collider.m_a.x; boxMinY[boxCount] = collider.m_a.y; boxMinZ[boxCount] = collider.m_a.z;
+			boxMaxX[boxCount] = collider.m_b.x; boxMaxY[boxCount] = collider.m_b.y; boxMaxZ[boxCount] = collider.m_b.z;
+			boxIds[boxCount++] = id;
+
+			if (boxCount == 4)
+				flushBoxes();
+		}
+	}
+
+	if (sphereCount > 0)
+		flushSpheres();
+
+	if (boxCount > 0)
+		flushBoxes();
+
+	if (bestCollider >= 0)
+	{
+		hit.m_collider = bestCollider;
+		hit.m_layer = m_colliders[bestCollider].m_layer;
+		hit.m_entity = m_colliders[bestCollider].m_entity;
+		hit.m_distance = best;
+		hit.m_point = ray.pos + dir * best;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#ifndef __COLLISIONWORLD_H__
+#define __COLLISIONWORLD_H__
+
+#include "DynamicAABBTree.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <cstdint>
+#include <vector>
+
+class EnemyManager;
+class ProjectileSystem;
+
+struct Ray
+{
+	glm::vec3 pos;
+	glm::vec3 dir;
+};
+
+enum ColliderLayer
+{
+	COLLIDER_ENEMY = 1 << 0,
+	COLLIDER_DRONE = 1 << 1,
+	COLLIDER_PROP = 1 << 2,
+	COLLIDER_ALL = 0xFF
+};
+
+struct RaycastHit
+{
+	int m_collider;			// -1 si el rayo no tocó nada
+	unsigned int m_layer;
+	unsigned int m_entity;	// Índice del enemigo, del proyectil dron o del objeto estático
+	float m_distance;
+	glm::vec3 m_point;
+};
+
+// Mundo de colisión para consultas: esferas (enemigos, drones) y cajas (objetos estáticos) en un árbol AABB dinámico.
+// Los rayos se lanzan en lotes repartidos entre hilos; cada rayo recorre el árbol y sus candidatos se prueban
+// de cuatro en cuatro con SSE.
+class CollisionWorld
+{
+public:
+	CollisionWorld();
+	~CollisionWorld();
+
+	int AddSphere(ColliderLayer layer, unsigned int entity, const glm::vec3& center, float radius);
+	int AddBox(ColliderLayer layer, unsigned int entity, const glm::vec3& min, const glm::vec3& max);
+	void MoveSphere(int collider, const glm::vec3& center);
+	void MoveBox(int collider, const glm::vec3& min, const glm::vec3& max);
+	void Remove(int collider);
+	void Clear();
+
+	void SyncEnemies(EnemyManager& enemies);
+	void SyncProjectiles(ProjectileSystem& projectiles);
+
+	void RaycastBatch(const Ray* rays, unsigned int count, float maxDistance, unsigned int layerMask, RaycastHit* hits);
+	bool Raycast(const Ray& ray, float maxDistance, unsigned int layerMask, RaycastHit& hit);
+
+	const DynamicAABBTree& GetTree() const { return m_tree; }
+
+private:
+	enum { SHAPE_SPHERE, SHAPE_BOX };
+	enum { RAY_BATCH_SIZE = 16, TRAVERSAL_STACK_SIZE = 128 };
+
+	struct Collider
+	{
+		uint8_t m_shape;
+		uint8_t m_layer;
+		unsigned int m_entity;
+		int m_proxy;			// -1 = libre
+		glm::vec3 m_a, m_b;		// Esfera: centro y radio en m_b.x; caja: mínimo y máximo
+	};
+
+	DynamicAABBTree m_tree;
+	std::vector<Collider> m_colliders;
+	std::vector<int> m_freeColliders;
+
+	// Colisionadores de cada enemigo y de cada hueco de proyectil con un dron (-1 si no tiene)
+	std::vector<int> m_enemyColliders, m_droneColliders;
+
+	// Private functions
+	int AllocateCollider();
+	void CastRay(const Ray& ray, float maxDistance, unsigned int layerMask, RaycastHit& hit) const;
+};
+
+#endif // !__COLLISIONWORLD_H__
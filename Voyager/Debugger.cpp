@@ -1,5 +1,6 @@
 // Nota personal: revise este archivo y optim�celo donde sea posible en el futuro si es necesario
 #include "Debugger.h"
+#include "GLState.h"
 #include <vector>
 
 Debugger::Debugger() :
@@ -17,16 +18,16 @@ void Debugger::Init(Camera& cam)
 
 	// Configurar buffers para la depuradora
 	glGenVertexArrays(1, &m_vao);
-	glBindVertexArray(m_vao);
+	GLState::GetInstance().BindVertexArray(m_vao);
 
 	glGenBuffers(1, &m_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices[0], GL_STREAM_DRAW);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::GetInstance().BindVertexArray(0);
 }
 
 void Debugger::DrawRay(glm::vec3& rayPos, glm::vec3& rayDir, Camera& cam)
@@ -40,15 +41,13 @@ void Debugger::DrawRay(glm::vec3& rayPos, glm::vec3& rayDir, Camera& cam)
 		(rayDir.x * 50.0f) + rayPos.x, (rayDir.y * 50.0f) + rayPos.y, (rayDir.z * 50.0f) + rayPos.z
 	};
 
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), &vertices[0]);
 
 	m_shader.SetMat4("view", cam.GetViewMatrix());
 	m_shader.SetMat4("projection", cam.GetProjectionMatrix());
 	m_shader.SetMat4("model", model);
 
-	glBindVertexArray(m_vao);
-	glDrawArrays(GL_TRIANGLES, 0, 3);
-	glBindVertexArray(0);
-
-	m_shader.DeactivateProgram();
+	GLState::GetInstance().BindVertexArray(m_vao);
+	GLState::GetInstance().DrawArrays(GL_TRIANGLES, 0, 3);
 }
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+DynamicAABBTree::DynamicAABBTree() :
+	m_root(NULL_NODE),
+	m_freeList(NULL_NODE),
+	m_margin(1.0f)
+{}
+
+DynamicAABBTree::~DynamicAABBTree()
+{}
+
+void DynamicAABBTree::Clear()
+{
+	m_nodes.clear();
+	m_root = NULL_NODE;
+	m_freeList = NULL_NODE;
+}
+
+// -------------------
+// Descripción: Función que crea una hoja para la caja dada (se engorda con el margen) y devuelve su índice
+// -------------------
+int DynamicAABBTree::CreateProxy(const AABB& aabb, unsigned int userData)
+{
+	int proxy = AllocateNode();
+
+	m_nodes[proxy].m_aabb.m_min = aabb.m_min - glm::vec3(m_margin);
+	m_nodes[proxy].m_aabb.m_max = aabb.m_max + glm::vec3(m_margin);
+	m_nodes[proxy].m_userData = userData;
+	m_nodes[proxy].m_height = 0;
+
+	InsertLeaf(proxy);
+	return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+}
+
+// -------------------
+// Descripción: Función que actualiza la caja de una hoja. Si la caja nueva cabe en la gorda no se toca el árbol;
+// si no, la hoja se vuelve a insertar con una caja agrandada en la dirección del desplazamiento. Devuelve si se reinsertó.
+// -------------------
+bool DynamicAABBTree::MoveProxy(int proxy, const AABB& aabb, const glm::vec3& displacement)
+{
+	if (m_nodes[proxy].m_aabb.Contains(aabb))
+		return false;
+
+	RemoveLeaf(proxy);
+
+	AABB fat;
+	fat.m_min = aabb.m_min - glm::vec3(m_margin);
+	fat.m_max = aabb.m_max + glm::vec3(m_margin);
+
+	// Prever el movimiento del siguiente cuadro
+	glm::vec3 predicted = displacement * 2.0f;
+	fat.m_min += glm::min(predicted, glm::vec3(0.0f));
+	fat.m_max += glm::max(predicted, glm::vec3(0.0f));
+
+	m_nodes[proxy].m_aabb = fat;
+
+	InsertLeaf(proxy);
+	return true;
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+	if (m_freeList == NULL_NODE)
+	{
+		Node node;
+		node.m_parent = m_freeList;
+		node.m_height = -1;
+		m_nodes.push_back(node);
+		m_freeList = (int)m_nodes.size() - 1;
+	}
+
+	int node = m_freeList;
+	m_freeList = m_nodes[node].m_parent;
+
+	m_nodes[node].m_parent = NULL_NODE;
+	m_nodes[node].m_child1 = NULL_NODE;
+	m_nodes[node].m_child2 = NULL_NODE;
+	m_nodes[node].m_height = 0;
+	m_nodes[node].m_userData = 0;
+	return node;
+}
+
+void DynamicAABBTree::FreeNode(int node)
+{
+	m_nodes[node].m_parent = m_freeList;
+	m_nodes[node].m_height = -1;
+	m_freeList = node;
+}
+
+// -------------------
+// Descripción: Función que baja por el árbol eligiendo en cada nodo el hijo que menos área añade (costo heredado incluido),
+// crea un padre nuevo junto al hermano elegido y reajusta las cajas de los ancestros
+// -------------------
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+	if (m_root == NULL_NODE)
+	{
+		m_root = leaf;
+		m_nodes[m_root].m_parent = NULL_NODE;
+		return;
+	}
+
+	AABB leafAABB = m_nodes[leaf].m_aabb;
+	int index = m_root;
+
+	while (!m_nodes[index].IsLeaf())
+	{
+		int child1 = m_nodes[index].m_child1;
+		int child2 = m_nodes[index].m_child2;
+
+		float area = m_nodes[index].m_aabb.GetPerimeter();
+		float combinedArea = AABB::Combine(m_nodes[index].m_aabb, leafAABB).GetPerimeter();
+
+		// Costo de crear un padre nuevo aquí y costo mínimo que se hereda al bajar
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float cost1 = AABB::Combine(leafAABB, m_nodes[child1].m_aabb).GetPerimeter() + inheritanceCost;
+		float cost2 = AABB::Combine(leafAABB, m_nodes[child2].m_aabb).GetPerimeter() + inheritanceCost;
+
+		if (!m_nodes[child1].IsLeaf())
+			cost1 -= m_nodes[child1].m_aabb.GetPerimeter();
+
+		if (!m_nodes[child2].IsLeaf())
+			cost2 -= m_nodes[child2].m_aabb.GetPerimeter();
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int sibling = index;
+
+	// Crear el padre nuevo (AllocateNode puede mover el arreglo de nodos)
+	int oldParent = m_nodes[sibling].m_parent;
+	int newParent = AllocateNode();
+	m_nodes[newParent].m_parent = oldParent;
+	m_nodes[newParent].m_aabb = AABB::Combine(leafAABB, m_nodes[sibling].m_aabb);
+	m_nodes[newParent].m_height = m_nodes[sibling].m_height + 1;
+	m_nodes[newParent].m_child1 = sibling;
+	m_nodes[newParent].m_child2 = leaf;
+	m_nodes[sibling].m_parent = newParent;
+	m_nodes[leaf].m_parent = newParent;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (m_nodes[oldParent].m_child1 == sibling)
+			m_nodes[oldParent].m_child1 = newParent;
+		else
+			m_nodes[oldParent].m_child2 = newParent;
+	}
+	else
+	{
+		m_root = newParent;
+	}
+
+	// Subir reajustando alturas y cajas
+	index = m_nodes[leaf].m_parent;
+
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		int child1 = m_nodes[index].m_child1;
+		int child2 = m_nodes[index].m_child2;
+
+		m_nodes[index].m_height = 1 + std::max(m_nodes[child1].m_height, m_nodes[child2].m_height);
+		m_nodes[index].m_aabb = AABB::Combine(m_nodes[child1].m_aabb, m_nodes[child2].m_aabb);
+
+		index = m_nodes[index].m_parent;
+	}
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = NULL_NODE;
+		return;
+	}
+
+	int parent = m_nodes[leaf].m_parent;
+	int grandParent = m_nodes[parent].m_parent;
+	int sibling = m_nodes[parent].m_child1 == leaf ? m_nodes[parent].m_child2 : m_nodes[parent].m_child1;
+
+	if (grandParent == NULL_NODE)
+	{
+		m_root = sibling;
+		m_nodes[sibling].m_parent = NULL_NODE;
+		FreeNode(parent);
+		return;
+	}
+
+	// El hermano ocupa el lugar del padre
+	if (m_nodes[grandParent].m_child1 == parent)
+		m_nodes[grandParent].m_child1 = sibling;
+	else
+		m_nodes[grandParent].m_child2 = sibling;
+
+	m_nodes[sibling].m_parent = grandParent;
+	FreeNode(parent);
+
+	int index = grandParent;
+
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		int child1 = m_nodes[index].m_child1;
+		int child2 = m_nodes[index].m_child2;
+
+		m_nodes[index].m_aabb = AABB::Combine(m_nodes[child1].m_aabb, m_nodes[child2].m_aabb);
+		m_nodes[index].m_height = 1 + std::max(m_nodes[child1].m_height, m_nodes[child2].m_height);
+
+		index = m_nodes[index].m_parent;
+	}
+}
+
+// -------------------
+// Descripción: Función que hace una rotación si los subárboles de 'a' difieren en más de un nivel.
+// Devuelve el nodo que queda en la posición de 'a'.
+// -------------------
+int DynamicAABBTree::Balance(int a)
+{
+	Node& nodeA = m_nodes[a];
+
+	if (nodeA.IsLeaf() || nodeA.m_height < 2)
+		return a;
+
+	int b = nodeA.m_child1;
+	int c = nodeA.m_child2;
+	int balance = m_nodes[c].m_height - m_nodes[b].m_height;
+
+	if (balance > 1 || balance < -1)
+	{
+		// Subir el hijo más alto (y) y colocar a 'a' como su hijo; 'small' es el otro hijo de 'a'
+		int up = balance > 1 ? c : b;
+		int small = balance > 1 ? b : c;
+
+		Node& nodeUp = m_nodes[up];
+		int f = nodeUp.m_child1;
+		int g = nodeUp.m_child2;
+
+		nodeUp.m_child1 = a;
+		nodeUp.m_parent = nodeA.m_parent;
+		nodeA.m_parent = up;
+
+		if (nodeUp.m_parent != NULL_NODE)
+		{
+			if (m_nodes[nodeUp.m_parent].m_child1 == a)
+				m_nodes[nodeUp.m_parent].m_child1 = up;
+			else
+				m_nodes[nodeUp.m_parent].m_child2 = up;
+		}
+		else
+		{
+			m_root = up;
+		}
+
+		// El nieto más alto se queda con 'up' y el otro pasa a 'a'
+		int keep = m_nodes[f].m_height > m_nodes[g].m_height ? f : g;
+		int move = keep == f ? g : f;
+
+		nodeUp.m_child2 = keep;
+
+		if (balance > 1)
+			nodeA.m_child2 = move;
+		else
+			nodeA.m_child1 = move;
+
+		m_nodes[move].m_parent = a;
+
+		nodeA.m_aabb = AABB::Combine(m_nodes[small].m_aabb, m_nodes[move].m_aabb);
+		nodeUp.m_aabb = AABB::Combine(nodeA.m_aabb, m_nodes[keep].m_aabb);
+
+		nodeA.m_height = 1 + std::max(m_nodes[small].m_height, m_nodes[move].m_height);
+		nodeUp.m_height = 1 + std::max(nodeA.m_height, m_nodes[keep].m_height);
+
+		return up;
+	}
+
+	return a;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef __DYNAMICAABBTREE_H__
+#define __DYNAMICAABBTREE_H__
+
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <vector>
+
+struct AABB
+{
+	glm::vec3 m_min, m_max;
+
+	bool Contains(const AABB& other) const
+	{
+		return glm::all(glm::lessThanEqual(m_min, other.m_min)) && glm::all(glm::greaterThanEqual(m_max, other.m_max));
+	}
+
+	// Mitad del área de la superficie (basta para comparar costos)
+	float GetPerimeter() const
+	{
+		glm::vec3 size = m_max - m_min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	static AABB Combine(const AABB& a, const AABB& b)
+	{
+		AABB result;
+		result.m_min = glm::min(a.m_min, b.m_min);
+		result.m_max = glm::max(a.m_max, b.m_max);
+		return result;
+	}
+};
+
+// Árbol dinámico de cajas alineadas a los ejes para la fase amplia. Las hojas guardan una caja "gorda"
+// (con margen y desplazamiento previsto), así mover un objeto que no sale de su caja no cambia el árbol.
+// Las inserciones bajan eligiendo el hermano más barato según el área y el árbol se equilibra con rotaciones.
+class DynamicAABBTree
+{
+public:
+	enum { NULL_NODE = -1 };
+
+	struct Node
+	{
+		AABB m_aabb;
+		int m_parent;		// Siguiente nodo libre cuando el nodo no se usa
+		int m_child1, m_child2;
+		int m_height;		// -1 = nodo libre, 0 = hoja
+		unsigned int m_userData;
+
+		bool IsLeaf() const { return m_child1 == NULL_NODE; }
+	};
+
+	DynamicAABBTree();
+	~DynamicAABBTree();
+
+	int CreateProxy(const AABB& aabb, unsigned int userData);
+	void DestroyProxy(int proxy);
+	bool MoveProxy(int proxy, const AABB& aabb, const glm::vec3& displacement);
+	void Clear();
+
+	void SetMargin(float margin) { m_margin = margin; }
+
+	const AABB& GetFatAABB(int proxy) const { return m_nodes[proxy].m_aabb; }
+	unsigned int GetUserData(int proxy) const { return m_nodes[proxy].m_userData; }
+	const Node* GetNodes() const { return m_nodes.data(); }
+	int GetRoot() const { return m_root; }
+	int GetHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].m_height; }
+
+private:
+	std::vector<Node> m_nodes;
+	int m_root, m_freeList;
+	float m_margin;
+
+	// Private functions
+	int AllocateNode();
+	void FreeNode(int node);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	int Balance(int node);
+};
+
+#endif // !__DYNAMICAABBTREE_H__
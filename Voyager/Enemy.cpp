@@ -1,16 +1,17 @@
 #include "Enemy.h"
 #include "Renderer.h"
-#include "Utils.h"
+#include "Random.h"
 #include <cmath>
 #include "Player.h"
 #include "Audio.h"
 
 Enemy::Enemy(Camera& cam) :
-	m_pos(Utils::GetInstance().RandomNumBetweenTwo(50.0f, 450.0f), 0.0f, Utils::GetInstance().RandomNumBetweenTwo(0.0f, 450.0f)),
+	m_random(Random::GetInstance().CreateStream(Random::STREAM_ENEMIES)),
+	m_pos(0.0f),
 	m_maximumSpeed(15.0f),
 	m_maximumDroneSpeed(100.0f),
 	m_velocity(glm::vec3(1.0f, 1.0f, 1.0f)),
-	m_camera(cam),
+	m_camera(&cam),
 	m_health(100),
 	m_blastRadius(0.01f),
 	m_distance(0.0f),
@@ -29,6 +30,12 @@ Enemy::Enemy(Camera& cam) :
 	m_canRespawn(true),
 	m_dronePos(m_pos)
 {
+	// Posicin de aparicin (las dos coordenadas en orden fijo para que la secuencia no dependa del compilador)
+	float x = m_random.Range(50.0f, 450.0f);
+	float z = m_random.Range(0.0f, 450.0f);
+	m_pos = glm::vec3(x, 0.0f, z);
+	m_dronePos = m_pos;
+
 	m_particleEffect.Init("res/Shaders/Particle System Shaders/VertexShader.vs",
 		"res/Shaders/Particle System Shaders/GeometryShader.geom",
 		"res/Shaders/Particle System Shaders/FragmentShader.fs", 20, "redOrb");
@@ -52,20 +59,20 @@ void Enemy::Draw(short int enemyId, short int enemyDroneId)
 
 		// Actualice el sistema de transformacin y partculas del enemigo en cada cuadro y dibuje al enemigo
 		Renderer::GetInstance().GetComponent(enemyId).SetTransform(m_pos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f));
-		Renderer::GetInstance().GetComponent(enemyId).Draw(m_camera, glm::vec3(0.0f, 0.0f, 0.0f), false, Player::GetInstance().GetSpotLight());
+		Renderer::GetInstance().GetComponent(enemyId).Draw(*m_camera, glm::vec3(0.0f, 0.0f, 0.0f), false, Player::GetInstance().GetSpotLight());
 
 		if (m_currLifeTimer >= 0.2f)
-			m_particleEffect.Render(m_camera, m_deltaTime, glm::vec3(m_pos.x - 1.7f, m_pos.y + 4.5f, m_pos.z - 0.4f));
+			m_particleEffect.Render(*m_camera, m_deltaTime, glm::vec3(m_pos.x - 1.7f, m_pos.y + 4.5f, m_pos.z - 0.4f));
 
 		// Comprueba si el enemigo ha disparado un pequeo dron
 		if (m_droneActive)
 		{
 			// Actualice la transformacin del dron pequeo por cuadro
 			//Renderer::GetInstance().GetComponent(enemyDroneId).SetTransform(m_dronePos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.25f, 0.25f, 0.25f));
-			//Renderer::GetInstance().GetComponent(enemyDroneId).Draw(m_camera);
+			//Renderer::GetInstance().GetComponent(enemyDroneId).Draw(*m_camera);
 
 			// Comprueba si el jugador est chocando con el dron
-			if (Physics::GetInstance().PointInSphere(m_camera, m_dronePos, 2.0f))
+			if (Physics::GetInstance().PointInSphere(*m_camera, m_dronePos, 2.0f))
 			{
 				// Infligir dao al jugador
 				//Physics::GetInstance().OnPlayerHit(m_attackDamage);
@@ -91,10 +98,10 @@ void Enemy::DrawShockwave(short int enemyDroneBlastId)
 		{
 			// Actualizar explosin explosin
 			Renderer::GetInstance().GetComponent(enemyDroneBlastId).SetTransform(m_oldPlayerPos, glm::vec3(m_blastRadius * 20, m_blastRadius * 20, m_blastRadius * 20), glm::vec3(m_blastRadius));
-			Renderer::GetInstance().GetComponent(enemyDroneBlastId).Draw(m_camera);
+			Renderer::GetInstance().GetComponent(enemyDroneBlastId).Draw(*m_camera);
 
 			// Comprueba si el enemigo puede daar y si el jugador queda atrapado dentro de la explosin creciente
-			if (m_damageToken && Physics::GetInstance().PointInSphere(m_camera, m_oldPlayerPos, (m_blastRadius * 4)))
+			if (m_damageToken && Physics::GetInstance().PointInSphere(*m_camera, m_oldPlayerPos, (m_blastRadius * 4)))
 			{
 				// IInfligir dao al jugador
 				Physics::GetInstance().OnPlayerHit(m_attackDamage);
@@ -120,7 +127,7 @@ void Enemy::Update(Terrain& terrain, Camera& cam, float dt)
 	if (!m_dead)
 	{
 		m_deltaTime = dt;
-		m_camera = cam;
+		m_camera = &cam;
 		m_pos.y = terrain.GetHeightOfTerrain(m_pos.x, m_pos.z) + 5.0f;
 		m_distance = CalcDistance(m_pos, cam.GetCameraPos());
 		m_currLifeTimer += 0.1f * dt;
@@ -151,7 +158,7 @@ void Enemy::Update(Terrain& terrain, Camera& cam, float dt)
 			else
 			{
 				// Generar nmero aleatorio (1 - 100)
-				int dashSidewaysChance = Utils::GetInstance().RandomNumBetween1And100();
+				int dashSidewaysChance = m_random.RangeInt(1, 100);
 
 				// Compruebe la posibilidad de evadir (3% de probabilidad)
 				if (dashSidewaysChance > 97)
@@ -160,7 +167,7 @@ void Enemy::Update(Terrain& terrain, Camera& cam, float dt)
 					m_evade = true;
 
 					// Genera el lado aleatorio hacia el que el enemigo debe evadir
-					int dashSide = Utils::GetInstance().RandomNumBetween1And100();
+					int dashSide = m_random.RangeInt(1, 100);
 
 					// 50/50 de probabilidad de evadir en ambos lados
 					if (dashSide > 50)
@@ -206,7 +213,7 @@ void Enemy::Update(Terrain& terrain, Camera& cam, float dt)
 		}
 		else
 		{
-			m_shootDuration += Utils::GetInstance().RandomNumBetweenTwo(0.1f, 0.5f) * dt;
+			m_shootDuration += m_random.Range(0.1f, 0.5f) * dt;
 		}
 
 		if (m_fire)
@@ -233,7 +240,7 @@ void Enemy::ReduceHealth(int amount)
 		m_dead = true;
 
 		// Jugador uno de los sonidos del monstruo muerto.
-		if (Utils::GetInstance().RandomNumBetweenTwo(1.0f, 2.0f) > 1.5f)
+		if (m_random.Range(1.0f, 2.0f) > 1.5f)
 			Audio::GetInstance().PlaySound(Audio::GetInstance().GetSoundsMap().find("EnemyDead")->second);
 		else
 			Audio::GetInstance().PlaySound(Audio::GetInstance().GetSoundsMap().find("EnemyDead2")->second);
@@ -243,13 +250,16 @@ void Enemy::ReduceHealth(int amount)
 // Funcin que encuentra la distancia entre dos vectores
 inline float Enemy::CalcDistance(glm::vec3& enemyPos, glm::vec3& playerPos)
 {
-	return sqrt(powf(enemyPos.x - playerPos.x, 2.0f) + powf(enemyPos.y - playerPos.y, 2.0f) + powf(enemyPos.z - playerPos.z, 2.0f));
+	glm::vec3 diff = enemyPos - playerPos;
+	return sqrtf(glm::dot(diff, diff));
 }
 
 // Funcin que encuentra la distancia entre dos vectores sin tener en cuenta el eje y (solo plano XZ)
 inline float Enemy::CalcDistanceNoHeight(glm::vec3& enemyPos, glm::vec3& playerPos)
 {
-	return sqrt(powf(enemyPos.x - playerPos.x, 2.0f) + powf(enemyPos.z - playerPos.z, 2.0f));
+	float dx = enemyPos.x - playerPos.x;
+	float dz = enemyPos.z - playerPos.z;
+	return sqrtf(dx * dx + dz * dz);
 }
 
 void Enemy::SetRespawnStatus(bool canRespawn)
@@ -347,7 +357,9 @@ void Enemy::Respawn()
 			m_health = 100;
 
 			// Establecer nueva posicin de generacin
-			m_pos = glm::vec3(Utils::GetInstance().RandomNumBetweenTwo(50.0f, 520.0f), 0.0f, Utils::GetInstance().RandomNumBetweenTwo(0.0f, 650.0f));
+			float x = m_random.Range(50.0f, 520.0f);
+			float z = m_random.Range(0.0f, 650.0f);
+			m_pos = glm::vec3(x, 0.0f, z);
 		}
 	}
 }
\ No newline at end of file
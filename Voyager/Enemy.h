@@ -6,6 +6,7 @@
 #include "Camera.h"
 #include "Terrain.h"
 #include "ParticleEmitter.h"
+#include "Random.h"
 
 class Enemy
 {
@@ -34,7 +35,8 @@ public:
 	bool GetRespawnStatus() { return m_canRespawn; }
 
 private:
-	Camera m_camera;
+	RandomStream m_random;
+	Camera* m_camera;
 	glm::vec3 m_pos, m_velocity, m_fireDir, m_dronePos, m_oldPlayerPos;
 
 	float m_maximumSpeed, m_maximumDroneSpeed;
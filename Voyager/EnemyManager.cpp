@@ -0,0 +1,590 @@
+#include "EnemyManager.h"
+#include "ProjectileSystem.h"
+#include "Renderer.h"
+#include "Physics.h"
+#include "Random.h"
+#include "Player.h"
+#include "Audio.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+
+EnemyManager::EnemyManager() :
+	m_flowField(nullptr),
+	m_perception(nullptr),
+	m_projectiles(nullptr),
+	m_terrain(nullptr),
+	m_count(0),
+	m_capacity(0),
+	m_maximumSpeed(15.0f),
+	m_attackDamage(10.0f),
+	m_radius(3.0f),
+	m_fleeDistance(75.0f),
+	m_playerPos(0.0f, 0.0f, 0.0f),
+	m_deltaTime(0.0f)
+{}
+
+EnemyManager::~EnemyManager()
+{}
+
+// -------------------
+// Descripción: Función que reserva los arreglos de estado para 'capacity' enemigos y crea los emisores de partículas compartidos
+// -------------------
+void EnemyManager::Init(unsigned int capacity)
+{
+	m_capacity = capacity;
+	m_count = 0;
+
+	m_posX.resize(capacity); m_posY.resize(capacity); m_posZ.resize(capacity);
+	m_velX.resize(capacity); m_velY.resize(capacity); m_velZ.resize(capacity);
+	m_targetX.resize(capacity); m_targetY.resize(capacity); m_targetZ.resize(capacity);
+	m_lastSeenX.resize(capacity); m_lastSeenY.resize(capacity); m_lastSeenZ.resize(capacity);
+
+	m_health.resize(capacity);
+	m_lifeTimer.resize(capacity);
+	m_respawnTimer.resize(capacity);
+	m_damageTakenDuration.resize(capacity);
+	m_evadeDuration.resize(capacity);
+	m_shootDuration.resize(capacity);
+	m_blastRadius.resize(capacity);
+	m_state.resize(capacity);
+	m_random.resize(capacity);
+
+	SeedRandomStates();
+
+	m_grid.Init(0.0f, 0.0f, (float)WORLD_SIZE, (float)WORLD_SIZE, (float)GRID_CELL_SIZE);
+	m_scheduler.Init(capacity);
+
+	if (!m_behavior.IsLoaded())
+	{
+		RegisterBehaviors();
+		m_behavior.LoadFromFile("res/AI/Enemy.bt");
+		m_instancingShader.CreateProgram("res/Shaders/EnemyInstancing.vs", "res/Shaders/EnemyInstancing.fs");
+	}
+
+	// Un emisor por enemigo no escala a miles de agentes: solo los más cercanos muestran su efecto
+	m_particleEffects.resize(std::min<unsigned int>(capacity, MAX_PARTICLE_EFFECTS));
+	m_effectOwners.assign(m_particleEffects.size(), capacity);
+
+	for (auto iter = m_particleEffects.begin(); iter != m_particleEffects.end(); ++iter)
+	{
+		(*iter).Init("res/Shaders/Particle System Shaders/VertexShader.vs",
+			"res/Shaders/Particle System Shaders/GeometryShader.geom",
+			"res/Shaders/Particle System Shaders/FragmentShader.fs", 20, "redOrb");
+	}
+}
+
+// -------------------
+// Descripción: Función que activa un nuevo enemigo en una posición aleatoria (devuelve -1 si no queda espacio)
+// -------------------
+int EnemyManager::Spawn()
+{
+	if (m_count >= m_capacity)
+		return -1;
+
+	unsigned int enemy = m_count++;
+	ResetEnemy(enemy);
+	m_state[enemy] |= STATE_CAN_RESPAWN;
+
+	m_posX[enemy] = m_random[enemy].Range(50.0f, 450.0f);
+	m_posY[enemy] = 0.0f;
+	m_posZ[enemy] = m_random[enemy].Range(0.0f, 450.0f);
+
+	return (int)enemy;
+}
+
+void EnemyManager::SetRespawnStatus(bool canRespawn)
+{
+	for (unsigned int i = 0; i < m_count; ++i)
+	{
+		if (canRespawn)
+			m_state[i] |= STATE_CAN_RESPAWN;
+		else
+			m_state[i] &= ~STATE_CAN_RESPAWN;
+	}
+}
+
+void EnemyManager::Restart()
+{
+	m_count = 0;
+	SeedRandomStates();
+	RebuildGrid();
+}
+
+// -------------------
+// Descripción: Función que da a cada enemigo su flujo aleatorio, derivado de la semilla de la partida y de su índice;
+// así los dados de cada enemigo no dependen del hilo que lo actualice
+// -------------------
+void EnemyManager::SeedRandomStates()
+{
+	for (unsigned int i = 0; i < m_random.size(); ++i)
+		m_random[i] = Random::GetInstance().GetStream(Random::STREAM_ENEMIES, i);
+}
+
+// -------------------
+// Descripción: Función que resume el estado de los enemigos (FNV-1a) para comprobar que una repetición no se desincroniza
+// -------------------
+uint32_t EnemyManager::ComputeChecksum()
+{
+	uint32_t hash = 2166136261u;
+
+	auto mix = [&hash](const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+	};
+
+	mix(&m_count, sizeof(m_count));
+	mix(m_posX.data(), sizeof(float) * m_count);
+	mix(m_posY.data(), sizeof(float) * m_count);
+	mix(m_posZ.data(), sizeof(float) * m_count);
+	mix(m_health.data(), sizeof(int) * m_count);
+	mix(m_state.data(), sizeof(uint16_t) * m_count);
+	return hash;
+}
+
+// -------------------
+// Descripción: Función que devuelve el enemigo vivo más cercano atravesado por el rayo
+// -------------------
+bool EnemyManager::Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, unsigned int& enemy, float& distance)
+{
+	SpatialHit hit;
+
+	// Un enemigo puede morir después de reconstruir la rejilla, así que se vuelve a comprobar al probarlo
+	if (!m_grid.Raycast(origin, dir, maxDistance, hit, [this](unsigned int id) { return IsAlive(id); }))
+		return false;
+
+	enemy = hit.m_id;
+	distance = hit.m_distance;
+	return true;
+}
+
+void EnemyManager::QueryRadius(const glm::vec3& center, float radius, std::vector<unsigned int>& enemies)
+{
+	m_grid.QueryRadius(center, radius, enemies);
+}
+
+void EnemyManager::QueryNearest(const glm::vec3& center, unsigned int k, float maxDistance, std::vector<SpatialHit>& enemies)
+{
+	m_grid.QueryNearest(center, k, maxDistance, enemies);
+}
+
+// -------------------
+// Descripción: Función que daña a todos los enemigos vivos dentro de una explosión (solo recorre las celdas afectadas)
+// -------------------
+void EnemyManager::ApplyAreaDamage(const glm::vec3& center, float radius, int amount)
+{
+	std::vector<unsigned int> enemies;
+	m_grid.QueryRadius(center, radius, enemies);
+
+	for (auto iter = enemies.begin(); iter != enemies.end(); ++iter)
+	{
+		if (IsAlive(*iter))
+			ReduceHealth(*iter, amount);
+	}
+}
+
+// -------------------
+// Descripción: Función que actualiza a los enemigos que el planificador elige para este cuadro, repartidos entre hilos.
+// Todos los enemigos leen la misma cámara del cuadro en lugar de guardar una copia cada uno.
+// -------------------
+void EnemyManager::Update(Terrain& terrain, Camera& cam, float dt)
+{
+	m_deltaTime = dt;
+	m_playerPos = cam.GetCameraPos();
+	m_terrain = &terrain;
+
+	m_scheduler.Schedule(m_posX.data(), m_posZ.data(), m_count, cam, dt);
+
+	const std::vector<unsigned int>& agents = m_scheduler.GetAgents();
+	const std::vector<float>& deltaTimes = m_scheduler.GetDeltaTimes();
+
+	m_scheduler.BeginUpdate();
+
+	// Cada lote de agentes recorre el mismo árbol de comportamiento
+	JobSystem::GetInstance().ParallelFor((unsigned int)agents.size(), PARALLEL_BATCH_SIZE, [this, &agents, &deltaTimes](unsigned int begin, unsigned int end)
+	{
+		m_behavior.TickBatch(this, &agents[begin], &deltaTimes[begin], end - begin);
+	});
+
+	m_scheduler.EndUpdate();
+
+	// Entregar al hilo de percepción las líneas de visión pedidas en este cuadro
+	if (m_perception)
+		m_perception->Update(dt);
+
+	LaunchDrones();
+	RebuildGrid();
+}
+
+// -------------------
+// Descripción: Función que registra las condiciones y acciones que usa el árbol de comportamiento de los enemigos.
+// Los arreglos SoA del gestor hacen de pizarra: cada hoja solo toca los datos del agente que recibe.
+// -------------------
+void EnemyManager::RegisterBehaviors()
+{
+	m_behavior.RegisterLeaf("IsDead", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		return (e.m_state[i] & STATE_DEAD) ? BT_SUCCESS : BT_FAILURE;
+	});
+
+	m_behavior.RegisterLeaf("Respawn", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		e.m_posY[i] = -999.0f;
+		e.m_lifeTimer[i] = 0.0f;
+		e.Respawn(i, dt);
+		return BT_SUCCESS;
+	});
+
+	// Si el jugador se está acercando demasiado huir, si no moverse hacia él (siguiendo el campo de flujo compartido)
+	m_behavior.RegisterLeaf("Navigate", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+
+		if (e.m_flowField)
+		{
+			float dx = e.m_posX[i] - e.m_playerPos.x;
+			float dz = e.m_posZ[i] - e.m_playerPos.z;
+			float heading = (dx * dx + dz * dz < e.m_fleeDistance * e.m_fleeDistance) ? -1.0f : 1.0f;
+			glm::vec2 direction = e.m_flowField->GetDirection(e.m_posX[i], e.m_posZ[i]) * (heading * e.m_maximumSpeed);
+
+			e.m_velX[i] = direction.x;
+			e.m_velZ[i] = direction.y;
+			e.m_posX[i] += direction.x * dt;
+			e.m_posZ[i] += direction.y * dt;
+		}
+
+		e.m_posY[i] = e.m_terrain->GetHeightOfTerrain(e.m_posX[i], e.m_posZ[i]) + 5.0f;
+		e.m_lifeTimer[i] += 0.1f * dt;
+		return BT_SUCCESS;
+	});
+
+	m_behavior.RegisterLeaf("IsTakingDamage", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		return (e.m_state[i] & STATE_TAKING_DAMAGE) ? BT_SUCCESS : BT_FAILURE;
+	});
+
+	// Crea una ventana de duración del daño recibido para simular el comportamiento de pánico del enemigo
+	m_behavior.RegisterLeaf("Panic", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		e.m_damageTakenDuration[i] += 0.1f * dt;
+
+		if (e.m_damageTakenDuration[i] > 0.02f)
+		{
+			e.m_state[i] &= ~STATE_TAKING_DAMAGE;
+			e.m_damageTakenDuration[i] = 0.0f;
+		}
+		else if (e.m_random[i].Range(1.0f, 100.0f) > 97.0f)
+		{
+			// Evadir hacia un lado aleatorio (3% de probabilidad, 50/50 para cada lado)
+			e.m_state[i] |= STATE_EVADE;
+
+			if (e.m_random[i].Range(1.0f, 100.0f) > 50.0f)
+				e.m_state[i] &= ~STATE_EVADE_RIGHT;
+			else
+				e.m_state[i] |= STATE_EVADE_RIGHT;
+
+			e.m_state[i] &= ~STATE_TAKING_DAMAGE;
+			e.m_damageTakenDuration[i] = 0.0f;
+		}
+
+		return BT_SUCCESS;
+	});
+
+	m_behavior.RegisterLeaf("IsEvading", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		return (e.m_state[i] & STATE_EVADE) ? BT_SUCCESS : BT_FAILURE;
+	});
+
+	m_behavior.RegisterLeaf("Evade", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+
+		if (e.m_state[i] & STATE_EVADE_RIGHT)
+			e.m_posX[i] += (e.m_maximumSpeed * 5) * dt;
+		else
+			e.m_posX[i] -= (e.m_maximumSpeed * 5) * dt;
+
+		e.m_evadeDuration[i] += 0.1f * dt;
+
+		if (e.m_evadeDuration[i] > 0.07f)
+		{
+			e.m_state[i] &= ~(STATE_EVADE | STATE_EVADE_RIGHT);
+			e.m_evadeDuration[i] = 0.0f;
+		}
+
+		return BT_SUCCESS;
+	});
+
+	m_behavior.RegisterLeaf("ShootTimerElapsed", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		return e.m_shootDuration[i] > 1.0f ? BT_SUCCESS : BT_FAILURE;
+	});
+
+	m_behavior.RegisterLeaf("StartFiring", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		e.m_shootDuration[i] = 0.0f;
+		e.m_state[i] |= STATE_FIRE;
+		return BT_SUCCESS;
+	});
+
+	m_behavior.RegisterLeaf("ChargeShootTimer", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		e.m_shootDuration[i] += e.m_random[i].Range(0.1f, 0.5f) * dt;
+		return BT_SUCCESS;
+	});
+
+	m_behavior.RegisterLeaf("IsFiring", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		return (e.m_state[i] & STATE_FIRE) ? BT_SUCCESS : BT_FAILURE;
+	});
+
+	// Sin servicio de percepción los enemigos siguen viendo siempre al jugador
+	m_behavior.RegisterLeaf("CanSeePlayer", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+
+		if (e.m_perception)
+		{
+			if (e.m_perception->NeedsRefresh(i))
+				e.m_perception->RequestLineOfSight(i, glm::vec3(e.m_posX[i], e.m_posY[i], e.m_posZ[i]), e.m_playerPos);
+
+			if (!e.m_perception->HasLineOfSight(i))
+				return BT_FAILURE;
+		}
+
+		e.m_lastSeenX[i] = e.m_playerPos.x;
+		e.m_lastSeenY[i] = e.m_playerPos.y;
+		e.m_lastSeenZ[i] = e.m_playerPos.z;
+		return BT_SUCCESS;
+	});
+
+	m_behavior.RegisterLeaf("LaunchDrone", [](void* owner, unsigned int i, float dt)
+	{
+		EnemyManager& e = *(EnemyManager*)owner;
+		e.Fire(i, glm::vec3(e.m_lastSeenX[i], e.m_lastSeenY[i], e.m_lastSeenZ[i]));
+		return BT_SUCCESS;
+	});
+}
+
+// -------------------
+// Descripción: Función que apunta el lanzamiento del dron hacia la última posición donde se vio al jugador.
+// Se llama desde los hilos del árbol de comportamiento, así que solo toca el estado del propio enemigo;
+// el disparo al grupo de proyectiles lo hace LaunchDrones después.
+// -------------------
+void EnemyManager::Fire(unsigned int i, const glm::vec3& playerPos)
+{
+	// Comprobar si el dron acaba de ser disparado: guardar la posición del jugador una sola vez
+	if ((m_state[i] & STATE_DRONE_READY) && !(m_state[i] & STATE_SELF_DESTRUCT))
+	{
+		m_targetX[i] = playerPos.x;
+		m_targetY[i] = playerPos.y;
+		m_targetZ[i] = playerPos.z;
+		m_state[i] = (m_state[i] | STATE_DRONE_LAUNCH) & ~STATE_DRONE_READY;
+	}
+}
+
+// -------------------
+// Descripción: Función que dispara al grupo de proyectiles los drones pedidos en este cuadro, en orden de enemigo.
+// Si el grupo está lleno (o no hay grupo) el dron vuelve a estar listo y se reintenta en el siguiente cuadro.
+// -------------------
+void EnemyManager::LaunchDrones()
+{
+	for (unsigned int i = 0; i < m_count; ++i)
+	{
+		if (!(m_state[i] & STATE_DRONE_LAUNCH))
+			continue;
+
+		m_state[i] &= ~STATE_DRONE_LAUNCH;
+
+		if (!m_projectiles || m_projectiles->FireHoming(PROJECTILE_DRONE, GetPos(i), glm::vec3(m_targetX[i], m_targetY[i], m_targetZ[i]), i) < 0)
+			m_state[i] |= STATE_DRONE_READY;
+	}
+}
+
+// -------------------
+// Descripción: Función a la que llama el ProjectileSystem cuando el dron de un enemigo desaparece (llegada, impacto
+// o fin de su tiempo de vida): el dron se recicla para uso futuro
+// -------------------
+void EnemyManager::OnProjectileReleased(unsigned int enemy)
+{
+	if (enemy < m_count)
+		m_state[enemy] = (m_state[enemy] | STATE_DRONE_READY) & ~STATE_FIRE;
+}
+
+void EnemyManager::Respawn(unsigned int i, float dt)
+{
+	if (!(m_state[i] & STATE_CAN_RESPAWN))
+		return;
+
+	m_respawnTimer[i] += 1.0f * dt;
+
+	if (m_respawnTimer[i] >= 15.0f)
+	{
+		ResetEnemy(i);
+		m_state[i] |= STATE_CAN_RESPAWN;
+
+		// Establecer nueva posición de generación
+		m_posX[i] = m_random[i].Range(50.0f, 520.0f);
+		m_posZ[i] = m_random[i].Range(0.0f, 650.0f);
+	}
+}
+
+// -------------------
+// Descripción: Función que reconstruye la rejilla con los enemigos vivos
+// -------------------
+void EnemyManager::RebuildGrid()
+{
+	m_grid.Clear();
+
+	for (unsigned int i = 0; i < m_count; ++i)
+	{
+		if (!(m_state[i] & STATE_DEAD))
+			m_grid.Insert(i, GetPos(i), m_radius);
+	}
+
+	m_grid.Build();
+}
+
+void EnemyManager::ResetEnemy(unsigned int i)
+{
+	m_velX[i] = m_velY[i] = m_velZ[i] = 1.0f;
+	m_health[i] = 100;
+	m_lifeTimer[i] = 0.0f;
+	m_respawnTimer[i] = 0.0f;
+	m_damageTakenDuration[i] = 0.0f;
+	m_evadeDuration[i] = 0.0f;
+	m_shootDuration[i] = 0.0f;
+	m_blastRadius[i] = 0.01f;
+	m_state[i] = STATE_DRONE_READY | STATE_DAMAGE_TOKEN;
+}
+
+// -------------------
+// Descripción: Función que dibuja a todos los enemigos vivos con un lote instanciado (los drones los dibuja el ProjectileSystem)
+// -------------------
+void EnemyManager::Draw(Camera& cam, short int enemyId)
+{
+	if (!m_enemyBatch.IsReady())
+		InitRendering(enemyId);
+
+	m_enemyBatch.Clear();
+
+	for (unsigned int i = 0; i < m_count; ++i)
+	{
+		if (m_state[i] & STATE_DEAD)
+			continue;
+
+		// Si el enemigo está recibiendo daño, haz que parpadee en rojo
+		m_enemyBatch.Add(GetPos(i), 1.0f, glm::vec4(1.0f), (m_state[i] & STATE_TAKING_DAMAGE) != 0);
+	}
+
+	m_enemyBatch.Draw(m_instancingShader, cam, Player::GetInstance().GetSpotLight());
+
+	AssignParticleEffects(cam.GetCameraPos());
+
+	for (unsigned int e = 0; e < m_particleEffects.size(); ++e)
+	{
+		unsigned int owner = m_effectOwners[e];
+
+		if (owner < m_count && m_lifeTimer[owner] >= 0.2f)
+			m_particleEffects[e].Render(cam, m_deltaTime, glm::vec3(m_posX[owner] - 1.7f, m_posY[owner] + 4.5f, m_posZ[owner] - 0.4f));
+	}
+}
+
+// -------------------
+// Descripción: Función que dibuja las explosiones de los drones y aplica su daño al jugador
+// -------------------
+void EnemyManager::DrawShockwaves(Camera& cam, short int enemyDroneBlastId)
+{
+	if (!m_blastBatch.IsReady())
+		m_blastBatch.Init(Renderer::GetInstance().GetComponent(enemyDroneBlastId), m_capacity);
+
+	m_blastBatch.Clear();
+
+	for (unsigned int i = 0; i < m_count; ++i)
+	{
+		if (!(m_state[i] & STATE_SELF_DESTRUCT))
+			continue;
+
+		// Aumentar el radio de explosión
+		m_blastRadius[i] += 5.0f * m_deltaTime;
+		float blastRadius = m_blastRadius[i];
+		glm::vec3 blastPos(m_targetX[i], m_targetY[i], m_targetZ[i]);
+
+		if (blastRadius < 7.0f)
+		{
+			m_blastBatch.Add(blastPos, blastRadius, glm::vec4(1.0f), false, blastRadius * 20, true);
+
+			// El jugador solo recibe daño una vez por explosión (ficha de daño)
+			if ((m_state[i] & STATE_DAMAGE_TOKEN) && Physics::GetInstance().PointInSphere(cam, blastPos, blastRadius * 4))
+			{
+				Physics::GetInstance().OnPlayerHit(m_attackDamage);
+				m_state[i] &= ~STATE_DAMAGE_TOKEN;
+			}
+		}
+		else
+		{
+			m_state[i] = (m_state[i] & ~STATE_SELF_DESTRUCT) | STATE_DAMAGE_TOKEN;
+			m_blastRadius[i] = 0.01f;
+		}
+	}
+
+	m_blastBatch.Draw(m_instancingShader, cam);
+}
+
+// -------------------
+// Descripción: Función que engancha los buffers de instancias a los objetos del Renderer la primera vez que se dibujan
+// -------------------
+void EnemyManager::InitRendering(short int enemyId)
+{
+	m_enemyBatch.Init(Renderer::GetInstance().GetComponent(enemyId), m_capacity);
+}
+
+void EnemyManager::ReduceHealth(unsigned int enemy, int amount)
+{
+	m_health[enemy] -= amount;
+	m_state[enemy] |= STATE_TAKING_DAMAGE | STATE_DEAD;
+
+	if (m_health[enemy] <= 0)
+	{
+		// Jugador uno de los sonidos del monstruo muerto.
+		if (m_random[enemy].Range(1.0f, 2.0f) > 1.5f)
+			Audio::GetInstance().PlaySound(Audio::GetInstance().GetSoundsMap().find("EnemyDead")->second);
+		else
+			Audio::GetInstance().PlaySound(Audio::GetInstance().GetSoundsMap().find("EnemyDead2")->second);
+	}
+}
+
+// -------------------
+// Descripción: Función que asigna los emisores de partículas a los enemigos vivos más cercanos al jugador (consulta k-vecinos en la rejilla)
+// -------------------
+void EnemyManager::AssignParticleEffects(const glm::vec3& playerPos)
+{
+	std::vector<SpatialHit> nearest;
+	m_grid.QueryNearest(playerPos, (unsigned int)m_particleEffects.size(), (float)WORLD_SIZE * 2.0f, nearest);
+
+	size_t effect = 0;
+
+	for (auto iter = nearest.begin(); iter != nearest.end(); ++iter)
+	{
+		if (IsAlive((*iter).m_id))
+			m_effectOwners[effect++] = (*iter).m_id;
+	}
+
+	for (; effect < m_particleEffects.size(); ++effect)
+		m_effectOwners[effect] = m_capacity;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef __ENEMYMANAGER_H__
+#define __ENEMYMANAGER_H__
+
+#include "Camera.h"
+#include "Terrain.h"
+#include "ParticleEmitter.h"
+#include "SpatialGrid.h"
+#include "FlowField.h"
+#include "PerceptionSystem.h"
+#include "AIScheduler.h"
+#include "BehaviorTree.h"
+#include "InstancedBatch.h"
+#include "Random.h"
+#include <cstdint>
+#include <vector>
+
+class ProjectileSystem;
+
+// Gestor de enemigos orientado a datos: el estado de cada enemigo se guarda en arreglos paralelos (SoA)
+// y se actualiza en una sola pasada lineal que se puede repartir entre hilos.
+class EnemyManager
+{
+public:
+	EnemyManager();
+	~EnemyManager();
+
+	void Init(unsigned int capacity);
+	int Spawn();
+	void Update(Terrain& terrain, Camera& cam, float dt);
+	void Draw(Camera& cam, short int enemyId);
+	void DrawShockwaves(Camera& cam, short int enemyDroneBlastId);
+	void ReduceHealth(unsigned int enemy, int amount);
+	void OnProjectileReleased(unsigned int enemy);
+	void Restart();
+
+	// Consultas espaciales (rejilla reconstruida al final de cada Update)
+	bool Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, unsigned int& enemy, float& distance);
+	void QueryRadius(const glm::vec3& center, float radius, std::vector<unsigned int>& enemies);
+	void QueryNearest(const glm::vec3& center, unsigned int k, float maxDistance, std::vector<SpatialHit>& enemies);
+	void ApplyAreaDamage(const glm::vec3& center, float radius, int amount);
+
+	void SetAttackDamage(float attkDmg) { m_attackDamage = attkDmg; }
+	void SetRespawnStatus(bool canRespawn);
+	void SetFlowField(const FlowField* flowField) { m_flowField = flowField; }
+	void SetPerception(PerceptionSystem* perception) { m_perception = perception; }
+	void SetProjectiles(ProjectileSystem* projectiles) { m_projectiles = projectiles; }
+	AIScheduler& GetScheduler() { return m_scheduler; }
+
+	unsigned int GetCount() { return m_count; }
+	unsigned int GetCapacity() { return m_capacity; }
+	float GetAttackDamage() { return m_attackDamage; }
+	float GetRadius() { return m_radius; }
+	uint32_t ComputeChecksum();
+	bool IsAlive(unsigned int enemy) { return (m_state[enemy] & STATE_DEAD) == 0; }
+	glm::vec3 GetPos(unsigned int enemy) { return glm::vec3(m_posX[enemy], m_posY[enemy], m_posZ[enemy]); }
+
+private:
+	enum
+	{
+		STATE_DEAD = 1 << 0,
+		STATE_TAKING_DAMAGE = 1 << 1,
+		STATE_EVADE = 1 << 2,
+		STATE_EVADE_RIGHT = 1 << 3,
+		STATE_FIRE = 1 << 4,
+		STATE_DRONE_READY = 1 << 5,
+		STATE_DRONE_LAUNCH = 1 << 6,
+		STATE_SELF_DESTRUCT = 1 << 7,
+		STATE_CAN_RESPAWN = 1 << 8,
+		STATE_DAMAGE_TOKEN = 1 << 9
+	};
+
+	// Número máximo de emisores de partículas (se asignan a los enemigos vivos más cercanos)
+	enum { MAX_PARTICLE_EFFECTS = 16, PARALLEL_BATCH_SIZE = 256 };
+
+	// Área del terreno (256 vértices x 3 unidades) y tamaño de celda de las rejillas espaciales
+	enum { WORLD_SIZE = 768, GRID_CELL_SIZE = 16 };
+
+	// Posición, velocidad y objetivo del dron (el dron en vuelo vive en el ProjectileSystem)
+	std::vector<float> m_posX, m_posY, m_posZ;
+	std::vector<float> m_velX, m_velY, m_velZ;
+	std::vector<float> m_targetX, m_targetY, m_targetZ;
+
+	// Última posición del jugador que cada enemigo ha visto
+	std::vector<float> m_lastSeenX, m_lastSeenY, m_lastSeenZ;
+
+	// Salud, temporizadores y bits de estado
+	std::vector<int> m_health;
+	std::vector<float> m_lifeTimer, m_respawnTimer, m_damageTakenDuration, m_evadeDuration, m_shootDuration, m_blastRadius;
+	std::vector<uint16_t> m_state;
+	std::vector<RandomStream> m_random;
+
+	std::vector<ParticleEmitter> m_particleEffects;
+	std::vector<unsigned int> m_effectOwners;
+
+	// Rejilla espacial de enemigos vivos
+	SpatialGrid m_grid;
+	const FlowField* m_flowField;
+	PerceptionSystem* m_perception;
+	ProjectileSystem* m_projectiles;
+	Terrain* m_terrain;
+	AIScheduler m_scheduler;
+	BehaviorTree m_behavior;
+
+	// Lotes instanciados: una llamada de dibujo por tipo (enemigos y explosiones)
+	InstancedBatch m_enemyBatch, m_blastBatch;
+	Shader m_instancingShader;
+
+	unsigned int m_count, m_capacity;
+	float m_maximumSpeed, m_attackDamage, m_radius, m_fleeDistance;
+	glm::vec3 m_playerPos;
+	float m_deltaTime;
+
+	// Private functions
+	void RegisterBehaviors();
+	void SeedRandomStates();
+	void Fire(unsigned int enemy, const glm::vec3& playerPos);
+	void LaunchDrones();
+	void Respawn(unsigned int enemy, float dt);
+	void ResetEnemy(unsigned int enemy);
+	void AssignParticleEffects(const glm::vec3& playerPos);
+	void RebuildGrid();
+	void InitRendering(short int enemyId);
+};
+
+#endif // !__ENEMYMANAGER_H__
@@ -0,0 +1,54 @@
+#include "FixedTimestep.h"
+#include <algorithm>
+
+FixedTimestep::FixedTimestep() :
+	m_step(1.0f / 60.0f),
+	m_maxFrameTime(0.25f),
+	m_accumulator(0.0),
+	m_maxStepsPerFrame(8),
+	m_droppedSteps(0),
+	m_tick(0)
+{}
+
+FixedTimestep::~FixedTimestep()
+{}
+
+void FixedTimestep::Init(float step, unsigned int maxStepsPerFrame)
+{
+	m_step = step;
+	m_maxStepsPerFrame = std::max(1u, maxStepsPerFrame);
+	Reset();
+}
+
+void FixedTimestep::Reset()
+{
+	m_accumulator = 0.0;
+	m_droppedSteps = 0;
+	m_tick = 0;
+}
+
+// -------------------
+// Descripción: Función que suma el tiempo del cuadro y devuelve cuántos pasos fijos hay que simular.
+// Si el cuadro tardó demasiado (carga, depurador) se descarta el tiempo sobrante en vez de intentar recuperarlo,
+// para no entrar en una espiral de cuadros cada vez más lentos.
+// -------------------
+unsigned int FixedTimestep::Advance(float frameTime)
+{
+	m_accumulator += std::min(std::max(frameTime, 0.0f), m_maxFrameTime);
+
+	unsigned int steps = (unsigned int)(m_accumulator / m_step);
+
+	if (steps > m_maxStepsPerFrame)
+	{
+		m_droppedSteps += steps - m_maxStepsPerFrame;
+		steps = m_maxStepsPerFrame;
+		m_accumulator = 0.0;
+	}
+	else
+	{
+		m_accumulator -= steps * (double)m_step;
+	}
+
+	m_tick += steps;
+	return steps;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef __FIXEDTIMESTEP_H__
+#define __FIXEDTIMESTEP_H__
+
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <cstdint>
+
+// Reloj de simulación de paso fijo: acumula el tiempo real de cada cuadro y dice cuántos pasos fijos toca simular.
+// La simulación (enemigos, paño, atmósfera, animaciones) siempre avanza con GetStep(), así se comporta igual a
+// cualquier velocidad de cuadros; el render usa GetAlpha() para interpolar entre el estado anterior y el actual.
+//
+//	unsigned int steps = clock.Advance(frameTime);
+//	for (unsigned int i = 0; i < steps; ++i) { cameraPos.Push(...); Simulate(clock.GetStep()); }
+//	Render(cameraPos.Get(clock.GetAlpha()));
+class FixedTimestep
+{
+public:
+	FixedTimestep();
+	~FixedTimestep();
+
+	void Init(float step, unsigned int maxStepsPerFrame);
+	unsigned int Advance(float frameTime);
+	void Reset();
+
+	float GetStep() { return m_step; }
+	float GetAlpha() { return (float)(m_accumulator / m_step); }
+	uint64_t GetTick() { return m_tick; }
+	unsigned int GetDroppedSteps() { return m_droppedSteps; }
+
+private:
+	float m_step, m_maxFrameTime;
+	double m_accumulator;
+	unsigned int m_maxStepsPerFrame, m_droppedSteps;
+	uint64_t m_tick;
+};
+
+// Guarda el valor de los dos últimos pasos fijos para dibujarlo interpolado
+template <class T>
+class Interpolated
+{
+public:
+	Interpolated() : m_previous(), m_current() {}
+
+	void Reset(const T& value) { m_previous = value; m_current = value; }
+	void Push(const T& value) { m_previous = m_current; m_current = value; }
+	T Get(float alpha) const { return glm::mix(m_previous, m_current, alpha); }
+	const T& GetCurrent() const { return m_current; }
+
+private:
+	T m_previous, m_current;
+};
+
+#endif // !__FIXEDTIMESTEP_H__
@@ -0,0 +1,334 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+FlowField::FlowField() :
+	m_front(0),
+	m_cells(0),
+	m_targetCell(-1),
+	m_requestedCell(-1),
+	m_workingCell(-1),
+	m_cellSize(1.0f),
+	m_invCellSize(1.0f),
+	m_maximumSlope(1.2f),
+	m_slopeCost(4.0f),
+	m_ready(false),
+	m_deterministic(false),
+	m_state(STATE_IDLE),
+	m_stop(false),
+	m_pending(false),
+	m_running(false)
+{}
+
+FlowField::~FlowField()
+{
+	if (m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+
+		m_stop = true;
+		m_condition.notify_all();
+		m_thread.join();
+	}
+}
+
+// -------------------
+// Descripción: Función que construye la rejilla de costes a partir de las alturas y pendientes del terreno e inicia el hilo de cálculo
+// -------------------
+void FlowField::Init(Terrain& terrain, float worldSize, float cellSize)
+{
+	m_cellSize = cellSize;
+	m_invCellSize = 1.0f / cellSize;
+	m_cells = (int)std::ceil(worldSize * m_invCellSize);
+
+	m_cost.resize(m_cells * m_cells);
+
+	for (int z = 0; z < m_cells; ++z)
+	{
+		for (int x = 0; x < m_cells; ++x)
+		{
+			float centerX = (x + 0.5f) * cellSize;
+			float centerZ = (z + 0.5f) * cellSize;
+			float half = cellSize * 0.5f;
+
+			// Pendiente como desnivel entre los bordes opuestos de la celda dividido por su ancho
+			float slopeX = std::fabs(terrain.GetHeightOfTerrain(centerX + half, centerZ) - terrain.GetHeightOfTerrain(centerX - half, centerZ)) * m_invCellSize;
+			float slopeZ = std::fabs(terrain.GetHeightOfTerrain(centerX, centerZ + half) - terrain.GetHeightOfTerrain(centerX, centerZ - half)) * m_invCellSize;
+			float slope = std::max(slopeX, slopeZ);
+
+			m_cost[z * m_cells + x] = slope > m_maximumSlope ? FLT_MAX : 1.0f + m_slopeCost * slope;
+		}
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		m_fields[i].m_distance.assign(m_cost.size(), FLT_MAX);
+		m_fields[i].m_direction.assign(m_cost.size(), glm::vec2(0.0f, 0.0f));
+	}
+
+	if (!m_thread.joinable())
+	{
+		m_running = true;
+		m_thread = std::thread(&FlowField::WorkerLoop, this);
+	}
+}
+
+// -------------------
+// Descripción: Función que se llama una vez por cuadro desde el hilo principal. Publica el último campo terminado
+// y, si el jugador ha cambiado de celda, pide un nuevo cálculo. El que esté en curso no se cancela (un jugador que no
+// para de moverse dejaría el campo sin publicar nunca): la petición sustituye a la que estuviera en cola.
+// -------------------
+void FlowField::Update(const glm::vec3& targetPos)
+{
+	if (m_cells == 0)
+		return;
+
+	int cell = CellIndex(targetPos.x, targetPos.z);
+
+	if (m_deterministic)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (cell != m_requestedCell)
+		{
+			m_requestedCell = cell;
+			m_pending = true;
+		}
+
+		// Terminar y publicar todo lo pedido antes de volver (también un cálculo que empezó antes del modo determinista)
+		while (m_running && (m_pending || m_state == STATE_WORKING))
+		{
+			if (m_state == STATE_DONE)
+				Publish();
+
+			m_condition.notify_all();
+			m_condition.wait(lock, [this]() { return !m_running || m_state == STATE_DONE || (m_state == STATE_IDLE && !m_pending); });
+		}
+
+		if (m_state == STATE_DONE)
+			Publish();
+
+		return;
+	}
+
+	if (m_state == STATE_DONE)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Publish();
+	}
+
+	if (cell != m_requestedCell)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_requestedCell = cell;
+		m_pending = true;
+		m_condition.notify_one();
+	}
+}
+
+// -------------------
+// Descripción: Función que devuelve la dirección de movimiento (plano XZ) hacia el objetivo desde una posición, en O(1)
+// -------------------
+glm::vec2 FlowField::GetDirection(float x, float z) const
+{
+	if (!m_ready)
+		return glm::vec2(0.0f, 0.0f);
+
+	return m_fields[m_front].m_direction[CellIndex(x, z)];
+}
+
+float FlowField::GetDistance(float x, float z) const
+{
+	if (!m_ready)
+		return FLT_MAX;
+
+	return m_fields[m_front].m_distance[CellIndex(x, z)];
+}
+
+// -------------------
+// Descripción: Función que intercambia los búferes para publicar el campo terminado (con el mutex tomado). El hilo de
+// cálculo está parado mientras el estado es DONE, así que el intercambio es seguro.
+// -------------------
+void FlowField::Publish()
+{
+	m_front = 1 - m_front;
+	m_targetCell = m_workingCell;
+	m_ready = true;
+	m_state = STATE_IDLE;
+
+	// Si el jugador cambió de celda mientras se terminaba este campo, el hilo puede empezar el siguiente
+	if (m_pending)
+		m_condition.notify_one();
+}
+
+int FlowField::CellIndex(float x, float z) const
+{
+	int cellX = std::min(std::max((int)std::floor(x * m_invCellSize), 0), m_cells - 1);
+	int cellZ = std::min(std::max((int)std::floor(z * m_invCellSize), 0), m_cells - 1);
+	return cellZ * m_cells + cellX;
+}
+
+void FlowField::WorkerLoop()
+{
+	while (true)
+	{
+		int targetCell, previousCell;
+		Field* field;
+		const Field* previous;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return !m_running || (m_pending && m_state != STATE_DONE); });
+
+			if (!m_running)
+				return;
+
+			targetCell = m_requestedCell;
+			field = &m_fields[1 - m_front];
+
+			// El campo publicado no cambia mientras se trabaja (solo se intercambia en DONE): se puede leer sin el mutex
+			previous = m_ready ? &m_fields[m_front] : nullptr;
+			previousCell = m_targetCell;
+			m_pending = false;
+			m_state = STATE_WORKING;
+		}
+
+		if (Integrate(*field, targetCell, previous, previousCell))
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_workingCell = targetCell;
+				m_state = STATE_DONE;
+			}
+
+			// En modo determinista el hilo principal espera este aviso
+			m_condition.notify_all();
+		}
+		else
+		{
+			// Solo se interrumpe al cerrar
+			return;
+		}
+	}
+}
+
+// -------------------
+// Descripción: Función que integra las distancias desde la celda objetivo (Dijkstra con 8 vecinos) y guarda para cada
+// celda la dirección hacia el vecino con menor distancia acumulada. Con un campo anterior (objetivo en A, nuevo en B)
+// cada celda empieza con d(x) + d(B), la longitud del camino x -> A -> B, que es una cota superior válida porque los
+// costes de paso son simétricos. Dijkstra desde B solo mejora y expande las celdas que tienen un camino más corto que
+// pasar por A; las de detrás del objetivo (una cuarta parte del mapa cuando el jugador avanza una celda) no se tocan. Si A o B
+// están bloqueadas, o B no se alcanzaba desde A, la cota no vale y se integra desde cero.
+// -------------------
+bool FlowField::Integrate(Field& field, int targetCell, const Field* previous, int previousCell)
+{
+	const int offsetX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	const int offsetZ[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	const float stepLength[8] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+	typedef std::pair<float, int> Node;
+	std::priority_queue<Node, std::vector<Node>, std::greater<Node> > open;
+
+	bool incremental = previous != nullptr && previousCell >= 0 && m_cost[previousCell] != FLT_MAX &&
+		m_cost[targetCell] != FLT_MAX && previous->m_distance[targetCell] != FLT_MAX;
+
+	if (incremental)
+	{
+		float moved = previous->m_distance[targetCell];
+
+		for (size_t i = 0; i < field.m_distance.size(); ++i)
+			field.m_distance[i] = previous->m_distance[i] == FLT_MAX ? FLT_MAX : previous->m_distance[i] + moved;
+	}
+	else
+		std::fill(field.m_distance.begin(), field.m_distance.end(), FLT_MAX);
+
+	field.m_distance[targetCell] = 0.0f;
+	open.push(Node(0.0f, targetCell));
+
+	unsigned int iterations = 0;
+
+	while (!open.empty())
+	{
+		// Comprobar de vez en cuando si hay que cerrar el hilo
+		if ((++iterations & 1023) == 0 && m_stop)
+			return false;
+
+		Node node = open.top();
+		open.pop();
+
+		if (node.first > field.m_distance[node.second])
+			continue;
+
+		int cellX = node.second % m_cells;
+		int cellZ = node.second / m_cells;
+
+		for (int n = 0; n < 8; ++n)
+		{
+			int x = cellX + offsetX[n];
+			int z = cellZ + offsetZ[n];
+
+			if (x < 0 || z < 0 || x >= m_cells || z >= m_cells)
+				continue;
+
+			int neighbour = z * m_cells + x;
+
+			if (m_cost[neighbour] == FLT_MAX)
+				continue;
+
+			// Las diagonales no pueden cortar por la esquina de una celda bloqueada
+			if (n >= 4 && (m_cost[cellZ * m_cells + x] == FLT_MAX || m_cost[z * m_cells + cellX] == FLT_MAX))
+				continue;
+
+			float sourceCost = m_cost[node.second] == FLT_MAX ? m_cost[neighbour] : m_cost[node.second];
+			float distance = node.first + 0.5f * (sourceCost + m_cost[neighbour]) * stepLength[n] * m_cellSize;
+
+			if (distance < field.m_distance[neighbour])
+			{
+				field.m_distance[neighbour] = distance;
+				open.push(Node(distance, neighbour));
+			}
+		}
+	}
+
+	// Cada celda apunta hacia el vecino más cercano al objetivo (las celdas bloqueadas también, para poder salir de ellas)
+	for (int cellZ = 0; cellZ < m_cells; ++cellZ)
+	{
+		if (m_stop)
+			return false;
+
+		for (int cellX = 0; cellX < m_cells; ++cellX)
+		{
+			int cell = cellZ * m_cells + cellX;
+			float best = field.m_distance[cell];
+			glm::vec2 direction(0.0f, 0.0f);
+
+			for (int n = 0; n < 8; ++n)
+			{
+				int x = cellX + offsetX[n];
+				int z = cellZ + offsetZ[n];
+
+				if (x < 0 || z < 0 || x >= m_cells || z >= m_cells)
+					continue;
+
+				float distance = field.m_distance[z * m_cells + x];
+
+				if (distance < best)
+				{
+					best = distance;
+					direction = glm::vec2((float)offsetX[n], (float)offsetZ[n]) / stepLength[n];
+				}
+			}
+
+			field.m_direction[cell] = direction;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef __FLOWFIELD_H__
+#define __FLOWFIELD_H__
+
+#include "Terrain.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Campo de flujo compartido por todos los enemigos: el coste de cada celda depende de la pendiente del terreno,
+// la integración (Dijkstra sobre 8 vecinos) hacia el jugador se calcula en un hilo aparte y cada agente
+// solo tiene que leer la dirección de su celda. La integración es incremental: parte del campo publicado y solo
+// expande las celdas cuya distancia mejora con el nuevo objetivo. Un cálculo empezado siempre termina y se publica;
+// si el jugador cambia de celda mientras tanto, solo queda en cola la última celda pedida. En modo determinista (repeticiones)
+// Update espera a que el cálculo pedido termine y lo publica en el mismo paso, así el campo que leen los agentes
+// solo depende de las celdas pedidas y no de lo que tarde el hilo.
+class FlowField
+{
+public:
+	FlowField();
+	~FlowField();
+
+	void Init(Terrain& terrain, float worldSize, float cellSize);
+	void Update(const glm::vec3& targetPos);
+
+	glm::vec2 GetDirection(float x, float z) const;
+	float GetDistance(float x, float z) const;
+	bool IsReady() const { return m_ready; }
+	void SetDeterministic(bool deterministic) { m_deterministic = deterministic; }
+
+private:
+	struct Field
+	{
+		std::vector<float> m_distance;
+		std::vector<glm::vec2> m_direction;
+	};
+
+	enum { STATE_IDLE, STATE_WORKING, STATE_DONE };
+
+	// Coste de atravesar cada celda (FLT_MAX si la pendiente no es transitable)
+	std::vector<float> m_cost;
+	Field m_fields[2];
+	unsigned int m_front;
+
+	int m_cells, m_targetCell, m_requestedCell, m_workingCell;
+	float m_cellSize, m_invCellSize;
+	float m_maximumSlope, m_slopeCost;
+	bool m_ready, m_deterministic;
+
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::atomic<int> m_state;
+	std::atomic<bool> m_stop;
+	bool m_pending, m_running;
+
+	// Private functions
+	int CellIndex(float x, float z) const;
+	void Publish();
+	void WorkerLoop();
+	bool Integrate(Field& field, int targetCell, const Field* previous, int previousCell);
+};
+
+#endif // !__FLOWFIELD_H__
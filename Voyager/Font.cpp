@@ -1,4 +1,5 @@
 #include "Font.h"
+#include "GLState.h"
 
 void Text::Configure(std::string font)
 {
@@ -21,14 +22,13 @@ void Text::Configure(std::string font)
 	SetPosition(m_position);
 
 	// Sombreador de texto Craete
-	Shader shaderText;
-	m_shaderProgram = shaderText.CreateProgram("res/Shaders/Font/Text.vs", "res/Shaders/Font/Text.fs");
+	m_shader.CreateProgram("res/Shaders/Font/Text.vs", "res/Shaders/Font/Text.fs");
 
 	// Proyeccin ortogrfica
 	glm::mat4 projection = glm::ortho(0.0f, 1440.0f, 0.0f, 900.0f);
 
-	glUseProgram(m_shaderProgram);
-	glUniformMatrix4fv(glGetUniformLocation(m_shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+	m_shader.ActivateProgram();
+	m_shader.SetMat4("projection", projection);
 
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
@@ -45,7 +45,7 @@ void Text::Configure(std::string font)
 		// Genere y configure parmetros de textura para cada glifo de carcter
 		GLuint texture;
 		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
+		GLState::GetInstance().BindTexture(GL_TEXTURE_2D, texture);
 
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0,
 			GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
@@ -67,7 +67,7 @@ void Text::Configure(std::string font)
 		m_characters.insert(std::pair<GLchar, Character>(i, character));
 	}
 
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
 
 	// Destruir FreeType
 	FT_Done_Face(face);
@@ -77,18 +77,18 @@ void Text::Configure(std::string font)
 	glGenVertexArrays(1, &m_vao);
 	glGenBuffers(1, &m_vbo);
 
-	glBindVertexArray(m_vao);
+	GLState::GetInstance().BindVertexArray(m_vao);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
 	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::GetInstance().BindVertexArray(0);
 
-	glUseProgram(0);
+	GLState::GetInstance().UseProgram(0);
 }
 
 void Text::Render()
@@ -96,14 +96,15 @@ void Text::Render()
 	glm::vec2 textPos = m_position;
 
 	// Emezcla alfa nable
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::GetInstance().Enable(GL_BLEND);
+	GLState::GetInstance().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Habilite el programa de sombreado de texto, textura y enlace vao
-	glUseProgram(m_shaderProgram);
-	glUniform3f(glGetUniformLocation(m_shaderProgram, "textColor"), m_color.x, m_color.y, m_color.z);
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(m_vao);
+	m_shader.ActivateProgram();
+	m_shader.SetVec3("textColor", m_color);
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE0);
+	GLState::GetInstance().BindVertexArray(m_vao);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
 	// Bucle a travs de todos los personajes
 	for (auto i = m_text.begin(); i != m_text.end(); ++i)
@@ -129,21 +130,14 @@ void Text::Render()
 		};
 
 		// Renderizar textura de glifo en el quad
-		glBindTexture(GL_TEXTURE_2D, c.m_textureID);
+		GLState::GetInstance().BindTexture(GL_TEXTURE_2D, c.m_textureID);
 
-		// Actualice el contenido de la memoria VBO y dibuje quad
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		// Actualice el contenido de la memoria VBO (enlazado una vez antes del bucle) y dibuje quad
 		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		GLState::GetInstance().DrawArrays(GL_TRIANGLES, 0, 6);
 
 		// Avance para el glifo del carcter
 		textPos.x += (c.m_advance >> 6) * m_spacing;
-
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
-
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glUseProgram(0);
 }
\ No newline at end of file
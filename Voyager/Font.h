@@ -37,7 +37,7 @@ public:
 private:
 	std::map<GLchar, Character> m_characters;
 	GLuint m_vao, m_vbo;
-	GLuint m_shaderProgram;
+	Shader m_shader;
 	std::string m_text;
 	GLfloat m_scale, m_spacing;
 	glm::vec3 m_color;
@@ -1,4 +1,5 @@
 #include "Framebuffer.h"
+#include "GLState.h"
 #include "Renderer.h"
 
 Framebuffer::Framebuffer()
@@ -8,6 +9,7 @@ Framebuffer::~Framebuffer()
 {
 	glDeleteFramebuffers(1, &m_fbo);
 	glDeleteFramebuffers(1, &m_shadowFbo);
+	GLState::GetInstance().DeleteTextures(1, &m_sceneDepthTexture);
 }
 
 void Framebuffer::CreateFramebuffer()
@@ -18,19 +20,23 @@ void Framebuffer::CreateFramebuffer()
 
 	// Cree una nueva textura vaca que se renderizar para luego adjuntarla al framebuffer
 	glGenTextures(1, &m_texture);
-	glBindTexture(GL_TEXTURE_2D, m_texture);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_texture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, Renderer::GetInstance().GetWindowWidth(), Renderer::GetInstance().GetWindowHeight(), 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
 
-	// Cree un bfer de procesamiento para adjuntarle datos de plantilla y profundidad
-	glGenRenderbuffers(1, &m_rbo);
-	glBindRenderbuffer(GL_RENDERBUFFER, m_rbo);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Renderer::GetInstance().GetWindowWidth(), Renderer::GetInstance().GetWindowHeight());
-	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_rbo);
-	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	// Cree una textura de profundidad y plantilla (muestreable, la usan las partculas de baja resolucin para el reescalado bilateral)
+	glGenTextures(1, &m_sceneDepthTexture);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_sceneDepthTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, Renderer::GetInstance().GetWindowWidth(), Renderer::GetInstance().GetWindowHeight(), 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_sceneDepthTexture, 0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
 
 	// Asegrese de que el bfer de cuadros est completo y listo para usarse
 	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
@@ -47,7 +53,7 @@ void Framebuffer::CreateShadowFramebuffer()
 
 	// Cree una nueva textura vaca que almacenar datos de profundidad para el clculo de sombras
 	glGenTextures(1, &m_depthTexture);
-	glBindTexture(GL_TEXTURE_2D, m_depthTexture);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_depthTexture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16, 1024, 1024, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -56,7 +62,7 @@ void Framebuffer::CreateShadowFramebuffer()
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
 	glDrawBuffer(GL_NONE);
 	glReadBuffer(GL_NONE);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
 
 	// Asegrese de que el bfer de cuadros est completo y listo para usarse
 	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
@@ -17,12 +17,14 @@ public:
 	void ActivateFramebuffer() { glBindFramebuffer(GL_FRAMEBUFFER, m_fbo); }
 	void DeactivateFramebuffer() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
 
+	GLuint GetFramebufferId() { return m_fbo; }
 	GLuint GetColorBufferTexture() { return m_texture; }
 	GLuint GetDepthBufferTexture() { return m_depthTexture; }
+	GLuint GetSceneDepthTexture() { return m_sceneDepthTexture; }
 
 private:
 	GLuint m_fbo, m_rbo, m_shadowFbo;
-	GLuint m_texture, m_depthTexture;
+	GLuint m_texture, m_depthTexture, m_sceneDepthTexture;
 };
 
 #endif // !__FRAMEBUFFER_H__
\ No newline at end of file
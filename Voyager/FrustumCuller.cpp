@@ -0,0 +1,453 @@
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+#include "OcclusionCuller.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+// -------------------
+// Descripción: Función que prueba cuatro esferas contra los planos y devuelve una máscara de 4 bits (1 = visible).
+// Una esfera queda fuera si está entera detrás de algún plano (distancia con signo menor que -radio).
+// -------------------
+static unsigned int Spheres4(const glm::vec4* planes, const float* centerX, const float* centerY, const float* centerZ, const float* radius)
+{
+#if defined(CULLING_SSE)
+	__m128 x = _mm_loadu_ps(centerX);
+	__m128 y = _mm_loadu_ps(centerY);
+	__m128 z = _mm_loadu_ps(centerZ);
+	__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius));
+	__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+	for (unsigned int p = 0; p < FrustumCuller::TOTAL_PLANES; ++p)
+	{
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes[p].x)), _mm_mul_ps(y, _mm_set1_ps(planes[p].y))),
+			_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(planes[p].z)), _mm_set1_ps(planes[p].w)));
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+	}
+
+	return (unsigned int)_mm_movemask_ps(inside);
+#else
+	unsigned int mask = 0;
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		bool inside = true;
+
+		for (unsigned int p = 0; p < FrustumCuller::TOTAL_PLANES && inside; ++p)
+			inside = planes[p].x * centerX[i] + planes[p].y * centerY[i] + planes[p].z * centerZ[i] + planes[p].w >= -radius[i];
+
+		mask |= (inside ? 1u : 0u) << i;
+	}
+
+	return mask;
+#endif
+}
+
+// -------------------
+// Descripción: Función que prueba cuatro cajas (centro y semiextensión) contra los planos. La caja queda fuera si
+// su esquina más adelantada respecto a la normal del plano sigue detrás: distancia del centro + |n|·extensión < 0.
+// -------------------
+static unsigned int Boxes4(const glm::vec4* planes, const float* centerX, const float* centerY, const float* centerZ,
+	const float* extentX, const float* extentY, const float* extentZ)
+{
+#if defined(CULLING_SSE)
+	__m128 cx = _mm_loadu_ps(centerX), cy = _mm_loadu_ps(centerY), cz = _mm_loadu_ps(centerZ);
+	__m128 ex = _mm_loadu_ps(extentX), ey = _mm_loadu_ps(extentY), ez = _mm_loadu_ps(extentZ);
+	__m128 zero = _mm_setzero_ps();
+	__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+	for (unsigned int p = 0; p < FrustumCuller::TOTAL_PLANES; ++p)
+	{
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(planes[p].x)), _mm_mul_ps(cy, _mm_set1_ps(planes[p].y))),
+			_mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(planes[p].z)), _mm_set1_ps(planes[p].w)));
+		__m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(std::abs(planes[p].x))), _mm_mul_ps(ey, _mm_set1_ps(std::abs(planes[p].y)))),
+			_mm_mul_ps(ez, _mm_set1_ps(std::abs(planes[p].z))));
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), zero));
+	}
+
+	return (unsigned int)_mm_movemask_ps(inside);
+#else
+	unsigned int mask = 0;
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		bool inside = true;
+
+		for (unsigned int p = 0; p < FrustumCuller::TOTAL_PLANES && inside; ++p)
+		{
+			float distance = planes[p].x * centerX[i] + planes[p].y * centerY[i] + planes[p].z * centerZ[i] + planes[p].w;
+			float reach = std::abs(planes[p].x) * extentX[i] + std::abs(planes[p].y) * extentY[i] + std::abs(planes[p].z) * extentZ[i];
+			inside = distance + reach >= 0.0f;
+		}
+
+		mask |= (inside ? 1u : 0u) << i;
+	}
+
+	return mask;
+#endif
+}
+
+CullInstanceSet::CullInstanceSet() :
+	m_source(nullptr),
+	m_visible(nullptr),
+	m_totalVisible(0)
+{}
+
+// Las esferas se guardan redondeadas a múltiplos de cuatro; el relleno nunca se cuenta como visible
+void CullInstanceSet::Resize(unsigned int count)
+{
+	unsigned int padded = (count + 3) & ~3u;
+	m_centerX.assign(padded, 0.0f);
+	m_centerY.assign(padded, 0.0f);
+	m_centerZ.assign(padded, 0.0f);
+	m_radius.assign(padded, 0.0f);
+	m_visibleIndices.resize(count);
+}
+
+void CullInstanceSet::SetSphere(unsigned int index, const glm::vec3& center, float radius)
+{
+	m_centerX[index] = center.x;
+	m_centerY[index] = center.y;
+	m_centerZ[index] = center.z;
+	m_radius[index] = radius;
+}
+
+FrustumCuller::FrustumCuller() :
+	m_totalObjects(0)
+{
+	std::memset(&m_stats, 0, sizeof(m_stats));
+
+	for (unsigned int p = 0; p < TOTAL_PLANES; ++p)
+		m_planes[p] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+FrustumCuller::~FrustumCuller()
+{}
+
+// -------------------
+// Descripción: Función que saca los planos del frustum de la matriz vista-proyección (Gribb y Hartmann).
+// Las normales apuntan hacia dentro y quedan normalizadas, así la distancia se puede comparar con radios.
+// -------------------
+void FrustumCuller::ExtractPlanes(const glm::mat4& viewProjection, glm::vec4 planes[TOTAL_PLANES])
+{
+	glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	planes[PLANE_LEFT] = row3 + row0;
+	planes[PLANE_RIGHT] = row3 - row0;
+	planes[PLANE_BOTTOM] = row3 + row1;
+	planes[PLANE_TOP] = row3 - row1;
+	planes[PLANE_NEAR] = row3 + row2;
+	planes[PLANE_FAR] = row3 - row2;
+
+	for (unsigned int p = 0; p < TOTAL_PLANES; ++p)
+		planes[p] /= glm::length(glm::vec3(planes[p]));
+}
+
+void FrustumCuller::BeginFrame(Camera& cam)
+{
+	BeginFrame(cam.GetProjectionMatrix() * cam.GetViewMatrix());
+}
+
+void FrustumCuller::BeginFrame(const glm::mat4& viewProjection)
+{
+	ExtractPlanes(viewProjection, m_planes);
+	std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+unsigned int FrustumCuller::AddObject(const AABB& bounds)
+{
+	unsigned int index = m_totalObjects++;
+	unsigned int words = (m_totalObjects + 63) / 64;
+
+	// Relleno hasta la palabra completa: cajas vacías en el origen, sus bits se descartan en TestObjectWord
+	if (m_centerX.size() < words * 64)
+	{
+		unsigned int padded = words * 64;
+		m_centerX.resize(padded, 0.0f);
+		m_centerY.resize(padded, 0.0f);
+		m_centerZ.resize(padded, 0.0f);
+		m_extentX.resize(padded, 0.0f);
+		m_extentY.resize(padded, 0.0f);
+		m_extentZ.resize(padded, 0.0f);
+		m_visibility.resize(words, 0);
+	}
+
+	SetObject(index, bounds);
+	return index;
+}
+
+void FrustumCuller::SetObject(unsigned int index, const AABB& bounds)
+{
+	glm::vec3 center = (bounds.m_min + bounds.m_max) * 0.5f;
+	glm::vec3 extent = (bounds.m_max - bounds.m_min) * 0.5f;
+
+	m_centerX[index] = center.x;
+	m_centerY[index] = center.y;
+	m_centerZ[index] = center.z;
+	m_extentX[index] = extent.x;
+	m_extentY[index] = extent.y;
+	m_extentZ[index] = extent.z;
+}
+
+void FrustumCuller::ClearObjects()
+{
+	m_totalObjects = 0;
+	m_centerX.clear();
+	m_centerY.clear();
+	m_centerZ.clear();
+	m_extentX.clear();
+	m_extentY.clear();
+	m_extentZ.clear();
+	m_visibility.clear();
+}
+
+// -------------------
+// Descripción: Función que recorta todos los objetos sueltos. Cada lote escribe palabras enteras del bitset, así los
+// hilos nunca comparten una palabra.
+// -------------------
+void FrustumCuller::CullObjects()
+{
+	unsigned int words = (unsigned int)m_visibility.size();
+
+	JobSystem::GetInstance().ParallelFor(words, OBJECT_BATCH_WORDS, [this](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int word = begin; word < end; ++word)
+			m_visibility[word] = TestObjectWord(word);
+	});
+
+	unsigned int visible = 0;
+
+	for (unsigned int word = 0; word < words; ++word)
+	{
+		for (uint64_t bits = m_visibility[word]; bits != 0; bits &= bits - 1)
+			++visible;
+	}
+
+	m_stats.m_objectsTested += m_totalObjects;
+	m_stats.m_objectsVisible += visible;
+}
+
+// -------------------
+// Descripción: Función que apaga en el bitset los objetos visibles que el búfer de profundidad del OcclusionCuller da
+// por tapados. Va después de CullObjects y de OcclusionCuller::RenderOccluders, con el mismo reparto por palabras.
+// -------------------
+void FrustumCuller::ApplyOcclusion(const OcclusionCuller& occlusion)
+{
+	unsigned int words = (unsigned int)m_visibility.size();
+	std::vector<unsigned int> occluded(words, 0);
+
+	JobSystem::GetInstance().ParallelFor(words, OBJECT_BATCH_WORDS, [this, &occlusion, &occluded](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int word = begin; word < end; ++word)
+		{
+			for (uint64_t bits = m_visibility[word]; bits != 0; bits &= bits - 1)
+			{
+				unsigned int bit = 0;
+
+				while (!((bits >> bit) & 1))
+					++bit;
+
+				unsigned int index = word * 64 + bit;
+				glm::vec3 center(m_centerX[index], m_centerY[index], m_centerZ[index]);
+				glm::vec3 extent(m_extentX[index], m_extentY[index], m_extentZ[index]);
+
+				AABB bounds;
+				bounds.m_min = center - extent;
+				bounds.m_max = center + extent;
+
+				if (occlusion.IsOccluded(bounds))
+				{
+					m_visibility[word] &= ~(1ull << bit);
+					++occluded[word];
+				}
+			}
+		}
+	});
+
+	for (unsigned int word = 0; word < words; ++word)
+	{
+		m_stats.m_objectsVisible -= occluded[word];
+		m_stats.m_objectsOccluded += occluded[word];
+	}
+}
+
+// -------------------
+// Descripción: Función que recorta un conjunto instanciado y llena su búfer compacto. El rango se parte en trozos de
+// tamaño fijo: cada trozo escribe sus índices visibles a partir de su propio inicio, luego una suma de prefijos da el
+// destino de cada trozo y la copia de las instancias también se reparte. El orden de las instancias se conserva.
+// -------------------
+void FrustumCuller::CullInstances(CullInstanceSet& set, const OcclusionCuller* occlusion)
+{
+	if (set.m_source == nullptr || set.m_visible == nullptr)
+	{
+		printf("ERROR: Cull instance set without source or destination buffer\n");
+		return;
+	}
+
+	unsigned int count = std::min(set.m_source->GetCount(), (unsigned int)set.m_visibleIndices.size());
+	unsigned int chunks = (count + INSTANCE_CHUNK_SIZE - 1) / INSTANCE_CHUNK_SIZE;
+	set.m_chunkCounts.resize(chunks + 1);
+
+	JobSystem& jobs = JobSystem::GetInstance();
+
+	std::vector<unsigned int> occluded(chunks, 0);
+
+	jobs.ParallelFor(chunks, 1, [this, &set, &occluded, count, occlusion](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int chunk = begin; chunk < end; ++chunk)
+		{
+			unsigned int first = chunk * INSTANCE_CHUNK_SIZE;
+			unsigned int last = std::min(first + INSTANCE_CHUNK_SIZE, count);
+			set.m_chunkCounts[chunk] = TestSpheres(set, first, last, &set.m_visibleIndices[first], occlusion, occluded[chunk]);
+		}
+	});
+
+	// Suma de prefijos exclusiva: m_chunkCounts[c] pasa a ser el destino del trozo c
+	unsigned int total = 0;
+
+	for (unsigned int chunk = 0; chunk < chunks; ++chunk)
+	{
+		unsigned int visible = set.m_chunkCounts[chunk];
+		set.m_chunkCounts[chunk] = total;
+		total += visible;
+		m_stats.m_instancesOccluded += occluded[chunk];
+	}
+
+	set.m_chunkCounts[chunks] = total;
+	set.m_totalVisible = total;
+	set.m_visible->Resize(total);
+
+	unsigned int stride = set.m_source->GetStride();
+
+	if (total > 0)
+	{
+		jobs.ParallelFor(chunks, 1, [&set, count, stride](unsigned int begin, unsigned int end)
+		{
+			for (unsigned int chunk = begin; chunk < end; ++chunk)
+			{
+				unsigned int first = chunk * INSTANCE_CHUNK_SIZE;
+				unsigned int destination = set.m_chunkCounts[chunk];
+				unsigned int visible = set.m_chunkCounts[chunk + 1] - destination;
+
+				for (unsigned int i = 0; i < visible; ++i)
+					std::memcpy(set.m_visible->GetInstance(destination + i), set.m_source->GetInstance(set.m_visibleIndices[first + i]), stride);
+			}
+		});
+
+		set.m_visible->MarkDirty(0, total);
+	}
+
+	m_stats.m_instancesTested += count;
+	m_stats.m_instancesVisible += total;
+}
+
+bool FrustumCuller::TestSphere(const glm::vec3& center, float radius) const
+{
+	for (unsigned int p = 0; p < TOTAL_PLANES; ++p)
+	{
+		if (glm::dot(glm::vec3(m_planes[p]), center) + m_planes[p].w < -radius)
+			return false;
+	}
+
+	return true;
+}
+
+bool FrustumCuller::TestAABB(const AABB& bounds) const
+{
+	glm::vec3 center = (bounds.m_min + bounds.m_max) * 0.5f;
+	glm::vec3 extent = (bounds.m_max - bounds.m_min) * 0.5f;
+
+	for (unsigned int p = 0; p < TOTAL_PLANES; ++p)
+	{
+		glm::vec3 normal(m_planes[p]);
+
+		if (glm::dot(normal, center) + m_planes[p].w + glm::dot(glm::abs(normal), extent) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+// Publica los contadores del cuadro en el Profiler (se promedian y salen en su informe)
+void FrustumCuller::ReportStats()
+{
+	Profiler& profiler = Profiler::GetInstance();
+	profiler.AddCounter("Cull objects visible", m_stats.m_objectsVisible);
+	profiler.AddCounter("Cull objects culled", m_stats.m_objectsTested - m_stats.m_objectsVisible);
+	profiler.AddCounter("Cull objects occluded", m_stats.m_objectsOccluded);
+	profiler.AddCounter("Cull instances visible", m_stats.m_instancesVisible);
+	profiler.AddCounter("Cull instances culled", m_stats.m_instancesTested - m_stats.m_instancesVisible);
+	profiler.AddCounter("Cull instances occluded", m_stats.m_instancesOccluded);
+}
+
+uint64_t FrustumCuller::TestObjectWord(unsigned int word) const
+{
+	uint64_t bits = 0;
+	unsigned int base = word * 64;
+
+	for (unsigned int i = 0; i < 64; i += 4)
+	{
+		unsigned int index = base + i;
+		uint64_t mask = Boxes4(m_planes, &m_centerX[index], &m_centerY[index], &m_centerZ[index], &m_extentX[index], &m_extentY[index], &m_extentZ[index]);
+		bits |= mask << i;
+	}
+
+	// Descarta el relleno de la última palabra
+	if (base + 64 > m_totalObjects)
+		bits &= (m_totalObjects > base) ? (~0ull >> (64 - (m_totalObjects - base))) : 0ull;
+
+	return bits;
+}
+
+// Escribe en 'visible' los índices de las esferas visibles de [begin, end) y devuelve cuántas hay. Con oclusión, las que
+// pasan el frustum se prueban también con su caja contra el búfer de profundidad.
+unsigned int FrustumCuller::TestSpheres(const CullInstanceSet& set, unsigned int begin, unsigned int end, unsigned int* visible, const OcclusionCuller* occlusion, unsigned int& occluded) const
+{
+	unsigned int total = 0;
+
+	for (unsigned int i = begin; i < end; i += 4)
+	{
+		unsigned int mask = Spheres4(m_planes, &set.m_centerX[i], &set.m_centerY[i], &set.m_centerZ[i], &set.m_radius[i]);
+
+		if (end - i < 4)
+			mask &= (1u << (end - i)) - 1;
+
+		for (; mask != 0; mask &= mask - 1)
+		{
+			unsigned int lane = 0;
+
+			while (!(mask & (1u << lane)))
+				++lane;
+
+			unsigned int index = i + lane;
+
+			if (occlusion != nullptr)
+			{
+				glm::vec3 center(set.m_centerX[index], set.m_centerY[index], set.m_centerZ[index]);
+				AABB bounds;
+				bounds.m_min = center - glm::vec3(set.m_radius[index]);
+				bounds.m_max = center + glm::vec3(set.m_radius[index]);
+
+				if (occlusion->IsOccluded(bounds))
+				{
+					++occluded;
+					continue;
+				}
+			}
+
+			visible[total++] = index;
+		}
+	}
+
+	return total;
+}
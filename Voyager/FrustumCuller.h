@@ -0,0 +1,93 @@
+#pragma once
+#ifndef __FRUSTUMCULLER_H__
+#define __FRUSTUMCULLER_H__
+
+#include "Camera.h"
+#include "DynamicAABBTree.h"
+#include "InstanceBuffer.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <cstdint>
+#include <vector>
+
+class OcclusionCuller;
+
+// Conjunto de instancias que se recorta contra el frustum: una esfera por instancia (SoA, para probar de cuatro en
+// cuatro) y el búfer con todas las instancias. Las visibles se copian, en el mismo orden, al búfer compacto que es el
+// que está enganchado al modelo, así el dibujo y el trabajo de vértices solo pagan por lo que sale en pantalla.
+struct CullInstanceSet
+{
+	CullInstanceSet();
+
+	void Resize(unsigned int count);
+	void SetSphere(unsigned int index, const glm::vec3& center, float radius);
+
+	InstanceBuffer* m_source;		// Todas las instancias (solo se lee su copia en la CPU)
+	InstanceBuffer* m_visible;		// Destino compacto: mismo formato que m_source
+	std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+
+	// Índices de las instancias visibles tras Cull (rellenado por trozos, ver FrustumCuller::CullInstances)
+	std::vector<unsigned int> m_visibleIndices;
+	std::vector<unsigned int> m_chunkCounts;
+	unsigned int m_totalVisible;
+};
+
+// Recorte por frustum en la CPU. BeginFrame saca los seis planos de la cámara una vez por cuadro; después los objetos
+// sueltos (cajas en espacio del mundo) dejan su resultado en un bitset y los conjuntos instanciados en un búfer de
+// instancias compacto. Las pruebas van de cuatro en cuatro con SSE y los lotes se reparten en el JobSystem.
+// Con un OcclusionCuller ya dibujado, lo que pasa el frustum se prueba además contra su búfer de profundidad.
+class FrustumCuller
+{
+public:
+	enum { PLANE_LEFT, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, TOTAL_PLANES };
+
+	struct Stats
+	{
+		unsigned int m_objectsTested, m_objectsVisible, m_objectsOccluded;
+		unsigned int m_instancesTested, m_instancesVisible, m_instancesOccluded;
+	};
+
+	FrustumCuller();
+	~FrustumCuller();
+
+	static void ExtractPlanes(const glm::mat4& viewProjection, glm::vec4 planes[TOTAL_PLANES]);
+
+	void BeginFrame(Camera& cam);
+	void BeginFrame(const glm::mat4& viewProjection);
+
+	// Objetos sueltos: un índice fijo por objeto, su caja se actualiza cuando se mueve
+	unsigned int AddObject(const AABB& bounds);
+	void SetObject(unsigned int index, const AABB& bounds);
+	void ClearObjects();
+	void CullObjects();
+	void ApplyOcclusion(const OcclusionCuller& occlusion);
+	bool IsVisible(unsigned int index) const { return (m_visibility[index >> 6] >> (index & 63)) & 1; }
+	const std::vector<uint64_t>& GetVisibility() const { return m_visibility; }
+
+	void CullInstances(CullInstanceSet& set, const OcclusionCuller* occlusion = nullptr);
+
+	bool TestSphere(const glm::vec3& center, float radius) const;
+	bool TestAABB(const AABB& bounds) const;
+
+	const glm::vec4* GetPlanes() const { return m_planes; }
+	const Stats& GetStats() const { return m_stats; }
+	void ReportStats();
+
+private:
+	enum { OBJECT_BATCH_WORDS = 16, INSTANCE_CHUNK_SIZE = 1024 };
+
+	glm::vec4 m_planes[TOTAL_PLANES];
+	Stats m_stats;
+
+	// Cajas de los objetos como centro y semiextensión (SoA)
+	std::vector<float> m_centerX, m_centerY, m_centerZ;
+	std::vector<float> m_extentX, m_extentY, m_extentZ;
+	std::vector<uint64_t> m_visibility;
+	unsigned int m_totalObjects;
+
+	// Private functions
+	uint64_t TestObjectWord(unsigned int word) const;
+	unsigned int TestSpheres(const CullInstanceSet& set, unsigned int begin, unsigned int end, unsigned int* visible, const OcclusionCuller* occlusion,
+		unsigned int& occluded) const;
+};
+
+#endif // !__FRUSTUMCULLER_H__
\ No newline at end of file
@@ -0,0 +1,560 @@
+#include "GLState.h"
+#include <cstdio>
+#include <cstring>
+
+static const GLuint UNKNOWN = ~0u;
+
+GLState::GLState()
+{
+	std::memset(&m_frame, 0, sizeof(m_frame));
+	std::memset(&m_lastFrame, 0, sizeof(m_lastFrame));
+	Invalidate();
+}
+
+GLState::~GLState()
+{}
+
+// -------------------
+// Descripción: Función que olvida todo el estado guardado; el siguiente enlace de cada tipo llegará a OpenGL
+// -------------------
+void GLState::Invalidate()
+{
+	m_program = UNKNOWN;
+	m_vao = UNKNOWN;
+	m_activeUnit = UNKNOWN;
+	m_depthFunc = UNKNOWN;
+	m_depthMask = -1;
+
+	for (int slot = 0; slot < TOTAL_TEXTURE_SLOTS; ++slot)
+	{
+		for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+			m_textures[slot][unit] = UNKNOWN;
+	}
+
+	for (int slot = 0; slot < TOTAL_BUFFER_SLOTS; ++slot)
+		m_buffers[slot] = UNKNOWN;
+
+	for (int i = 0; i < TOTAL_CAPABILITIES; ++i)
+		m_capabilities[i] = -1;
+
+	for (int i = 0; i < 4; ++i)
+		m_blend[i] = UNKNOWN;
+
+	m_samplerLayouts.clear();
+}
+
+// -------------------
+// Descripción: Función que consulta el estado real y lo compara con el espejo (solo para depurar: glGet* detiene la
+// tubería). Imprime cada diferencia y devuelve false si hay alguna.
+// -------------------
+bool GLState::Validate()
+{
+	bool valid = true;
+	GLint value = 0;
+
+	auto check = [&valid](const char* name, GLuint mirrored, GLint actual)
+	{
+		if (mirrored != UNKNOWN && mirrored != (GLuint)actual)
+		{
+			printf("ERROR: GLState mismatch on %s (cached %u, bound %d)\n", name, mirrored, actual);
+			valid = false;
+		}
+	};
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &value);
+	check("program", m_program, value);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value);
+	check("vertex array", m_vao, value);
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &value);
+	check("array buffer", m_buffers[SLOT_ARRAY], value);
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &value);
+	check("element array buffer", m_buffers[SLOT_ELEMENT_ARRAY], value);
+	glGetIntegerv(GL_UNIFORM_BUFFER_BINDING, &value);
+	check("uniform buffer", m_buffers[SLOT_UNIFORM], value);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_BINDING, &value);
+	check("shader storage buffer", m_buffers[SLOT_SHADER_STORAGE], value);
+	glGetIntegerv(GL_DRAW_INDIRECT_BUFFER_BINDING, &value);
+	check("draw indirect buffer", m_buffers[SLOT_DRAW_INDIRECT], value);
+
+	GLint activeUnit = 0;
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &activeUnit);
+	check("active texture", m_activeUnit, activeUnit);
+
+	for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+	{
+		if (m_textures[SLOT_TEXTURE_2D][unit] == UNKNOWN && m_textures[SLOT_TEXTURE_CUBE_MAP][unit] == UNKNOWN)
+			continue;
+
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &value);
+		check("texture 2D", m_textures[SLOT_TEXTURE_2D][unit], value);
+		glGetIntegerv(GL_TEXTURE_BINDING_CUBE_MAP, &value);
+		check("cube map", m_textures[SLOT_TEXTURE_CUBE_MAP][unit], value);
+	}
+
+	glActiveTexture((GLenum)activeUnit);
+
+	const GLenum capabilities[TOTAL_CAPABILITIES] = { GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE };
+
+	for (int i = 0; i < TOTAL_CAPABILITIES; ++i)
+	{
+		if (m_capabilities[i] >= 0 && m_capabilities[i] != (int)glIsEnabled(capabilities[i]))
+		{
+			printf("ERROR: GLState mismatch on capability 0x%04X\n", capabilities[i]);
+			valid = false;
+		}
+	}
+
+	const GLenum blend[4] = { GL_BLEND_SRC_RGB, GL_BLEND_DST_RGB, GL_BLEND_SRC_ALPHA, GL_BLEND_DST_ALPHA };
+
+	for (int i = 0; i < 4; ++i)
+	{
+		glGetIntegerv(blend[i], &value);
+		check("blend function", m_blend[i], value);
+	}
+
+	glGetIntegerv(GL_DEPTH_FUNC, &value);
+	check("depth function", m_depthFunc, value);
+
+	GLboolean depthMask = GL_TRUE;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+
+	if (m_depthMask >= 0)
+		check("depth mask", (GLuint)m_depthMask, depthMask);
+
+	return valid;
+}
+
+// -------------------
+// Descripción: Función que cierra el cuadro: guarda sus contadores como los del último cuadro y los pone a cero
+// -------------------
+const GLState::Counters& GLState::EndFrame()
+{
+	m_lastFrame = m_frame;
+	std::memset(&m_frame, 0, sizeof(m_frame));
+	return m_lastFrame;
+}
+
+void GLState::UseProgram(GLuint program)
+{
+	if (program == m_program)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glUseProgram(program);
+	m_program = program;
+	++m_frame.m_programBinds;
+}
+
+void GLState::ActiveTexture(GLenum unit)
+{
+	if (unit == m_activeUnit)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glActiveTexture(unit);
+	m_activeUnit = unit;
+	++m_frame.m_stateChanges;
+}
+
+// -------------------
+// Descripción: Función que enlaza una textura en la unidad activa (como glBindTexture)
+// -------------------
+void GLState::BindTexture(GLenum target, GLuint texture)
+{
+	int slot = GetTextureSlot(target);
+	unsigned int unit = m_activeUnit - GL_TEXTURE0;
+
+	if (slot < 0 || m_activeUnit == UNKNOWN || unit >= MAX_TEXTURE_UNITS)
+	{
+		glBindTexture(target, texture);
+		++m_frame.m_textureBinds;
+
+		// Sin saber la unidad activa cualquiera de ellas puede haber cambiado
+		if (slot >= 0 && m_activeUnit == UNKNOWN)
+		{
+			for (int i = 0; i < MAX_TEXTURE_UNITS; ++i)
+				m_textures[slot][i] = UNKNOWN;
+		}
+
+		return;
+	}
+
+	if (m_textures[slot][unit] == texture)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glBindTexture(target, texture);
+	m_textures[slot][unit] = texture;
+	++m_frame.m_textureBinds;
+}
+
+// -------------------
+// Descripción: Función que enlaza una textura en una unidad concreta; solo cambia la unidad activa si hace falta enlazar
+// -------------------
+void GLState::BindTextureUnit(unsigned int unit, GLuint texture, GLenum target)
+{
+	int slot = GetTextureSlot(target);
+
+	if (slot >= 0 && unit < MAX_TEXTURE_UNITS && m_textures[slot][unit] == texture)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	ActiveTexture(GL_TEXTURE0 + unit);
+	BindTexture(target, texture);
+}
+
+void GLState::BindVertexArray(GLuint vao)
+{
+	if (vao == m_vao)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glBindVertexArray(vao);
+	m_vao = vao;
+	++m_frame.m_vaoBinds;
+
+	// El búfer de índices forma parte del VAO
+	m_buffers[SLOT_ELEMENT_ARRAY] = UNKNOWN;
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer)
+{
+	int slot = GetBufferSlot(target);
+
+	if (slot >= 0 && m_buffers[slot] == buffer)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glBindBuffer(target, buffer);
+	++m_frame.m_bufferBinds;
+
+	if (slot >= 0)
+		m_buffers[slot] = buffer;
+}
+
+// -------------------
+// Descripción: Función que enlaza un búfer a un punto indexado; OpenGL también lo deja en el destino genérico
+// -------------------
+void GLState::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	int slot = GetBufferSlot(target);
+
+	glBindBufferBase(target, index, buffer);
+	++m_frame.m_bufferBinds;
+
+	if (slot >= 0)
+		m_buffers[slot] = buffer;
+}
+
+void GLState::Enable(GLenum capability)
+{
+	int index = GetCapability(capability);
+
+	if (index >= 0 && m_capabilities[index] == 1)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glEnable(capability);
+	++m_frame.m_stateChanges;
+
+	if (index >= 0)
+		m_capabilities[index] = 1;
+}
+
+void GLState::Disable(GLenum capability)
+{
+	int index = GetCapability(capability);
+
+	if (index >= 0 && m_capabilities[index] == 0)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glDisable(capability);
+	++m_frame.m_stateChanges;
+
+	if (index >= 0)
+		m_capabilities[index] = 0;
+}
+
+// -------------------
+// Descripción: Función que devuelve si una capacidad está activa; solo pregunta a OpenGL la primera vez
+// -------------------
+bool GLState::IsEnabled(GLenum capability)
+{
+	int index = GetCapability(capability);
+
+	if (index < 0)
+		return glIsEnabled(capability) == GL_TRUE;
+
+	if (m_capabilities[index] < 0)
+		m_capabilities[index] = glIsEnabled(capability) == GL_TRUE ? 1 : 0;
+
+	return m_capabilities[index] == 1;
+}
+
+void GLState::BlendFunc(GLenum source, GLenum destination)
+{
+	BlendFuncSeparate(source, destination, source, destination);
+}
+
+void GLState::BlendFuncSeparate(GLenum sourceRgb, GLenum destinationRgb, GLenum sourceAlpha, GLenum destinationAlpha)
+{
+	if (m_blend[0] == sourceRgb && m_blend[1] == destinationRgb && m_blend[2] == sourceAlpha && m_blend[3] == destinationAlpha)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glBlendFuncSeparate(sourceRgb, destinationRgb, sourceAlpha, destinationAlpha);
+	++m_frame.m_stateChanges;
+
+	m_blend[0] = sourceRgb;
+	m_blend[1] = destinationRgb;
+	m_blend[2] = sourceAlpha;
+	m_blend[3] = destinationAlpha;
+}
+
+// -------------------
+// Descripción: Función que devuelve la función de mezcla (origen RGB, destino RGB, origen alfa, destino alfa);
+// como IsEnabled, solo pregunta a OpenGL si todavía no se conoce
+// -------------------
+void GLState::GetBlendFunc(GLenum* blend)
+{
+	const GLenum names[4] = { GL_BLEND_SRC_RGB, GL_BLEND_DST_RGB, GL_BLEND_SRC_ALPHA, GL_BLEND_DST_ALPHA };
+
+	for (int i = 0; i < 4; ++i)
+	{
+		if (m_blend[i] == UNKNOWN)
+		{
+			GLint value = 0;
+			glGetIntegerv(names[i], &value);
+			m_blend[i] = (GLenum)value;
+		}
+
+		blend[i] = m_blend[i];
+	}
+}
+
+void GLState::DepthMask(GLboolean write)
+{
+	if (m_depthMask == (int)write)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glDepthMask(write);
+	m_depthMask = (int)write;
+	++m_frame.m_stateChanges;
+}
+
+bool GLState::GetDepthMask()
+{
+	if (m_depthMask < 0)
+	{
+		GLboolean write = GL_TRUE;
+		glGetBooleanv(GL_DEPTH_WRITEMASK, &write);
+		m_depthMask = write == GL_TRUE ? 1 : 0;
+	}
+
+	return m_depthMask == 1;
+}
+
+void GLState::DepthFunc(GLenum func)
+{
+	if (m_depthFunc == func)
+	{
+		++m_frame.m_skippedCalls;
+		return;
+	}
+
+	glDepthFunc(func);
+	m_depthFunc = func;
+	++m_frame.m_stateChanges;
+}
+
+GLenum GLState::GetDepthFunc()
+{
+	if (m_depthFunc == UNKNOWN)
+	{
+		GLint value = GL_LESS;
+		glGetIntegerv(GL_DEPTH_FUNC, &value);
+		m_depthFunc = (GLenum)value;
+	}
+
+	return m_depthFunc;
+}
+
+void GLState::DrawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+	if (instances > 1)
+		glDrawArraysInstanced(mode, first, count, instances);
+	else
+		glDrawArrays(mode, first, count);
+
+	++m_frame.m_drawCalls;
+}
+
+void GLState::DrawElements(GLenum mode, GLsizei count, GLsizei instances)
+{
+	if (instances > 1)
+		glDrawElementsInstanced(mode, count, GL_UNSIGNED_INT, 0, instances);
+	else
+		glDrawElements(mode, count, GL_UNSIGNED_INT, 0);
+
+	++m_frame.m_drawCalls;
+}
+
+// Dibujo cuyos parámetros (y número de instancias) están en el búfer enlazado a GL_DRAW_INDIRECT_BUFFER
+void GLState::DrawElementsIndirect(GLenum mode, GLintptr offset)
+{
+	glDrawElementsIndirect(mode, GL_UNSIGNED_INT, (const void*)offset);
+	++m_frame.m_drawCalls;
+}
+
+// Varios comandos seguidos del búfer indirecto en una sola llamada; para el contador es un único dibujo
+void GLState::MultiDrawElementsIndirect(GLenum mode, GLintptr offset, GLsizei drawCount)
+{
+	glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, (const void*)offset, drawCount, 0);
+	++m_frame.m_drawCalls;
+}
+
+// -------------------
+// Descripción: Funciones que borran objetos. OpenGL deja a cero los enlaces de un objeto borrado y puede reutilizar
+// su nombre, así que el espejo tiene que olvidarlo o un enlace posterior del nombre reutilizado se saltaría.
+// -------------------
+void GLState::DeleteTextures(GLsizei count, const GLuint* textures)
+{
+	for (GLsizei i = 0; i < count; ++i)
+	{
+		for (int slot = 0; slot < TOTAL_TEXTURE_SLOTS; ++slot)
+		{
+			for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+			{
+				if (m_textures[slot][unit] == textures[i])
+					m_textures[slot][unit] = 0;
+			}
+		}
+	}
+
+	glDeleteTextures(count, textures);
+}
+
+void GLState::DeleteBuffers(GLsizei count, const GLuint* buffers)
+{
+	for (GLsizei i = 0; i < count; ++i)
+	{
+		for (int slot = 0; slot < TOTAL_BUFFER_SLOTS; ++slot)
+		{
+			if (m_buffers[slot] == buffers[i])
+				m_buffers[slot] = 0;
+		}
+	}
+
+	glDeleteBuffers(count, buffers);
+}
+
+// -------------------
+// Descripción: Función que apunta la disposición de samplers del programa y dice si ha cambiado, es decir, si el
+// llamador tiene que subir los uniformes de los samplers (con el programa ya activo). Los uniformes se guardan en el
+// programa, así que basta con subirlos cuando otra malla con otros tipos de textura usa el mismo programa.
+// -------------------
+bool GLState::SetSamplerLayout(GLuint program, unsigned int layout)
+{
+	for (auto iter = m_samplerLayouts.begin(); iter != m_samplerLayouts.end(); ++iter)
+	{
+		if ((*iter).first == program)
+		{
+			if ((*iter).second == layout)
+			{
+				++m_frame.m_skippedCalls;
+				return false;
+			}
+
+			(*iter).second = layout;
+			return true;
+		}
+	}
+
+	m_samplerLayouts.push_back(std::make_pair(program, layout));
+	return true;
+}
+
+void GLState::DeleteProgram(GLuint program)
+{
+	for (auto iter = m_samplerLayouts.begin(); iter != m_samplerLayouts.end(); ++iter)
+	{
+		if ((*iter).first == program)
+		{
+			m_samplerLayouts.erase(iter);
+			break;
+		}
+	}
+
+	glDeleteProgram(program);
+}
+
+void GLState::DeleteVertexArrays(GLsizei count, const GLuint* vaos)
+{
+	for (GLsizei i = 0; i < count; ++i)
+	{
+		if (m_vao == vaos[i])
+		{
+			m_vao = 0;
+			m_buffers[SLOT_ELEMENT_ARRAY] = 0;
+		}
+	}
+
+	glDeleteVertexArrays(count, vaos);
+}
+
+int GLState::GetTextureSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D: return SLOT_TEXTURE_2D;
+	case GL_TEXTURE_CUBE_MAP: return SLOT_TEXTURE_CUBE_MAP;
+	default: return -1;
+	}
+}
+
+int GLState::GetBufferSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER: return SLOT_ARRAY;
+	case GL_ELEMENT_ARRAY_BUFFER: return SLOT_ELEMENT_ARRAY;
+	case GL_UNIFORM_BUFFER: return SLOT_UNIFORM;
+	case GL_SHADER_STORAGE_BUFFER: return SLOT_SHADER_STORAGE;
+	case GL_DRAW_INDIRECT_BUFFER: return SLOT_DRAW_INDIRECT;
+	default: return -1;
+	}
+}
+
+int GLState::GetCapability(GLenum capability)
+{
+	switch (capability)
+	{
+	case GL_BLEND: return CAP_BLEND;
+	case GL_DEPTH_TEST: return CAP_DEPTH_TEST;
+	case GL_CULL_FACE: return CAP_CULL_FACE;
+	default: return -1;
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+#ifndef __GLSTATE_H__
+#define __GLSTATE_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include <utility>
+#include <vector>
+
+// Espejo del estado enlazado de OpenGL: programa, texturas por unidad, VAO, búferes por destino, mezcla y profundidad.
+// Todo el proyecto enlaza a través de aquí, así una llamada que no cambia nada no llega al controlador.
+// Un valor desconocido (~0) obliga a hacer la llamada; Invalidate() lo olvida todo si alguien tocó OpenGL directamente.
+// También recuerda qué disposición de samplers (ver Mesh::GetSamplerLayout) tiene puesta cada programa.
+// Además cuenta por cuadro las llamadas de dibujo, los enlaces y los uniformes subidos (ver Profiler::EndFrame) y
+// Validate() compara el espejo con el estado real sin necesidad de un depurador de GPU.
+class GLState
+{
+public:
+	struct Counters
+	{
+		unsigned int m_drawCalls;
+		unsigned int m_programBinds;
+		unsigned int m_textureBinds;
+		unsigned int m_vaoBinds;
+		unsigned int m_bufferBinds;
+		unsigned int m_stateChanges;
+		unsigned int m_uniformUploads;
+		unsigned int m_skippedCalls;
+	};
+
+	~GLState();
+
+	static GLState& GetInstance()
+	{
+		static GLState instance;
+		return instance;
+	}
+
+	GLState(GLState const&) = delete;
+	void operator=(GLState const&) = delete;
+
+	void Invalidate();
+	bool Validate();
+	const Counters& EndFrame();
+
+	void UseProgram(GLuint program);
+	void ActiveTexture(GLenum unit);
+	void BindTexture(GLenum target, GLuint texture);
+	void BindTextureUnit(unsigned int unit, GLuint texture, GLenum target = GL_TEXTURE_2D);
+	void BindVertexArray(GLuint vao);
+	void BindBuffer(GLenum target, GLuint buffer);
+	void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+	void Enable(GLenum capability);
+	void Disable(GLenum capability);
+	bool IsEnabled(GLenum capability);
+	void BlendFunc(GLenum source, GLenum destination);
+	void BlendFuncSeparate(GLenum sourceRgb, GLenum destinationRgb, GLenum sourceAlpha, GLenum destinationAlpha);
+	void GetBlendFunc(GLenum* blend);
+	void DepthMask(GLboolean write);
+	bool GetDepthMask();
+	void DepthFunc(GLenum func);
+	GLenum GetDepthFunc();
+	bool SetSamplerLayout(GLuint program, unsigned int layout);
+
+	void DrawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances = 1);
+	void DrawElements(GLenum mode, GLsizei count, GLsizei instances = 1);
+	void DrawElementsIndirect(GLenum mode, GLintptr offset);
+	void MultiDrawElementsIndirect(GLenum mode, GLintptr offset, GLsizei drawCount);
+	void CountDraw() { ++m_frame.m_drawCalls; }
+	void CountUniformUpload() { ++m_frame.m_uniformUploads; }
+
+	void DeleteTextures(GLsizei count, const GLuint* textures);
+	void DeleteBuffers(GLsizei count, const GLuint* buffers);
+	void DeleteVertexArrays(GLsizei count, const GLuint* vaos);
+	void DeleteProgram(GLuint program);
+
+	GLuint GetProgram() const { return m_program; }
+	GLuint GetVertexArray() const { return m_vao; }
+	const Counters& GetFrameCounters() const { return m_frame; }
+	const Counters& GetLastFrameCounters() const { return m_lastFrame; }
+
+private:
+	GLState();
+
+	enum { MAX_TEXTURE_UNITS = 32 };
+	enum TextureSlot { SLOT_TEXTURE_2D, SLOT_TEXTURE_CUBE_MAP, TOTAL_TEXTURE_SLOTS };
+	enum BufferSlot { SLOT_ARRAY, SLOT_ELEMENT_ARRAY, SLOT_UNIFORM, SLOT_SHADER_STORAGE, SLOT_DRAW_INDIRECT, TOTAL_BUFFER_SLOTS };
+	enum Capability { CAP_BLEND, CAP_DEPTH_TEST, CAP_CULL_FACE, TOTAL_CAPABILITIES };
+
+	GLuint m_program, m_vao;
+	GLenum m_activeUnit;
+	GLuint m_textures[TOTAL_TEXTURE_SLOTS][MAX_TEXTURE_UNITS];
+	GLuint m_buffers[TOTAL_BUFFER_SLOTS];
+	int m_capabilities[TOTAL_CAPABILITIES];
+	GLenum m_blend[4];
+	GLenum m_depthFunc;
+	int m_depthMask;
+	std::vector<std::pair<GLuint, unsigned int> > m_samplerLayouts;
+
+	Counters m_frame, m_lastFrame;
+
+	// Private functions
+	int GetTextureSlot(GLenum target);
+	int GetBufferSlot(GLenum target);
+	int GetCapability(GLenum capability);
+};
+
+#endif // !__GLSTATE_H__
@@ -10,13 +10,19 @@
 #include "PointLight.h"
 #include "Player.h"
 #include "Debugger.h"
-#include "Enemy.h"
+#include "EnemyManager.h"
+#include "ProjectileSystem.h"
 #include "ParticleEmitter.h"
 #include "Font.h"
 #include "Framebuffer.h"
+#include "ParticleRenderTarget.h"
+#include "Profiler.h"
 #include "Atmosphere.h"
 #include "Cloth.h"
 #include "Audio.h"
+#include "FixedTimestep.h"
+#include "InputRecorder.h"
+#include "AsteroidBelt.h"
 
 class Game
 {
@@ -58,8 +64,15 @@ private:
 	GameState m_gameState;
 	float m_deltaTime;
 
+	// Simulación de paso fijo; el render interpola la cámara con el alfa del reloj
+	FixedTimestep m_simulationClock;
+	Interpolated<glm::vec3> m_cameraPos;
+	InputRecorder m_inputRecorder;
+	uint32_t m_seed;
+
 private:
 	Model m_asteroid, m_flagPole, m_mountainRock;
+	AsteroidBelt m_asteroidBelt;
 	std::vector<Model> m_mountainRocks;
 	Atmosphere m_atmosphere;
 	Terrain m_terrain;
@@ -68,9 +81,13 @@ private:
 	Debugger m_debugger;
 	Camera m_camera, m_cameraHUD;
 	Framebuffer m_framebuffer;
+	ParticleRenderTarget m_particleTarget;
 	Cloth m_flag;
 	std::vector<Text> m_texts;
-	std::vector<Enemy*> m_enemies;
+	EnemyManager m_enemyManager;
+	FlowField m_flowField;
+	PerceptionSystem m_perception;
+	ProjectileSystem m_projectiles;
 
 private:
 	int m_mouseX, m_mouseY;
@@ -30,6 +30,8 @@ public:
 	Texture& GetTextureComponent() { return m_textureComponent; }
 	Animation& GetAnimationComponent() { return m_animationComponent; }
 	Transform& GetTransformComponent() { return m_transform; }
+	GLuint GetVao() const { return m_vao; }
+	GLuint GetNumOfIndices() const { return m_numOfIndices; }
 
 	void SetTextureId(char* texId);
 	void SetObjectId(int id);
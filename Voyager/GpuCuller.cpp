@@ -0,0 +1,218 @@
+#include "GpuCuller.h"
+#include "FrustumCuller.h"
+#include "GLState.h"
+#include <cstddef>
+#include <cstdio>
+
+GpuCullSet::GpuCullSet() :
+	m_source(nullptr),
+	m_visible(nullptr),
+	m_boundingRadius(1.0f),
+	m_commandBuffer(0)
+{}
+
+GpuCullSet::~GpuCullSet()
+{
+	Destroy();
+}
+
+// -------------------
+// Descripción: Función que prepara un comando indirecto por malla (los índices de cada malla están en su propio EBO,
+// así que todos empiezan en 0) y crea el búfer que los guarda. El número de instancias lo pone la GPU en cada Cull.
+// -------------------
+void GpuCullSet::Init(InstanceBuffer& source, InstanceBuffer& visible, Model& model)
+{
+	Destroy();
+
+	m_source = &source;
+	m_visible = &visible;
+	m_boundingRadius = model.GetBoundingRadius();
+
+	for (GLuint i = 0; i < model.GetMeshes().size(); ++i)
+	{
+		DrawElementsIndirectCommand command;
+		command.m_count = (GLuint)model.GetMeshes()[i].GetIndices().size();
+		command.m_instanceCount = 0;
+		command.m_firstIndex = 0;
+		command.m_baseVertex = 0;
+		command.m_baseInstance = 0;
+		m_commands.push_back(command);
+	}
+
+	glGenBuffers(1, &m_commandBuffer);
+	GLState::GetInstance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commands.size() * sizeof(DrawElementsIndirectCommand), m_commands.data(), GL_DYNAMIC_DRAW);
+}
+
+void GpuCullSet::Destroy()
+{
+	if (m_commandBuffer != 0)
+		GLState::GetInstance().DeleteBuffers(1, &m_commandBuffer);
+
+	m_commandBuffer = 0;
+	m_commands.clear();
+}
+
+GpuCuller::GpuCuller() :
+	m_viewProjection(1.0f),
+	m_hiZ(nullptr),
+	m_hiZEnabled(true),
+	m_lastCullHiZ(false)
+{
+	for (unsigned int p = 0; p < 6; ++p)
+		m_planes[p] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+GpuCuller::~GpuCuller()
+{}
+
+bool GpuCuller::IsSupported()
+{
+	return GLEW_VERSION_4_3 != 0;
+}
+
+void GpuCuller::Init()
+{
+	if (!IsSupported())
+	{
+		printf("ERROR: GPU culling needs OpenGL 4.3 (compute shaders and indirect draws)\n");
+		return;
+	}
+
+	m_cullShader.CreateComputeProgram("res/Shaders/Culling/InstanceCull.comp");
+	m_cullShader.ActivateProgram();
+	m_cullShader.SetInt("hiZ", HIZ_TEXTURE_UNIT);
+}
+
+void GpuCuller::BeginFrame(Camera& cam)
+{
+	BeginFrame(cam.GetProjectionMatrix() * cam.GetViewMatrix());
+}
+
+void GpuCuller::BeginFrame(const glm::mat4& viewProjection)
+{
+	m_viewProjection = viewProjection;
+	FrustumCuller::ExtractPlanes(viewProjection, m_planes);
+}
+
+// -------------------
+// Descripción: Función que recorta un conjunto en la GPU. Pone a cero el número de instancias de los comandos, lanza un
+// hilo por instancia y deja una barrera para que el dibujo indirecto y los atributos de instancia vean lo escrito.
+// -------------------
+void GpuCuller::Cull(GpuCullSet& set)
+{
+	if (m_cullShader.GetShaderProgram() == 0 || set.m_source == nullptr || set.m_visible == nullptr || set.m_commandBuffer == 0)
+		return;
+
+	unsigned int count = set.m_source->GetCount();
+	unsigned int stride = set.m_source->GetStride();
+
+	if (stride % 4 != 0 || stride < sizeof(glm::vec4))
+	{
+		printf("ERROR: GPU culling needs instances that start with vec4(position, scale) and a stride multiple of 4\n");
+		return;
+	}
+
+	GLState& state = GLState::GetInstance();
+
+	for (auto iter = set.m_commands.begin(); iter != set.m_commands.end(); ++iter)
+		(*iter).m_instanceCount = 0;
+
+	state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, set.m_commandBuffer);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, set.m_commands.size() * sizeof(DrawElementsIndirectCommand), set.m_commands.data());
+
+	if (count == 0)
+		return;
+
+	set.m_visible->Reserve(count);
+
+	state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, SOURCE_BINDING, set.m_source->GetBuffer());
+	state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_BINDING, set.m_visible->GetBuffer());
+	state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, set.m_commandBuffer);
+
+	m_cullShader.ActivateProgram();
+	m_cullShader.SetVec4Array("frustumPlanes", m_planes, 6);
+	m_cullShader.SetInt("instanceCount", (int)count);
+	m_cullShader.SetInt("instanceWords", (int)(stride / 4));
+	m_cullShader.SetInt("totalCommands", (int)set.m_commands.size());
+	m_cullShader.SetFloat("boundingRadius", set.m_boundingRadius);
+
+	bool hiZ = m_hiZEnabled && m_hiZ != nullptr && m_hiZ->IsValid();
+	m_cullShader.SetBool("hiZEnabled", hiZ);
+	m_lastCullHiZ = hiZ;
+
+	if (hiZ)
+	{
+		state.BindTextureUnit(HIZ_TEXTURE_UNIT, m_hiZ->GetTexture());
+		m_cullShader.SetMat4("hiZViewProjection", m_hiZ->GetViewProjection());
+		m_cullShader.SetVec2("hiZSize", glm::vec2((float)m_hiZ->GetWidth(), (float)m_hiZ->GetHeight()));
+		m_cullShader.SetFloat("hiZLevels", (float)m_hiZ->GetLevels());
+	}
+
+	glDispatchCompute((count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+unsigned int GpuCuller::ReadVisibleCount(const GpuCullSet& set)
+{
+	if (set.m_commandBuffer == 0)
+		return 0;
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	GLuint visible = 0;
+	GLState::GetInstance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, set.m_commandBuffer);
+	glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, offsetof(DrawElementsIndirectCommand, m_instanceCount), sizeof(GLuint), &visible);
+	return visible;
+}
+
+// -------------------
+// Descripción: Función que comprueba el último Cull del conjunto contra la prueba de esferas de FrustumCuller sobre
+// las mismas instancias de la CPU. Sin Hi-Z el número de visibles tiene que coincidir; con Hi-Z la GPU solo puede
+// quitar más. Además todos los comandos indirectos deben llevar el mismo número de instancias. Lee de la GPU y la
+// espera: solo para depurar. Imprime cada diferencia y devuelve false si hay alguna.
+// -------------------
+bool GpuCuller::Validate(GpuCullSet& set)
+{
+	if (set.m_source == nullptr || set.m_commandBuffer == 0 || set.m_commands.empty())
+		return false;
+
+	FrustumCuller frustum;
+	frustum.BeginFrame(m_viewProjection);
+
+	unsigned int expected = 0;
+
+	for (unsigned int i = 0; i < set.m_source->GetCount(); ++i)
+	{
+		const glm::vec4& posScale = *(const glm::vec4*)set.m_source->GetInstance(i);
+
+		if (frustum.TestSphere(glm::vec3(posScale), posScale.w * set.m_boundingRadius))
+			++expected;
+	}
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	std::vector<DrawElementsIndirectCommand> commands(set.m_commands.size());
+	GLState::GetInstance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, set.m_commandBuffer);
+	glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+
+	bool valid = true;
+	unsigned int visible = commands[0].m_instanceCount;
+
+	if (m_lastCullHiZ ? visible > expected : visible != expected)
+	{
+		printf("ERROR: GpuCuller mismatch (GPU %u visible, CPU frustum %u%s)\n", visible, expected, m_lastCullHiZ ? ", Hi-Z on" : "");
+		valid = false;
+	}
+
+	for (unsigned int c = 1; c < commands.size(); ++c)
+	{
+		if (commands[c].m_instanceCount != visible)
+		{
+			printf("ERROR: GpuCuller command %u has %u instances, command 0 has %u\n", c, commands[c].m_instanceCount, visible);
+			valid = false;
+		}
+	}
+
+	return valid;
+}
\ No newline at end of file
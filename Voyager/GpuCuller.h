@@ -0,0 +1,84 @@
+#pragma once
+#ifndef __GPUCULLER_H__
+#define __GPUCULLER_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "Camera.h"
+#include "HiZPyramid.h"
+#include "InstanceBuffer.h"
+#include "Model.h"
+#include "Shader.h"
+#include <vector>
+
+// Comando de glDrawElementsIndirect (el orden de los campos lo fija OpenGL)
+struct DrawElementsIndirectCommand
+{
+	GLuint m_count;
+	GLuint m_instanceCount;
+	GLuint m_firstIndex;
+	GLint m_baseVertex;
+	GLuint m_baseInstance;
+};
+
+// Conjunto instanciado que se recorta en la GPU: el búfer con todas las instancias (cada registro empieza por
+// vec4(posición, escala)), el búfer de destino con el mismo formato y un comando indirecto por malla del modelo.
+struct GpuCullSet
+{
+	GpuCullSet();
+	~GpuCullSet();
+
+	GpuCullSet(GpuCullSet const&) = delete;
+	void operator=(GpuCullSet const&) = delete;
+
+	void Init(InstanceBuffer& source, InstanceBuffer& visible, Model& model);
+	void Destroy();
+
+	InstanceBuffer* m_source;
+	InstanceBuffer* m_visible;
+	float m_boundingRadius;			// Radio del modelo; la esfera de cada instancia es (posición, escala * radio)
+	std::vector<DrawElementsIndirectCommand> m_commands;
+	GLuint m_commandBuffer;
+};
+
+// Recorte de conjuntos instanciados en la GPU. Un sombreador de cálculo prueba la esfera de cada instancia contra el
+// frustum y, si hay pirámide Hi-Z del cuadro anterior, contra su profundidad; las visibles se añaden con atómicos al
+// búfer de destino y el mismo sombreador escribe el número de instancias de los comandos indirectos. Para la CPU el
+// conjunto cuesta un glDispatchCompute y un glDrawElementsIndirect por malla, sin leer nada de vuelta.
+// Solo usa OpenGL 4.3 básico (cálculo, SSBO, atómicos, dibujo indirecto), así funciona también con llvmpipe.
+class GpuCuller
+{
+public:
+	enum { WORKGROUP_SIZE = 64 };
+	enum { SOURCE_BINDING = 0, VISIBLE_BINDING = 1, COMMAND_BINDING = 2 };
+	enum { HIZ_TEXTURE_UNIT = 0 };
+
+	GpuCuller();
+	~GpuCuller();
+
+	static bool IsSupported();
+
+	void Init();
+	void BeginFrame(Camera& cam);
+	void BeginFrame(const glm::mat4& viewProjection);
+	void Cull(GpuCullSet& set);
+
+	// Lee de la GPU cuántas instancias pasaron (espera a la GPU: solo para pruebas y depuración)
+	unsigned int ReadVisibleCount(const GpuCullSet& set);
+
+	// Repite el último Cull del conjunto con FrustumCuller en la CPU y compara (solo para depurar, como GLState::Validate)
+	bool Validate(GpuCullSet& set);
+
+	void SetHiZ(HiZPyramid* pyramid) { m_hiZ = pyramid; }
+	void SetHiZEnabled(bool enabled) { m_hiZEnabled = enabled; }
+	bool IsHiZEnabled() { return m_hiZEnabled; }
+
+private:
+	Shader m_cullShader;
+	glm::vec4 m_planes[6];
+	glm::mat4 m_viewProjection;
+	HiZPyramid* m_hiZ;
+	bool m_hiZEnabled, m_lastCullHiZ;
+};
+
+#endif // !__GPUCULLER_H__
\ No newline at end of file
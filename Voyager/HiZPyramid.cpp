@@ -0,0 +1,98 @@
+#include "HiZPyramid.h"
+#include "GLState.h"
+#include <algorithm>
+
+HiZPyramid::HiZPyramid() :
+	m_texture(0),
+	m_width(0),
+	m_height(0),
+	m_levels(0),
+	m_viewProjection(1.0f),
+	m_valid(false)
+{}
+
+HiZPyramid::~HiZPyramid()
+{}
+
+// -------------------
+// Descripción: Función que crea la cadena de mipmaps. El nivel 0 tiene la mitad de resolución que la profundidad de la
+// escena (ya guarda el máximo de cada bloque de 2x2), que basta para rechazar objetos y cuesta una cuarta parte.
+// -------------------
+void HiZPyramid::Init(int depthWidth, int depthHeight)
+{
+	Destroy();
+
+	m_width = std::max(depthWidth / 2, 1);
+	m_height = std::max(depthHeight / 2, 1);
+	m_levels = 1;
+
+	while ((std::max(m_width, m_height) >> m_levels) > 0)
+		++m_levels;
+
+	glGenTextures(1, &m_texture);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_texture);
+	glTexStorage2D(GL_TEXTURE_2D, m_levels, GL_R32F, m_width, m_height);
+
+	// Se lee siempre un nivel concreto con textureLod y el texel exacto: nada de filtrado
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	if (m_downsampleShader.GetShaderProgram() == 0)
+	{
+		m_downsampleShader.CreateComputeProgram("res/Shaders/Culling/HiZDownsample.comp");
+		m_downsampleShader.ActivateProgram();
+		m_downsampleShader.SetInt("sceneDepth", 0);
+	}
+
+	m_valid = false;
+}
+
+void HiZPyramid::Destroy()
+{
+	if (m_texture != 0)
+		GLState::GetInstance().DeleteTextures(1, &m_texture);
+
+	m_texture = 0;
+	m_width = m_height = m_levels = 0;
+	m_valid = false;
+}
+
+// -------------------
+// Descripción: Función que reduce la profundidad de la escena nivel a nivel. Cada nivel lee el anterior como imagen, así
+// que entre niveles hace falta una barrera de acceso a imágenes; al final, una de lectura de texturas para GpuCuller.
+// -------------------
+void HiZPyramid::Build(GLuint depthTexture, const glm::mat4& viewProjection)
+{
+	if (m_texture == 0)
+		return;
+
+	GLState& state = GLState::GetInstance();
+	m_downsampleShader.ActivateProgram();
+
+	m_downsampleShader.SetBool("fromDepth", true);
+	state.BindTextureUnit(0, depthTexture);
+	glBindImageTexture(0, m_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	Dispatch(m_width, m_height);
+
+	m_downsampleShader.SetBool("fromDepth", false);
+
+	for (int level = 1; level < m_levels; ++level)
+	{
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		glBindImageTexture(1, m_texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindImageTexture(0, m_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		Dispatch(std::max(m_width >> level, 1), std::max(m_height >> level, 1));
+	}
+
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+	m_viewProjection = viewProjection;
+	m_valid = true;
+}
+
+void HiZPyramid::Dispatch(int width, int height)
+{
+	glDispatchCompute((width + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, (height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+}
\ No newline at end of file
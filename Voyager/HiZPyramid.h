@@ -0,0 +1,42 @@
+#pragma once
+#ifndef __HIZPYRAMID_H__
+#define __HIZPYRAMID_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "Shader.h"
+
+// Pirámide de profundidad jerárquica (Hi-Z): cadena de mipmaps R32F donde cada texel guarda la profundidad más lejana de
+// la zona que cubre. Se construye con un sombreador de cálculo a partir de la profundidad de la escena al final del
+// cuadro y GpuCuller la usa en el cuadro siguiente, junto con la matriz vista-proyección con la que se dibujó.
+class HiZPyramid
+{
+public:
+	HiZPyramid();
+	~HiZPyramid();
+
+	void Init(int depthWidth, int depthHeight);
+	void Destroy();
+	void Build(GLuint depthTexture, const glm::mat4& viewProjection);
+
+	bool IsValid() const { return m_valid; }
+	GLuint GetTexture() const { return m_texture; }
+	int GetWidth() const { return m_width; }
+	int GetHeight() const { return m_height; }
+	int GetLevels() const { return m_levels; }
+	const glm::mat4& GetViewProjection() const { return m_viewProjection; }
+
+private:
+	enum { WORKGROUP_SIZE = 8 };
+
+	GLuint m_texture;
+	int m_width, m_height, m_levels;
+	glm::mat4 m_viewProjection;
+	bool m_valid;
+	Shader m_downsampleShader;
+
+	// Private functions
+	void Dispatch(int width, int height);
+};
+
+#endif // !__HIZPYRAMID_H__
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "InputRecorder.h"
+#include <cstring>
+#include <fstream>
+
+InputRecorder::InputRecorder() :
+	m_mode(Mode::IDLE),
+	m_seed(0),
+	m_step(1.0f / 60.0f),
+	m_replayStep(0)
+{}
+
+InputRecorder::~InputRecorder()
+{}
+
+void InputRecorder::StartRecording(uint32_t seed, float step)
+{
+	m_mode = Mode::RECORDING;
+	m_seed = seed;
+	m_step = step;
+	m_replayStep = 0;
+	m_events.clear();
+	m_stepEnds.clear();
+	m_checksums.clear();
+}
+
+// -------------------
+// Descripción: Función que guarda los eventos de un paso fijo (se llama una vez por paso, aunque no haya eventos)
+// -------------------
+void InputRecorder::Record(const std::vector<SDL_Event>& events, uint32_t checksum)
+{
+	if (m_mode != Mode::RECORDING)
+		return;
+
+	RecordedEvent recorded;
+
+	for (auto iter = events.begin(); iter != events.end(); ++iter)
+	{
+		if (Pack(*iter, recorded))
+			m_events.push_back(recorded);
+	}
+
+	m_stepEnds.push_back((uint32_t)m_events.size());
+	m_checksums.push_back(checksum);
+}
+
+bool InputRecorder::Save(const std::string& path)
+{
+	std::ofstream file(path, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		printf("ERROR: Unable to write replay file: %s\n", path.c_str());
+		return false;
+	}
+
+	uint32_t step;
+	std::memcpy(&step, &m_step, sizeof(step));
+
+	uint32_t header[6] = { FILE_MAGIC, FILE_VERSION, m_seed, step, (uint32_t)m_stepEnds.size(), (uint32_t)m_events.size() };
+
+	file.write((const char*)header, sizeof(header));
+	file.write((const char*)m_stepEnds.data(), sizeof(uint32_t) * m_stepEnds.size());
+	file.write((const char*)m_checksums.data(), sizeof(uint32_t) * m_checksums.size());
+	file.write((const char*)m_events.data(), sizeof(RecordedEvent) * m_events.size());
+	return file.good();
+}
+
+// -------------------
+// Descripción: Función que carga una grabación y deja el grabador listo para reproducirla desde el primer paso
+// -------------------
+bool InputRecorder::Load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		printf("ERROR: Unable to open replay file: %s\n", path.c_str());
+		return false;
+	}
+
+	uint32_t header[6];
+	file.read((char*)header, sizeof(header));
+
+	if (!file.good() || header[0] != FILE_MAGIC || header[1] != FILE_VERSION)
+	{
+		printf("ERROR: Invalid replay file: %s\n", path.c_str());
+		return false;
+	}
+
+	m_seed = header[2];
+	std::memcpy(&m_step, &header[3], sizeof(m_step));
+	m_stepEnds.resize(header[4]);
+	m_checksums.resize(header[4]);
+	m_events.resize(header[5]);
+
+	file.read((char*)m_stepEnds.data(), sizeof(uint32_t) * m_stepEnds.size());
+	file.read((char*)m_checksums.data(), sizeof(uint32_t) * m_checksums.size());
+	file.read((char*)m_events.data(), sizeof(RecordedEvent) * m_events.size());
+
+	if (!file.good() || (!m_stepEnds.empty() && m_stepEnds.back() != m_events.size()))
+	{
+		printf("ERROR: Truncated replay file: %s\n", path.c_str());
+		m_stepEnds.clear();
+		m_checksums.clear();
+		m_events.clear();
+		return false;
+	}
+
+	m_mode = Mode::REPLAYING;
+	m_replayStep = 0;
+	return true;
+}
+
+// -------------------
+// Descripción: Función que sustituye los eventos del paso actual por los grabados. Devuelve false al terminar la grabación.
+// -------------------
+bool InputRecorder::Replay(std::vector<SDL_Event>& events)
+{
+	events.clear();
+
+	if (m_mode != Mode::REPLAYING || m_replayStep >= m_stepEnds.size())
+		return false;
+
+	uint32_t first = m_replayStep > 0 ? m_stepEnds[m_replayStep - 1] : 0;
+	uint32_t timestamp = (uint32_t)(m_replayStep * m_step * 1000.0f);
+
+	for (uint32_t i = first; i < m_stepEnds[m_replayStep]; ++i)
+	{
+		SDL_Event event;
+		Unpack(m_events[i], timestamp, event);
+		events.push_back(event);
+	}
+
+	++m_replayStep;
+	return true;
+}
+
+// -------------------
+// Descripción: Función que compara la suma de verificación del paso recién reproducido con la grabada (0 = no se grabó)
+// -------------------
+bool InputRecorder::Verify(uint32_t checksum)
+{
+	if (m_mode != Mode::REPLAYING || m_replayStep == 0 || m_replayStep > m_checksums.size())
+		return true;
+
+	uint32_t expected = m_checksums[m_replayStep - 1];
+
+	if (expected == 0 || expected == checksum)
+		return true;
+
+	printf("ERROR: Replay desynchronized at step %u (expected %08x, got %08x)\n", m_replayStep - 1, expected, checksum);
+	return false;
+}
+
+bool InputRecorder::Pack(const SDL_Event& event, RecordedEvent& recorded)
+{
+	std::memset(&recorded, 0, sizeof(recorded));
+	recorded.m_type = event.type;
+
+	switch (event.type)
+	{
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+		recorded.m_data[0] = event.key.keysym.scancode;
+		recorded.m_data[1] = event.key.keysym.sym;
+		recorded.m_data[2] = event.key.keysym.mod;
+		recorded.m_data[3] = event.key.repeat;
+		return true;
+	case SDL_MOUSEMOTION:
+		recorded.m_data[0] = event.motion.x;
+		recorded.m_data[1] = event.motion.y;
+		recorded.m_data[2] = event.motion.xrel;
+		recorded.m_data[3] = event.motion.yrel;
+		recorded.m_data[4] = (int32_t)event.motion.state;
+		return true;
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEBUTTONUP:
+		recorded.m_data[0] = event.button.x;
+		recorded.m_data[1] = event.button.y;
+		recorded.m_data[2] = event.button.button;
+		recorded.m_data[3] = event.button.clicks;
+		return true;
+	case SDL_MOUSEWHEEL:
+		recorded.m_data[0] = event.wheel.x;
+		recorded.m_data[1] = event.wheel.y;
+		return true;
+	case SDL_WINDOWEVENT:
+		recorded.m_data[0] = event.window.event;
+		recorded.m_data[1] = event.window.data1;
+		recorded.m_data[2] = event.window.data2;
+		return true;
+	case SDL_QUIT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void InputRecorder::Unpack(const RecordedEvent& recorded, uint32_t timestamp, SDL_Event& event)
+{
+	std::memset(&event, 0, sizeof(event));
+	event.type = recorded.m_type;
+	event.common.timestamp = timestamp;
+
+	switch (recorded.m_type)
+	{
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+		event.key.state = recorded.m_type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+		event.key.keysym.scancode = (SDL_Scancode)recorded.m_data[0];
+		event.key.keysym.sym = (SDL_Keycode)recorded.m_data[1];
+		event.key.keysym.mod = (Uint16)recorded.m_data[2];
+		event.key.repeat = (Uint8)recorded.m_data[3];
+		break;
+	case SDL_MOUSEMOTION:
+		event.motion.x = recorded.m_data[0];
+		event.motion.y = recorded.m_data[1];
+		event.motion.xrel = recorded.m_data[2];
+		event.motion.yrel = recorded.m_data[3];
+		event.motion.state = (Uint32)recorded.m_data[4];
+		break;
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEBUTTONUP:
+		event.button.state = recorded.m_type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+		event.button.x = recorded.m_data[0];
+		event.button.y = recorded.m_data[1];
+		event.button.button = (Uint8)recorded.m_data[2];
+		event.button.clicks = (Uint8)recorded.m_data[3];
+		break;
+	case SDL_MOUSEWHEEL:
+		event.wheel.x = recorded.m_data[0];
+		event.wheel.y = recorded.m_data[1];
+		break;
+	case SDL_WINDOWEVENT:
+		event.window.event = (Uint8)recorded.m_data[0];
+		event.window.data1 = recorded.m_data[1];
+		event.window.data2 = recorded.m_data[2];
+		break;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef __INPUTRECORDER_H__
+#define __INPUTRECORDER_H__
+
+#include "Dependencies/SDL2/include/SDL.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Grabador de entrada: guarda, por cada paso fijo de simulación, los eventos de SDL que consumen Player y Physics,
+// junto con la semilla de la partida. Al reproducir se entregan los mismos eventos en los mismos pasos, de modo que
+// una sesión grabada se repite idéntica y sirve para comparar el rendimiento entre compilaciones.
+// Opcionalmente se guarda una suma de verificación del estado por paso para detectar en qué paso se desincroniza.
+class InputRecorder
+{
+public:
+	enum class Mode { IDLE, RECORDING, REPLAYING };
+
+	InputRecorder();
+	~InputRecorder();
+
+	void StartRecording(uint32_t seed, float step);
+	void Record(const std::vector<SDL_Event>& events, uint32_t checksum = 0);
+	bool Save(const std::string& path);
+
+	bool Load(const std::string& path);
+	bool Replay(std::vector<SDL_Event>& events);
+	bool Verify(uint32_t checksum);
+	void Stop() { m_mode = Mode::IDLE; }
+
+	Mode GetMode() { return m_mode; }
+	uint32_t GetSeed() { return m_seed; }
+	float GetStep() { return m_step; }
+	unsigned int GetStepCount() { return (unsigned int)m_stepEnds.size(); }
+	unsigned int GetCurrentStep() { return m_replayStep; }
+	bool IsFinished() { return m_mode == Mode::REPLAYING && m_replayStep >= m_stepEnds.size(); }
+
+private:
+	enum { FILE_MAGIC = 0x4C505256, FILE_VERSION = 1 };
+
+	// Solo los campos que usa el juego; el resto del SDL_Event se reconstruye en cero
+	struct RecordedEvent
+	{
+		uint32_t m_type;
+		int32_t m_data[5];
+	};
+
+	Mode m_mode;
+	uint32_t m_seed;
+	float m_step;
+	unsigned int m_replayStep;
+
+	std::vector<RecordedEvent> m_events;
+	std::vector<uint32_t> m_stepEnds;		// Índice final (exclusivo) en m_events de cada paso
+	std::vector<uint32_t> m_checksums;
+
+	// Private functions
+	static bool Pack(const SDL_Event& event, RecordedEvent& recorded);
+	static void Unpack(const RecordedEvent& recorded, uint32_t timestamp, SDL_Event& event);
+};
+
+#endif // !__INPUTRECORDER_H__
@@ -0,0 +1,233 @@
+#include "InstanceBuffer.h"
+#include "GLState.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+InstanceBuffer::InstanceBuffer() :
+	m_buffer(0),
+	m_usage(GL_DYNAMIC_DRAW),
+	m_stride(0),
+	m_count(0),
+	m_gpuCapacity(0),
+	m_dirtyBegin(0),
+	m_dirtyEnd(0)
+{}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	Destroy();
+}
+
+// -------------------
+// Descripción: Función que crea el búfer de la GPU con sitio para 'capacity' instancias de 'stride' bytes
+// -------------------
+void InstanceBuffer::Init(unsigned int stride, unsigned int capacity, GLenum usage)
+{
+	Destroy();
+
+	m_stride = stride;
+	m_usage = usage;
+	m_gpuCapacity = std::max(capacity, 1u);
+	m_data.reserve(m_gpuCapacity * m_stride);
+
+	glGenBuffers(1, &m_buffer);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+	glBufferData(GL_ARRAY_BUFFER, m_gpuCapacity * m_stride, nullptr, m_usage);
+}
+
+// -------------------
+// Descripción: Función que prepara el formato de una matriz de modelo por instancia (cuatro columnas vec4)
+// -------------------
+void InstanceBuffer::InitTransforms(unsigned int capacity, GLenum usage)
+{
+	Init(sizeof(glm::mat4), capacity, usage);
+
+	for (GLuint i = 0; i < 4; ++i)
+		AddAttribute(TRANSFORM_ATTRIBUTE + i, 4, GL_FLOAT, i * sizeof(glm::vec4));
+}
+
+void InstanceBuffer::AddAttribute(GLuint location, GLint components, GLenum type, unsigned int offset, GLboolean normalized)
+{
+	Attribute attribute;
+	attribute.m_location = location;
+	attribute.m_components = components;
+	attribute.m_type = type;
+	attribute.m_normalized = normalized;
+	attribute.m_offset = offset;
+	m_attributes.push_back(attribute);
+}
+
+// -------------------
+// Descripción: Función que engancha los atributos de instancia al VAO (divisor 1). Los enteros sin normalizar se leen
+// como enteros en el sombreador (glVertexAttribIPointer).
+// -------------------
+void InstanceBuffer::Attach(GLuint vao)
+{
+	if (m_buffer == 0)
+	{
+		printf("ERROR: Instance buffer attached before Init\n");
+		return;
+	}
+
+	GLState::GetInstance().BindVertexArray(vao);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+	for (auto iter = m_attributes.begin(); iter != m_attributes.end(); ++iter)
+	{
+		const Attribute& attribute = *iter;
+		bool integer = attribute.m_type != GL_FLOAT && attribute.m_type != GL_HALF_FLOAT && !attribute.m_normalized;
+
+		glEnableVertexAttribArray(attribute.m_location);
+
+		if (integer)
+			glVertexAttribIPointer(attribute.m_location, attribute.m_components, attribute.m_type, m_stride, (GLvoid*)(size_t)attribute.m_offset);
+		else
+			glVertexAttribPointer(attribute.m_location, attribute.m_components, attribute.m_type, attribute.m_normalized, m_stride, (GLvoid*)(size_t)attribute.m_offset);
+
+		glVertexAttribDivisor(attribute.m_location, 1);
+	}
+
+	GLState::GetInstance().BindVertexArray(0);
+}
+
+void InstanceBuffer::Destroy()
+{
+	if (m_buffer != 0)
+		GLState::GetInstance().DeleteBuffers(1, &m_buffer);
+
+	m_buffer = 0;
+	m_count = m_gpuCapacity = 0;
+	m_dirtyBegin = m_dirtyEnd = 0;
+	m_data.clear();
+	m_attributes.clear();
+}
+
+// -------------------
+// Descripción: Función que añade una instancia al final y devuelve su índice
+// -------------------
+unsigned int InstanceBuffer::Add(const void* instance)
+{
+	unsigned int index = m_count;
+	Resize(m_count + 1);
+	Set(index, instance);
+	return index;
+}
+
+void InstanceBuffer::Set(unsigned int index, const void* instance)
+{
+	SetRange(index, 1, instance);
+}
+
+void InstanceBuffer::SetRange(unsigned int first, unsigned int count, const void* instances)
+{
+	if (first + count > m_count)
+	{
+		printf("ERROR: Instance range %u-%u out of bounds (%u instances)\n", first, first + count, m_count);
+		return;
+	}
+
+	std::memcpy(&m_data[first * m_stride], instances, count * m_stride);
+	MarkDirty(first, count);
+}
+
+// -------------------
+// Descripción: Función que quita una instancia moviendo la última a su sitio (el orden no se conserva)
+// -------------------
+void InstanceBuffer::Remove(unsigned int index)
+{
+	if (index >= m_count)
+		return;
+
+	unsigned int last = m_count - 1;
+
+	if (index != last)
+	{
+		std::memcpy(&m_data[index * m_stride], &m_data[last * m_stride], m_stride);
+		MarkDirty(index, 1);
+	}
+
+	Resize(last);
+}
+
+// -------------------
+// Descripción: Función que cambia el número de instancias. Al crecer, las nuevas quedan marcadas para subirse aunque
+// se escriban después con GetInstance; al encoger, el rango sucio se recorta.
+// -------------------
+void InstanceBuffer::Resize(unsigned int count)
+{
+	unsigned int previous = m_count;
+
+	m_count = count;
+	m_data.resize(count * m_stride);
+
+	if (count > previous)
+		MarkDirty(previous, count - previous);
+	else
+	{
+		m_dirtyEnd = std::min(m_dirtyEnd, m_count);
+		m_dirtyBegin = std::min(m_dirtyBegin, m_dirtyEnd);
+	}
+}
+
+// -------------------
+// Descripción: Función que asegura sitio en la GPU para 'capacity' instancias sin tocar las de la CPU (para búferes
+// que escribe la propia GPU, como el destino de GpuCuller). Al crecer se pierde el contenido de la GPU.
+// -------------------
+void InstanceBuffer::Reserve(unsigned int capacity)
+{
+	if (m_buffer == 0 || capacity <= m_gpuCapacity)
+		return;
+
+	while (m_gpuCapacity < capacity)
+		m_gpuCapacity *= 2;
+
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+	glBufferData(GL_ARRAY_BUFFER, m_gpuCapacity * m_stride, nullptr, m_usage);
+	m_dirtyBegin = 0;
+	m_dirtyEnd = m_count;
+}
+
+void InstanceBuffer::Clear()
+{
+	Resize(0);
+}
+
+// -------------------
+// Descripción: Función que sube las instancias modificadas desde el último Upload
+// -------------------
+void InstanceBuffer::Upload()
+{
+	if (m_buffer == 0 || m_count == 0)
+		return;
+
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+	if (m_count > m_gpuCapacity)
+	{
+		while (m_gpuCapacity < m_count)
+			m_gpuCapacity *= 2;
+
+		glBufferData(GL_ARRAY_BUFFER, m_gpuCapacity * m_stride, nullptr, m_usage);
+		m_dirtyBegin = 0;
+		m_dirtyEnd = m_count;
+	}
+
+	if (m_dirtyEnd > m_dirtyBegin)
+		glBufferSubData(GL_ARRAY_BUFFER, m_dirtyBegin * m_stride, (m_dirtyEnd - m_dirtyBegin) * m_stride, &m_data[m_dirtyBegin * m_stride]);
+
+	m_dirtyBegin = m_dirtyEnd = 0;
+}
+
+void InstanceBuffer::MarkDirty(unsigned int first, unsigned int count)
+{
+	if (m_dirtyEnd == m_dirtyBegin)
+	{
+		m_dirtyBegin = first;
+		m_dirtyEnd = first + count;
+		return;
+	}
+
+	m_dirtyBegin = std::min(m_dirtyBegin, first);
+	m_dirtyEnd = std::max(m_dirtyEnd, first + count);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef __INSTANCEBUFFER_H__
+#define __INSTANCEBUFFER_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <vector>
+
+// Búfer de datos por instancia que se puede enganchar a cualquier VAO (las mallas de un Model, un GameObject...).
+// El formato lo decide quien lo crea: un tamaño por instancia y la lista de atributos con su posición dentro de ella.
+// Las instancias viven en la CPU; Upload() sube solo el rango modificado y, si ya no caben, hace crecer el búfer de la
+// GPU al doble conservando su nombre, así los VAO enganchados siguen siendo válidos.
+class InstanceBuffer
+{
+public:
+	// Una matriz por instancia ocupa las posiciones 3 a 6 (layout (location = 3) in mat4 en el sombreador)
+	enum { TRANSFORM_ATTRIBUTE = 3 };
+
+	InstanceBuffer();
+	~InstanceBuffer();
+
+	InstanceBuffer(InstanceBuffer const&) = delete;
+	void operator=(InstanceBuffer const&) = delete;
+
+	void Init(unsigned int stride, unsigned int capacity = 64, GLenum usage = GL_DYNAMIC_DRAW);
+	void InitTransforms(unsigned int capacity = 64, GLenum usage = GL_DYNAMIC_DRAW);
+	void AddAttribute(GLuint location, GLint components, GLenum type, unsigned int offset, GLboolean normalized = GL_FALSE);
+	void Attach(GLuint vao);
+	void Destroy();
+
+	unsigned int Add(const void* instance);
+	unsigned int AddTransform(const glm::mat4& transform) { return Add(&transform); }
+	void Set(unsigned int index, const void* instance);
+	void SetRange(unsigned int first, unsigned int count, const void* instances);
+	void Remove(unsigned int index);
+	void Resize(unsigned int count);
+	void Reserve(unsigned int capacity);
+	void Clear();
+	void Upload();
+
+	// Para quien escribe directamente con GetInstance (p. ej. desde varios hilos): avisa del rango que hay que subir
+	void MarkDirty(unsigned int first, unsigned int count);
+
+	void* GetInstance(unsigned int index) { return &m_data[index * m_stride]; }
+	unsigned int GetCount() const { return m_count; }
+	unsigned int GetStride() const { return m_stride; }
+	GLuint GetBuffer() const { return m_buffer; }
+
+private:
+	struct Attribute
+	{
+		GLuint m_location;
+		GLint m_components;
+		GLenum m_type;
+		GLboolean m_normalized;
+		unsigned int m_offset;
+	};
+
+	GLuint m_buffer;
+	GLenum m_usage;
+	unsigned int m_stride, m_count, m_gpuCapacity;
+	unsigned int m_dirtyBegin, m_dirtyEnd;
+	std::vector<unsigned char> m_data;
+	std::vector<Attribute> m_attributes;
+};
+
+#endif // !__INSTANCEBUFFER_H__
@@ -0,0 +1,79 @@
+#include "InstancedBatch.h"
+#include "GLState.h"
+#include <cstddef>
+
+InstancedBatch::InstancedBatch() :
+	m_object(nullptr),
+	m_instanceVbo(0),
+	m_capacity(0)
+{}
+
+InstancedBatch::~InstancedBatch()
+{
+	if (m_instanceVbo)
+		GLState::GetInstance().DeleteBuffers(1, &m_instanceVbo);
+}
+
+// -------------------
+// Descripción: Función que crea el buffer de instancias y lo engancha al VAO del objeto con divisor 1
+// -------------------
+void InstancedBatch::Init(GameObject& object, unsigned int capacity)
+{
+	m_object = &object;
+	m_capacity = capacity;
+	m_instances.reserve(capacity);
+
+	glGenBuffers(1, &m_instanceVbo);
+	GLState::GetInstance().BindVertexArray(object.GetVao());
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Instance) * capacity, nullptr, GL_STREAM_DRAW);
+
+	for (GLuint i = 0; i < 3; ++i)
+	{
+		glEnableVertexAttribArray(INSTANCE_ATTRIBUTE + i);
+		glVertexAttribPointer(INSTANCE_ATTRIBUTE + i, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (GLvoid*)(i * sizeof(glm::vec4)));
+		glVertexAttribDivisor(INSTANCE_ATTRIBUTE + i, 1);
+	}
+
+	GLState::GetInstance().BindVertexArray(0);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstancedBatch::Add(const glm::vec3& pos, float scale, const glm::vec4& tint, bool damaged, float spin, bool unlit)
+{
+	if (m_instances.size() >= m_capacity)
+		return;
+
+	Instance instance;
+	instance.m_posScale = glm::vec4(pos, scale);
+	instance.m_tint = tint;
+	instance.m_params = glm::vec4(damaged ? 1.0f : 0.0f, spin, unlit ? 1.0f : 0.0f, 0.0f);
+	m_instances.push_back(instance);
+}
+
+// -------------------
+// Descripción: Función que sube las instancias del cuadro (huérfano del buffer anterior para no esperar a la GPU)
+// y dibuja todas con una sola llamada
+// -------------------
+void InstancedBatch::Draw(Shader& shader, Camera& cam, SpotLight* spotlight)
+{
+	if (!m_object || m_instances.empty())
+		return;
+
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Instance) * m_capacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Instance) * m_instances.size(), m_instances.data());
+
+	glm::vec3 camPos = cam.GetCameraPos();
+
+	// La cámara y las luces llegan por los bloques compartidos (SceneUniforms)
+	shader.ActivateProgram();
+	shader.SetVec3("lightPos", glm::vec3(camPos.x, camPos.y + 5.0f, camPos.z));
+	shader.SetBool("EnableSpotlight", spotlight != nullptr);
+	shader.SetInt("meshTexture", 0);
+
+	m_object->GetTextureComponent().ActivateTexture(0);
+
+	GLState::GetInstance().BindVertexArray(m_object->GetVao());
+	GLState::GetInstance().DrawElements(GL_TRIANGLES, m_object->GetNumOfIndices(), (GLsizei)m_instances.size());
+}
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef __INSTANCEDBATCH_H__
+#define __INSTANCEDBATCH_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "GameObject.h"
+#include "Camera.h"
+#include "Shader.h"
+#include "SpotLight.h"
+#include <vector>
+
+// Lote de instancias de un GameObject: los datos por instancia de todo el cuadro se suben a un solo buffer
+// y el objeto se dibuja con una única llamada glDrawElementsInstanced, sin importar cuántas instancias haya.
+class InstancedBatch
+{
+public:
+	// 48 bytes por instancia (atributos 5, 6 y 7 del VAO del objeto)
+	struct Instance
+	{
+		glm::vec4 m_posScale;	// xyz = posición, w = escala uniforme
+		glm::vec4 m_tint;		// color que multiplica a la textura
+		glm::vec4 m_params;		// x = parpadeo de daño, y = giro en grados, z = sin iluminación
+	};
+
+	InstancedBatch();
+	~InstancedBatch();
+
+	void Init(GameObject& object, unsigned int capacity);
+	void Clear() { m_instances.clear(); }
+	void Add(const glm::vec3& pos, float scale, const glm::vec4& tint = glm::vec4(1.0f), bool damaged = false, float spin = 0.0f, bool unlit = false);
+	void Draw(Shader& shader, Camera& cam, SpotLight* spotlight = nullptr);
+
+	bool IsReady() { return m_object != nullptr; }
+	unsigned int GetCount() { return (unsigned int)m_instances.size(); }
+
+private:
+	enum { INSTANCE_ATTRIBUTE = 5 };
+
+	GameObject* m_object;
+	GLuint m_instanceVbo;
+	unsigned int m_capacity;
+	std::vector<Instance> m_instances;
+};
+
+#endif // !__INSTANCEDBATCH_H__
@@ -0,0 +1,124 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <memory>
+
+JobSystem::JobSystem() :
+	m_running(true)
+{
+	// Un hilo por núcleo, dejando uno libre para el hilo principal (render y GL)
+	unsigned int cores = std::thread::hardware_concurrency();
+	unsigned int workerCount = cores > 1 ? cores - 1 : 0;
+
+	for (unsigned int i = 0; i < workerCount; ++i)
+		m_workers.push_back(std::thread(&JobSystem::WorkerLoop, this));
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+
+	m_condition.notify_all();
+
+	for (auto iter = m_workers.begin(); iter != m_workers.end(); ++iter)
+		(*iter).join();
+}
+
+// -------------------
+// Descripción: Función que divide el rango [0, count) en lotes y los reparte entre los hilos de trabajo.
+// El hilo que llama también procesa lotes, por lo que la función no retorna hasta que todo el rango está hecho.
+// -------------------
+void JobSystem::ParallelFor(unsigned int count, unsigned int minBatchSize, const std::function<void(unsigned int, unsigned int)>& job)
+{
+	if (count == 0)
+		return;
+
+	unsigned int threads = GetWorkerCount() + 1;
+	unsigned int batchSize = std::max(minBatchSize, (count + threads - 1) / threads);
+	unsigned int batchCount = (count + batchSize - 1) / batchSize;
+
+	if (batchCount <= 1 || m_workers.empty())
+	{
+		job(0, count);
+		return;
+	}
+
+	// Estado compartido entre los lotes: el siguiente lote libre y cuántos han terminado
+	struct Batches
+	{
+		std::atomic<unsigned int> m_next;
+		std::atomic<unsigned int> m_done;
+	};
+
+	std::shared_ptr<Batches> batches = std::make_shared<Batches>();
+	batches->m_next = 0;
+	batches->m_done = 0;
+
+	auto runBatches = [batches, batchSize, batchCount, count, &job]()
+	{
+		unsigned int batch;
+
+		while ((batch = batches->m_next.fetch_add(1)) < batchCount)
+		{
+			unsigned int begin = batch * batchSize;
+			job(begin, std::min(begin + batchSize, count));
+			batches->m_done.fetch_add(1);
+		}
+	};
+
+	unsigned int helpers = std::min(GetWorkerCount(), batchCount - 1);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (unsigned int i = 0; i < helpers; ++i)
+			m_tasks.push_back(runBatches);
+	}
+
+	m_condition.notify_all();
+
+	// Si los hilos de trabajo están ocupados, el hilo principal termina los lotes por sí solo
+	runBatches();
+
+	while (batches->m_done.load() < batchCount)
+		std::this_thread::yield();
+}
+
+void JobSystem::Submit(std::function<void()> task)
+{
+	if (m_workers.empty())
+	{
+		task();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(task);
+	}
+
+	m_condition.notify_one();
+}
+
+void JobSystem::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return !m_running || !m_tasks.empty(); });
+
+			if (!m_running && m_tasks.empty())
+				return;
+
+			task = m_tasks.front();
+			m_tasks.pop_front();
+		}
+
+		task();
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef __JOBSYSTEM_H__
+#define __JOBSYSTEM_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+	~JobSystem();
+
+	static JobSystem& GetInstance()
+	{
+		static JobSystem instance;
+		return instance;
+	}
+
+	JobSystem(JobSystem const&) = delete;
+	void operator=(JobSystem const&) = delete;
+
+	void ParallelFor(unsigned int count, unsigned int minBatchSize, const std::function<void(unsigned int, unsigned int)>& job);
+	void Submit(std::function<void()> task);
+
+	unsigned int GetWorkerCount() { return (unsigned int)m_workers.size(); }
+
+private:
+	JobSystem();
+
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()> > m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_running;
+
+	// Private functions
+	void WorkerLoop();
+};
+
+#endif // !__JOBSYSTEM_H__
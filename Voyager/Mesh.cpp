@@ -1,16 +1,48 @@
 #include "Mesh.h"
+#include "GLState.h"
 #include "Player.h"
+#include <algorithm>
 
-Mesh::Mesh(std::vector<MeshVertex> vertices, std::vector<GLuint> indices, std::vector<MeshTexture> textures, bool instancing)
+// Tipos de textura de cada disposicion de samplers registrada; la disposicion n esta en la posicion n - 1
+static std::vector<std::vector<MeshTexture> >& SamplerLayouts()
+{
+	static std::vector<std::vector<MeshTexture> > layouts;
+	return layouts;
+}
+
+Mesh::Mesh(std::vector<MeshVertex> vertices, std::vector<GLuint> indices, std::vector<MeshTexture> textures) :
+	m_instances(nullptr),
+	m_indirectBuffer(0),
+	m_indirectOffset(0)
 {
 	m_vertices = vertices;
 	m_indices = indices;
 	m_textures = textures;
-	CreateMesh(instancing);
+	m_samplerLayout = GetSamplerLayout(m_textures);
+	CreateMesh();
 }
 
-void Mesh::Draw(Camera& camera, Shader shaderProgram, bool instancing, glm::vec3& pos, glm::vec3& rot, float amountOfRotation, glm::vec3& scale, bool bDrawRelativeToCamera, bool bUseSpotlight)
+// Engancha un bufer de instancias al VAO de la malla; el numero de instancias se lee de el en cada dibujo
+void Mesh::SetInstances(InstanceBuffer* instances)
 {
+	m_instances = instances;
+
+	if (m_instances != nullptr)
+		m_instances->Attach(m_vao);
+}
+
+// Con un bufer indirecto, el dibujo instanciado toma el numero de instancias de la GPU (0 lo desactiva)
+void Mesh::SetIndirect(GLuint buffer, GLintptr offset)
+{
+	m_indirectBuffer = buffer;
+	m_indirectOffset = offset;
+}
+
+void Mesh::Draw(Camera& camera, Shader& shaderProgram, bool instancing, glm::vec3& pos, glm::vec3& rot, float amountOfRotation, glm::vec3& scale, bool bDrawRelativeToCamera, bool bUseSpotlight)
+{
+	if (instancing && (m_instances == nullptr || (m_instances->GetCount() == 0 && m_indirectBuffer == 0)))
+		return;
+
 	shaderProgram.ActivateProgram();
 
 	glm::mat4 model(1.0f);
@@ -28,153 +60,156 @@ void Mesh::Draw(Camera& camera, Shader shaderProgram, bool instancing, glm::vec3
 		model = translation * rotation * scaleMat;
 	}
 
+	// Las matrices de la camara y el foco llegan por los bloques compartidos (SceneUniforms); view y projection
+	// solo se suben a los programas que aun las declaran sueltas (HUD, cielo), para los demas no hay llamada a OpenGL
 	shaderProgram.SetMat4("model", model);
+	shaderProgram.SetMat4("projection", camera.GetProjectionMatrix());
+	shaderProgram.SetMat4("view", camera.GetViewMatrix());
 	shaderProgram.SetVec3("lightPos", glm::vec3(camera.GetCameraPos().x, camera.GetCameraPos().y + 5.0f, camera.GetCameraPos().z));
-	shaderProgram.SetVec3("viewPos", glm::vec3(camera.GetCameraPos().x, camera.GetCameraPos().y, camera.GetCameraPos().z));
-	shaderProgram.SetBool("EnableSpotlight", bUseSpotlight);
+	shaderProgram.SetVec3("viewPos", camera.GetCameraPos());
+	shaderProgram.SetBool("EnableSpotlight", bUseSpotlight && Player::GetInstance().GetSpotLight() != nullptr);
 
-	if (Player::GetInstance().GetSpotLight() != nullptr && bUseSpotlight)
-	{
-		shaderProgram.SetVec3("spotlight.position", Player::GetInstance().GetSpotLight()->GetPosition());
-		shaderProgram.SetVec3("spotlight.direction", Player::GetInstance().GetSpotLight()->GetDirection());
-		shaderProgram.SetVec3("spotlight.diffuse", Player::GetInstance().GetSpotLight()->GetDiffuse());
-		shaderProgram.SetVec3("spotlight.specular", Player::GetInstance().GetSpotLight()->GetSpecular());
-		shaderProgram.SetFloat("spotlight.constant", Player::GetInstance().GetSpotLight()->GetConstant());
-		shaderProgram.SetFloat("spotlight.linear", Player::GetInstance().GetSpotLight()->GetLinear());
-		shaderProgram.SetFloat("spotlight.quadratic", Player::GetInstance().GetSpotLight()->GetQuadratic());
-		shaderProgram.SetFloat("spotlight.cutOff", glm::cos(glm::radians(Player::GetInstance().GetSpotLight()->GetCutOff())));
-		shaderProgram.SetFloat("spotlight.outerCutOff", glm::cos(glm::radians(Player::GetInstance().GetSpotLight()->GetOuterCutOff())));
-	}
-
-	unsigned int diffuseNr = 1;
-	unsigned int specularNr = 1;
+	BindSamplers(shaderProgram, m_samplerLayout);
 
 	for (unsigned int i = 0; i < m_textures.size(); ++i)
-	{
-		glActiveTexture(GL_TEXTURE0 + i);
+		GLState::GetInstance().BindTextureUnit(i, m_textures[i].m_id);
 
-		std::string number;
-		std::string name = m_textures[i].m_type;
+	GLState::GetInstance().BindVertexArray(m_vao);
 
-		if (name == "texture_diffuse")
-			number = std::to_string(diffuseNr++);
-		else if (name == "texture_specular")
-			number = std::to_string(specularNr++);
-
-		glm::mat4 projMat = camera.GetProjectionMatrix();
-		glm::mat4 viewMat = camera.GetViewMatrix();
-
-		shaderProgram.SetMat4("projection", projMat);
-		shaderProgram.SetMat4("view", viewMat);
-		glUniform1i(glGetUniformLocation(shaderProgram.GetShaderProgram(), (name + number).c_str()), i);
-
-		glBindTexture(GL_TEXTURE_2D, m_textures[i].m_id);
+	if (instancing && m_indirectBuffer != 0)
+	{
+		GLState::GetInstance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+		GLState::GetInstance().DrawElementsIndirect(GL_TRIANGLES, m_indirectOffset);
 	}
-
-	glBindVertexArray(m_vao);
-
-	if (instancing)
+	else if (instancing)
 	{
-		glDrawElementsInstanced(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0, m_totalObjectsIns);
+		GLState::GetInstance().DrawElements(GL_TRIANGLES, m_indices.size(), m_instances->GetCount());
 	}
 	else
 	{
-		glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
+		GLState::GetInstance().DrawElements(GL_TRIANGLES, m_indices.size());
 	}
 
-	glBindVertexArray(0);
+	// Las texturas y el VAO se quedan enlazados: el siguiente objeto enlaza lo suyo a traves de GLState, que se salta lo repetido
+}
+
+// Envia la malla a la cola de dibujo; no toca el estado de OpenGL (la cola pone los samplers si cambia la disposicion)
+void Mesh::Submit(RenderQueue& queue, Shader& shaderProgram, const glm::mat4& model, bool instancing, bool bUseSpotlight)
+{
+	if (instancing && (m_instances == nullptr || (m_instances->GetCount() == 0 && m_indirectBuffer == 0)))
+		return;
+
+	DrawPacket packet;
+	packet.m_shader = &shaderProgram;
+	packet.m_vao = m_vao;
+	packet.m_count = (GLsizei)m_indices.size();
+	packet.m_instanceCount = instancing ? (GLsizei)m_instances->GetCount() : 1;
+	packet.m_model = model;
+	packet.m_samplerLayout = m_samplerLayout;
 
-	// Unbind textures 
-	for (GLuint i = 0; i < m_textures.size(); ++i)
+	if (instancing)
 	{
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		packet.m_indirectBuffer = m_indirectBuffer;
+		packet.m_indirectOffset = m_indirectOffset;
 	}
-}
+	packet.m_totalTextures = (unsigned int)std::min(m_textures.size(), (size_t)DrawPacket::MAX_TEXTURES);
 
-void Mesh::CreateMesh(bool instancing)
-{
-	glGenVertexArrays(1, &m_vao);
-	glGenBuffers(1, &m_vbo);
-	glGenBuffers(1, &m_ebo);
+	for (unsigned int i = 0; i < packet.m_totalTextures; ++i)
+		packet.m_textures[i] = m_textures[i].m_id;
 
-	glBindVertexArray(m_vao);
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(MeshVertex) * m_vertices.size(), &m_vertices[0], GL_STATIC_DRAW);
+	if (bUseSpotlight && Player::GetInstance().GetSpotLight() != nullptr)
+		packet.m_flags |= DrawPacket::FLAG_SPOTLIGHT;
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * m_indices.size(), &m_indices[0], GL_STATIC_DRAW);
+	queue.Submit(RenderQueue::PASS_OPAQUE, packet);
+}
 
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glEnableVertexAttribArray(2);
+// -------------------
+// Descripcion: Funcion que busca (o registra) la disposicion de samplers de una lista de texturas. Dos mallas comparten
+// disposicion si sus texturas tienen los mismos tipos en el mismo orden, aunque sean otras imagenes.
+// -------------------
+unsigned int Mesh::GetSamplerLayout(const std::vector<MeshTexture>& textures)
+{
+	if (textures.empty())
+		return 0;
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, m_Normal));
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, m_TexCoords));
+	std::vector<std::vector<MeshTexture> >& layouts = SamplerLayouts();
 
-	if (instancing)
+	for (unsigned int layout = 0; layout < layouts.size(); ++layout)
 	{
-		m_totalObjectsIns = 20000;
-		unsigned int amount = m_totalObjectsIns;
-		m_modelMatricesIns = new glm::mat4[amount];
-		float radius = 400.0f;
-		float offset = 60.0f;
+		const std::vector<MeshTexture>& other = layouts[layout];
+		bool same = other.size() == textures.size();
 
-		for (unsigned int i = 0; i < amount; ++i)
-		{
-			glm::mat4 model(1.0f);
-			float x = 0.0f, y = 0.0f, z = 0.0f;
+		for (unsigned int i = 0; i < textures.size() && same; ++i)
+			same = other[i].m_type == textures[i].m_type;
 
-			float angle = (float)i / (float)amount * 360.0f;
-			float displacement = (rand() % (int)(2 * offset * 100)) / 100.0f - offset + 300.0f;
-			x = sin(angle) * radius + displacement;
+		if (same)
+			return layout + 1;
+	}
 
-			displacement = (rand() % (int)(2 * offset * 100)) / 100.0f - offset + 40.0f;
-			y = displacement * 3.7f;
+	layouts.push_back(textures);
+	return (unsigned int)layouts.size();
+}
 
-			displacement = (rand() % (int)(2 * offset * 100)) / 100.0f - offset + 390.0f;
-			z = cos(angle) * radius + displacement;
+// Pone los samplers de la disposicion en el programa activo, solo si GLState dice que ese programa tenia otra
+void Mesh::BindSamplers(Shader& shaderProgram, unsigned int layout)
+{
+	if (layout == 0 || !GLState::GetInstance().SetSamplerLayout(shaderProgram.GetShaderProgram(), layout))
+		return;
 
-			model = glm::translate(model, glm::vec3(x, y, z));
+	BindSamplers(shaderProgram, SamplerLayouts()[layout - 1]);
+}
 
-			float scale = (rand() % 25) / 100.0f + 0.35f;
-			model = glm::scale(model, glm::vec3(scale));
+// Asocia cada sampler (texture_diffuse1, texture_specular1...) con la unidad de su textura; el programa debe estar activo
+void Mesh::BindSamplers(Shader& shaderProgram, const std::vector<MeshTexture>& textures)
+{
+	unsigned int diffuseNr = 1;
+	unsigned int specularNr = 1;
 
-			float rotAngle = (rand() % 360);
-			model = glm::rotate(model, rotAngle, glm::vec3(0.5f, 0.7f, 0.9f));
+	for (unsigned int i = 0; i < textures.size(); ++i)
+	{
+		std::string number;
+		std::string name = textures[i].m_type;
 
-			m_modelMatricesIns[i] = model;
-		}
+		if (name == "texture_diffuse")
+			number = std::to_string(diffuseNr++);
+		else if (name == "texture_specular")
+			number = std::to_string(specularNr++);
+
+		shaderProgram.SetInt(name + number, i);
+	}
+}
+
+// Borra el VAO y los buferes de la malla (las texturas no son suyas, las suelta ModelCache)
+void Mesh::Destroy()
+{
+	if (m_vao != 0)
+		GLState::GetInstance().DeleteVertexArrays(1, &m_vao);
 
-		unsigned int instanceVBO;
-		glGenBuffers(1, &instanceVBO);
-		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * amount, &m_modelMatricesIns[0], GL_STATIC_DRAW);
+	GLuint buffers[] = { m_vbo, m_ebo };
+	GLState::GetInstance().DeleteBuffers(2, buffers);
+	m_vao = m_vbo = m_ebo = 0;
+}
 
-		for (unsigned int i = 0; i < 1; ++i)
-		{
-			glBindVertexArray(m_vao);
+void Mesh::CreateMesh()
+{
+	glGenVertexArrays(1, &m_vao);
+	glGenBuffers(1, &m_vbo);
+	glGenBuffers(1, &m_ebo);
 
-			GLsizei mat4Size = sizeof(glm::mat4);
-			glEnableVertexAttribArray(3);
-			glEnableVertexAttribArray(4);
-			glEnableVertexAttribArray(5);
-			glEnableVertexAttribArray(6);
+	GLState::GetInstance().BindVertexArray(m_vao);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(MeshVertex) * m_vertices.size(), &m_vertices[0], GL_STATIC_DRAW);
 
-			glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, mat4Size, (GLvoid*)0);
-			glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, mat4Size, (GLvoid*)(sizeof(glm::vec4)));
-			glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, mat4Size, (GLvoid*)(2 * sizeof(glm::vec4)));
-			glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, mat4Size, (GLvoid*)(3 * sizeof(glm::vec4)));
+	GLState::GetInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * m_indices.size(), &m_indices[0], GL_STATIC_DRAW);
 
-			glVertexAttribDivisor(3, 1);
-			glVertexAttribDivisor(4, 1);
-			glVertexAttribDivisor(5, 1);
-			glVertexAttribDivisor(6, 1);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
 
-			glBindVertexArray(0);
-		}
-	}
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, m_Normal));
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, m_TexCoords));
 
-	glBindVertexArray(0);
+	GLState::GetInstance().BindVertexArray(0);
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <string>
 #include <vector>
 #include "Shader.h"
+#include "RenderQueue.h"
+#include "InstanceBuffer.h"
 #include <sstream>
 #include "Camera.h"
 #include <cstdlib>
@@ -43,24 +45,39 @@ public:
 class Mesh
 {
 public:
-	Mesh(std::vector<MeshVertex> vertices, std::vector<GLuint> indices, std::vector<MeshTexture> textures, bool instancing);
+	Mesh(std::vector<MeshVertex> vertices, std::vector<GLuint> indices, std::vector<MeshTexture> textures);
 
-	glm::mat4* GetModelMatIns() { return m_modelMatricesIns; }
+	void SetInstances(InstanceBuffer* instances);
+	InstanceBuffer* GetInstances() { return m_instances; }
+	void SetIndirect(GLuint buffer, GLintptr offset);
+	const std::vector<MeshVertex>& GetVertices() const { return m_vertices; }
+	const std::vector<GLuint>& GetIndices() const { return m_indices; }
+	const std::vector<MeshTexture>& GetTextures() const { return m_textures; }
 
 	void SetTransform(Transform& transform) { m_transform = transform; }
-	void Draw(Camera& camera, Shader program, bool instancing, glm::vec3& pos = glm::vec3(1.0f), glm::vec3& rot = glm::vec3(1.0f), float amountOfRotation = 1.0f,
+	void Draw(Camera& camera, Shader& program, bool instancing, glm::vec3& pos = glm::vec3(1.0f), glm::vec3& rot = glm::vec3(1.0f), float amountOfRotation = 1.0f,
 		glm::vec3& scale = glm::vec3(1.0f), bool bDrawRelativeToCamera = false, bool bUseSpotlight = false);
+	void Submit(RenderQueue& queue, Shader& program, const glm::mat4& model, bool instancing, bool bUseSpotlight = false);
+	void Destroy();
+	unsigned int GetSamplerLayout() const { return m_samplerLayout; }
+
+	// Disposicion de samplers: un numero por cada secuencia distinta de tipos de textura (0 si no hay texturas)
+	static unsigned int GetSamplerLayout(const std::vector<MeshTexture>& textures);
+	static void BindSamplers(Shader& program, unsigned int layout);
+	static void BindSamplers(Shader& program, const std::vector<MeshTexture>& textures);
 
 private:
 	GLuint m_vao, m_vbo, m_ebo;
 	Transform m_transform;
-	glm::mat4* m_modelMatricesIns;
-	float m_totalObjectsIns;
+	InstanceBuffer* m_instances;
+	GLuint m_indirectBuffer;
+	GLintptr m_indirectOffset;
 	std::vector<MeshVertex> m_vertices;
 	std::vector<GLuint> m_indices;
 	std::vector<MeshTexture> m_textures;
+	unsigned int m_samplerLayout;
 
-	void CreateMesh(bool instancing);
+	void CreateMesh();
 };
 
 #endif // !__MESH_H__
\ No newline at end of file
@@ -1,183 +1,183 @@
 #include "Model.h"
-#include "Dependencies\soil\include\SOIL.h"
+#include "GLState.h"
 //creacion de modelos
-GLint Model::TextureFromFile(const char* path, std::string directory)
-{
-	std::string filename = std::string(path);
-	filename = directory + '/' + filename;
-
-	GLuint textureID;
-	glGenTextures(1, &textureID);
-
-	int width, height;
-	unsigned char* image = SOIL_load_image(filename.c_str(), &width, &height, 0, SOIL_LOAD_RGB);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-	glGenerateMipmap(GL_TEXTURE_2D);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-	SOIL_free_image_data(image);
-
-	return textureID;
-}
+Model::Model() :
+	m_useSpotlight(false),
+	m_data(std::make_shared<ModelData>()),
+	m_position(0.0f, 0.0f, 0.0f),
+	m_rotation(0.0f, 1.0f, 0.0f),
+	m_scale(1.0f, 1.0f, 1.0f),
+	m_rotationAngle(0.0f)
+{}
 
 void Model::Init(GLchar* path, Camera& camera, char* vs, char* fs, bool instancing)
 {
-	m_shader.CreateProgram(vs, fs);
+	ModelCache& cache = ModelCache::GetInstance();
+	m_shader = cache.LoadShader(vs, fs);
 	m_camera = camera;
 	m_instancing = instancing;
-	loadModel(path);
+
+	// Un modelo instanciado engancha su bufer de instancias a los VAO de sus mallas: necesita unas propias
+	m_data = instancing ? cache.LoadUnique(path) : cache.Load(path);
 }
 
 void Model::Draw(Camera& cam, bool bDrawRelativeToCamera)
 {
-	for (GLuint i = 0; i < meshes.size(); ++i)
+	for (GLuint i = 0; i < m_data->m_meshes.size(); ++i)
 	{
-		meshes[i].Draw(cam, m_shader, false, m_position, m_rotation, m_rotationAngle, m_scale, bDrawRelativeToCamera, m_useSpotlight);
+		m_data->m_meshes[i].Draw(cam, m_shader, false, m_position, m_rotation, m_rotationAngle, m_scale, bDrawRelativeToCamera, m_useSpotlight);
 	}
 }
 
 void Model::Draw(Camera& cam, glm::vec3& pos, glm::vec3& rot, float amountOfRotation, glm::vec3& scale, bool bDrawRelativeToCamera)
 {
-	for (GLuint i = 0; i < meshes.size(); ++i)
+	for (GLuint i = 0; i < m_data->m_meshes.size(); ++i)
 	{
-		meshes[i].Draw(cam, m_shader, false, pos, rot, amountOfRotation, scale, bDrawRelativeToCamera, m_useSpotlight);
+		m_data->m_meshes[i].Draw(cam, m_shader, false, pos, rot, amountOfRotation, scale, bDrawRelativeToCamera, m_useSpotlight);
 	}
 }
 
 void Model::DrawInstanced(Camera& cam)
 {
-	for (GLuint i = 0; i < meshes.size(); ++i)
+	for (GLuint i = 0; i < m_data->m_meshes.size(); ++i)
 	{
-		meshes[i].Draw(cam, m_shader, true);
+		m_data->m_meshes[i].Draw(cam, m_shader, true);
 	}
 }
 
-void Model::SetTransform(glm::vec3 pos, glm::vec3 rot, float rotAmountInDegrees, glm::vec3 scale)
+void Model::Submit(RenderQueue& queue, Camera& cam, bool bDrawRelativeToCamera)
 {
-	m_position = pos;
-	m_rotation = rot;
-	m_rotationAngle = rotAmountInDegrees;
-	m_scale = scale;
+	glm::mat4 model = GetModelMatrix();
+
+	if (bDrawRelativeToCamera)
+		model = glm::inverse(cam.GetViewMatrix()) * model;
+
+	for (GLuint i = 0; i < m_data->m_meshes.size(); ++i)
+	{
+		m_data->m_meshes[i].Submit(queue, m_shader, model, false, m_useSpotlight);
+	}
 }
 
-void Model::loadModel(std::string path)
+void Model::SubmitInstanced(RenderQueue& queue)
 {
-	Assimp::Importer importer;
-	const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+	for (GLuint i = 0; i < m_data->m_meshes.size(); ++i)
+	{
+		m_data->m_meshes[i].Submit(queue, m_shader, glm::mat4(1.0f), true);
+	}
+}
 
-	if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+// Engancha el mismo bufer de instancias a todas las mallas; DrawInstanced y SubmitInstanced dibujan sus instancias
+void Model::SetInstances(InstanceBuffer* instances)
+{
+	if (m_data->m_shared)
 	{
-		printf("ERROR: Unable to load model\n");
+		printf("ERROR: Instances set on a shared model, initialise it with instancing enabled\n");
 		return;
 	}
 
-	directory = path.substr(0, path.find_last_of('/'));
-	processNode(scene->mRootNode, scene);
+	for (GLuint i = 0; i < m_data->m_meshes.size(); ++i)
+		m_data->m_meshes[i].SetInstances(instances);
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+// Dibujo instanciado indirecto: la malla i lee el comando i del bufer (0 vuelve al numero de instancias de la CPU)
+void Model::SetIndirect(GLuint buffer, GLintptr stride)
 {
-	for (GLuint i = 0; i < node->mNumMeshes; i++)
+	if (m_data->m_shared)
 	{
-		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		meshes.push_back(processMesh(mesh, scene));
+		printf("ERROR: Indirect buffer set on a shared model, initialise it with instancing enabled\n");
+		return;
 	}
 
-	for (GLuint i = 0; i < node->mNumChildren; i++)
-	{
-		processNode(node->mChildren[i], scene);
-	}
+	for (GLuint i = 0; i < m_data->m_meshes.size(); ++i)
+		m_data->m_meshes[i].SetIndirect(buffer, buffer != 0 ? i * stride : 0);
+}
+
+void Model::SetTransform(glm::vec3 pos, glm::vec3 rot, float rotAmountInDegrees, glm::vec3 scale)
+{
+	m_position = pos;
+	m_rotation = rot;
+	m_rotationAngle = rotAmountInDegrees;
+	m_scale = scale;
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+glm::mat4 Model::GetModelMatrix()
 {
-	std::vector<MeshVertex> vertices;
-	std::vector<GLuint> indices;
-	std::vector<MeshTexture> textures;
+	return glm::translate(m_position) * glm::rotate(m_rotationAngle, m_rotation) * glm::scale(m_scale);
+}
 
-	for (GLuint i = 0; i < mesh->mNumVertices; i++)
-	{
-		MeshVertex vertex;
-		glm::vec3 vector;
-		vector.x = mesh->mVertices[i].x;
-		vector.y = mesh->mVertices[i].y;
-		vector.z = mesh->mVertices[i].z;
-		vertex.m_Position = vector;
-
-		vector.x = mesh->mNormals[i].x;
-		vector.y = mesh->mNormals[i].y;
-		vector.z = mesh->mNormals[i].z;
-		vertex.m_Normal = vector;
-
-		if (mesh->mTextureCoords[0])
-		{
-			glm::vec2 vec;
-			vec.x = mesh->mTextureCoords[0][i].x;
-			vec.y = mesh->mTextureCoords[0][i].y;
-			vertex.m_TexCoords = vec;
-		}
-		else
-			vertex.m_TexCoords = glm::vec2(0.0f, 0.0f);
-
-		vertices.push_back(vertex);
-	}
+// Caja en espacio del mundo que contiene la caja local transformada (centro transformado y extension por |M|)
+AABB Model::GetWorldBounds()
+{
+	glm::mat4 model = GetModelMatrix();
+	const AABB& local = m_data->m_localBounds;
+	glm::vec3 center = glm::vec3(model * glm::vec4((local.m_min + local.m_max) * 0.5f, 1.0f));
+	glm::vec3 extent = (local.m_max - local.m_min) * 0.5f;
+	glm::mat3 absolute(glm::abs(glm::vec3(model[0])), glm::abs(glm::vec3(model[1])), glm::abs(glm::vec3(model[2])));
+	extent = absolute * extent;
+
+	AABB bounds;
+	bounds.m_min = center - extent;
+	bounds.m_max = center + extent;
+	return bounds;
+}
 
-	for (GLuint i = 0; i < mesh->mNumFaces; i++)
-	{
-		aiFace face = mesh->mFaces[i];
+// Junta los triangulos de todas las mallas y carga (o construye y guarda) su BVH junto al archivo del modelo.
+// El BVH es de los datos compartidos: la primera copia lo construye y las demas lo reutilizan.
+bool Model::BuildCollider()
+{
+	if (m_data->m_collider.IsBuilt())
+		return true;
 
-		for (GLuint j = 0; j < face.mNumIndices; j++)
-			indices.push_back(face.mIndices[j]);
-	}
+	const std::vector<Mesh>& meshes = m_data->m_meshes;
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> indices;
 
-	if (mesh->mMaterialIndex >= 0)
+	for (GLuint i = 0; i < meshes.size(); ++i)
 	{
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+		unsigned int offset = (unsigned int)positions.size();
 
-		std::vector<MeshTexture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-		textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-		std::vector<MeshTexture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-		textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+		for (auto iter = meshes[i].GetVertices().begin(); iter != meshes[i].GetVertices().end(); ++iter)
+			positions.push_back((*iter).m_Position);
+
+		for (auto iter = meshes[i].GetIndices().begin(); iter != meshes[i].GetIndices().end(); ++iter)
+			indices.push_back(*iter + offset);
 	}
 
-	return Mesh(vertices, indices, textures, m_instancing);
+	return m_data->m_collider.LoadOrBuild(m_data->m_path, positions, indices);
 }
 
-std::vector<MeshTexture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName)
+bool Model::Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, float& distance)
 {
-	std::vector<MeshTexture> textures;
-	for (GLuint i = 0; i < mat->GetTextureCount(type); i++)
-	{
-		aiString str;
-		mat->GetTexture(type, i, &str);
-		GLboolean skip = false;
-
-		for (GLuint j = 0; j < textures_loaded.size(); j++)
-		{
-			if (textures_loaded[j].m_path == str)
-			{
-				textures.push_back(textures_loaded[j]);
-				skip = true;
-				break;
-			}
-		}
-
-		if (!skip)
-		{
-			MeshTexture texture;
-			texture.m_id = TextureFromFile(str.C_Str(), directory);
-			texture.m_type = typeName;
-			texture.m_path = str;
-			textures.push_back(texture);
-			textures_loaded.push_back(texture);
-		}
-	}
+	glm::mat4 toLocal = glm::inverse(GetModelMatrix());
+	glm::vec3 localDir = glm::normalize(glm::vec3(toLocal * glm::vec4(dir, 0.0f)));
+	glm::vec3 normal;
+
+	if (!m_data->m_collider.Raycast(glm::vec3(toLocal * glm::vec4(origin, 1.0f)), localDir, maxDistance / m_scale.x, distance, normal))
+		return false;
+
+	distance *= m_scale.x;
+	return true;
+}
+
+bool Model::SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, float& t, glm::vec3& normal)
+{
+	glm::mat4 toWorld = GetModelMatrix();
+	glm::mat4 toLocal = glm::inverse(toWorld);
+
+	if (!m_data->m_collider.SweepSphere(glm::vec3(toLocal * glm::vec4(start, 1.0f)), glm::vec3(toLocal * glm::vec4(end, 1.0f)), radius / m_scale.x, t, normal))
+		return false;
+
+	normal = glm::normalize(glm::vec3(toWorld * glm::vec4(normal, 0.0f)));
+	return true;
+}
+
+bool Model::ClosestPoint(const glm::vec3& point, float maxDistance, glm::vec3& closest)
+{
+	glm::mat4 toWorld = GetModelMatrix();
+
+	if (!m_data->m_collider.ClosestPoint(glm::vec3(glm::inverse(toWorld) * glm::vec4(point, 1.0f)), maxDistance / m_scale.x, closest))
+		return false;
 
-	return textures;
+	closest = glm::vec3(toWorld * glm::vec4(closest, 1.0f));
+	return true;
 }
\ No newline at end of file
@@ -5,35 +5,52 @@
 #include "Mesh.h"
 #include <string>
 #include "Transformation.h"
+#include "TriangleBVH.h"
+#include "DynamicAABBTree.h"
+#include "ModelCache.h"
 
+// Las mallas, texturas, colision y programa vienen de ModelCache y se comparten entre todas las copias del mismo
+// archivo; cada Model solo guarda lo suyo (transformacion, foco). Los modelos instanciados tienen mallas propias.
 class Model
 {
 public:
-	Model() {}
+	Model();
 
-	GLint TextureFromFile(const char* path, std::string directory);
 	void Init(GLchar* path, Camera& camera, char* vs, char* fs, bool instancing);
 	void Draw(Camera& cam, bool bDrawRelativeToCamera = false);
 	void Draw(Camera& cam, glm::vec3& pos = glm::vec3(1.0f), glm::vec3& rot = glm::vec3(1.0f), float amountOfRotation = 0.0f, glm::vec3& scale = glm::vec3(1.0f), bool bDrawRelativeToCamera = false);
 	void DrawInstanced(Camera& cam);
+	void Submit(RenderQueue& queue, Camera& cam, bool bDrawRelativeToCamera = false);
+	void SubmitInstanced(RenderQueue& queue);
 
 	void SetTransform(glm::vec3 pos, glm::vec3 rot, float rotAmountInDegrees, glm::vec3 scale);
 	void SetSpotlight(bool useSpotlight) { m_useSpotlight = useSpotlight; }
+	void SetInstances(InstanceBuffer* instances);
+	void SetIndirect(GLuint buffer, GLintptr stride);
 	Shader& GetShaderProgram() { return m_shader; }
+	const std::vector<Mesh>& GetMeshes() const { return m_data->m_meshes; }
+	const ModelHandle& GetData() const { return m_data; }
+
+	// Colision con la malla (consultas en espacio del mundo; se asume escala uniforme)
+	bool BuildCollider();
+	bool Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, float& distance);
+	bool SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, float& t, glm::vec3& normal);
+	bool ClosestPoint(const glm::vec3& point, float maxDistance, glm::vec3& closest);
+	glm::mat4 GetModelMatrix();
+
+	// Volumen envolvente en espacio local (calculado al cargar) y en espacio del mundo con la transformacion actual
+	const AABB& GetLocalBounds() const { return m_data->m_localBounds; }
+	float GetBoundingRadius() const { return m_data->m_boundingRadius; }
+	AABB GetWorldBounds();
+	const TriangleBVH& GetCollider() const { return m_data->m_collider; }
 
-	std::vector<Mesh> meshes;
 	GLuint program;
 	bool m_instancing = false;
-	std::vector<MeshTexture> textures_loaded;
 
 private:
-	void loadModel(std::string path);
-	void processNode(aiNode* node, const aiScene* scene);
-	Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-	std::vector<MeshTexture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
 	bool m_useSpotlight;
 
-	std::string directory;
+	ModelHandle m_data;
 	Shader m_shader;
 	Camera m_camera;
 	glm::vec3 m_position, m_rotation, m_scale;
@@ -0,0 +1,296 @@
+#include "ModelCache.h"
+#include "GLState.h"
+#include "Dependencies\soil\include\SOIL.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+
+ModelData::ModelData() :
+	m_boundingRadius(0.0f),
+	m_shared(false)
+{}
+
+ModelCache::ModelCache()
+{
+	std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+// No borra nada de la GPU: al destruirse la instancia estática el contexto de OpenGL puede no existir ya (ver Clear)
+ModelCache::~ModelCache()
+{}
+
+// -------------------
+// Descripción: Función que devuelve el modelo de la ruta, leyéndolo solo la primera vez. Si la carga falla también
+// se guarda (vacío), así las copias siguientes no vuelven a intentarlo ni repiten el error.
+// -------------------
+ModelHandle ModelCache::Load(const std::string& path)
+{
+	auto found = m_models.find(path);
+
+	if (found != m_models.end())
+	{
+		++m_stats.m_modelHits;
+		return found->second;
+	}
+
+	ModelHandle data = std::make_shared<ModelData>();
+	LoadModel(path, *data);
+	data->m_shared = true;
+	m_models[path] = data;
+	return data;
+}
+
+// -------------------
+// Descripción: Función que carga una copia privada del modelo, fuera de la caché. Es para los modelos instanciados:
+// su búfer de instancias se engancha a los VAO de las mallas, así que no pueden compartirlos. Las texturas sí se
+// comparten. La copia queda registrada para que Purge y Clear borren sus mallas como las del resto.
+// -------------------
+ModelHandle ModelCache::LoadUnique(const std::string& path)
+{
+	ModelHandle data = std::make_shared<ModelData>();
+	LoadModel(path, *data);
+	m_uniqueModels.push_back(data);
+	return data;
+}
+
+GLuint ModelCache::LoadTexture(const std::string& path)
+{
+	auto found = m_textures.find(path);
+
+	if (found != m_textures.end())
+	{
+		++m_stats.m_textureHits;
+		return found->second;
+	}
+
+	GLuint textureID;
+	glGenTextures(1, &textureID);
+
+	int width, height;
+	unsigned char* image = SOIL_load_image(path.c_str(), &width, &height, 0, SOIL_LOAD_RGB);
+
+	if (image == nullptr)
+		printf("ERROR: Unable to load texture %s\n", path.c_str());
+
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, textureID);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
+	SOIL_free_image_data(image);
+
+	m_textures[path] = textureID;
+	++m_stats.m_textureLoads;
+	return textureID;
+}
+
+// La copia de un Shader comparte el programa y la tabla de uniformes: compilar una vez basta para todos los modelos
+Shader ModelCache::LoadShader(const char* vs, const char* fs)
+{
+	std::string key = std::string(vs) + '|' + fs;
+	auto found = m_shaders.find(key);
+
+	if (found != m_shaders.end())
+	{
+		++m_stats.m_shaderHits;
+		return found->second;
+	}
+
+	Shader& shader = m_shaders[key];
+	shader.CreateProgram(vs, fs);
+	++m_stats.m_shaderLoads;
+	return shader;
+}
+
+// -------------------
+// Descripción: Función que suelta los modelos que solo sigue teniendo la caché (ningún Model los usa ya) y borra sus
+// mallas de la GPU. Las texturas y los programas se quedan hasta Clear: pueden volver a pedirse con otro modelo.
+// -------------------
+void ModelCache::Purge()
+{
+	for (auto iter = m_models.begin(); iter != m_models.end();)
+	{
+		if (iter->second.use_count() == 1)
+		{
+			DestroyModel(*iter->second);
+			iter = m_models.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	for (auto iter = m_uniqueModels.begin(); iter != m_uniqueModels.end();)
+	{
+		if (iter->use_count() == 1)
+		{
+			DestroyModel(**iter);
+			iter = m_uniqueModels.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+}
+
+// Suelta todo (al descargar el nivel, con el contexto vivo y sin ningún Model que siga usando sus handles)
+void ModelCache::Clear()
+{
+	for (auto iter = m_models.begin(); iter != m_models.end(); ++iter)
+		DestroyModel(*iter->second);
+
+	for (auto iter = m_uniqueModels.begin(); iter != m_uniqueModels.end(); ++iter)
+		DestroyModel(**iter);
+
+	for (auto iter = m_textures.begin(); iter != m_textures.end(); ++iter)
+		GLState::GetInstance().DeleteTextures(1, &iter->second);
+
+	for (auto iter = m_shaders.begin(); iter != m_shaders.end(); ++iter)
+		iter->second.DestroyProgram();
+
+	m_models.clear();
+	m_uniqueModels.clear();
+	m_textures.clear();
+	m_shaders.clear();
+}
+
+void ModelCache::LoadModel(const std::string& path, ModelData& data)
+{
+	data.m_path = path;
+
+	Assimp::Importer importer;
+	const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+
+	if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+	{
+		printf("ERROR: Unable to load model\n");
+		return;
+	}
+
+	ProcessNode(scene->mRootNode, scene, path.substr(0, path.find_last_of('/')), data);
+	ComputeBounds(data);
+	++m_stats.m_modelLoads;
+}
+
+void ModelCache::ProcessNode(aiNode* node, const aiScene* scene, const std::string& directory, ModelData& data)
+{
+	for (GLuint i = 0; i < node->mNumMeshes; i++)
+	{
+		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+		data.m_meshes.push_back(ProcessMesh(mesh, scene, directory));
+	}
+
+	for (GLuint i = 0; i < node->mNumChildren; i++)
+	{
+		ProcessNode(node->mChildren[i], scene, directory, data);
+	}
+}
+
+Mesh ModelCache::ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& directory)
+{
+	std::vector<MeshVertex> vertices;
+	std::vector<GLuint> indices;
+	std::vector<MeshTexture> textures;
+
+	for (GLuint i = 0; i < mesh->mNumVertices; i++)
+	{
+		MeshVertex vertex;
+		glm::vec3 vector;
+		vector.x = mesh->mVertices[i].x;
+		vector.y = mesh->mVertices[i].y;
+		vector.z = mesh->mVertices[i].z;
+		vertex.m_Position = vector;
+
+		vector.x = mesh->mNormals[i].x;
+		vector.y = mesh->mNormals[i].y;
+		vector.z = mesh->mNormals[i].z;
+		vertex.m_Normal = vector;
+
+		if (mesh->mTextureCoords[0])
+		{
+			glm::vec2 vec;
+			vec.x = mesh->mTextureCoords[0][i].x;
+			vec.y = mesh->mTextureCoords[0][i].y;
+			vertex.m_TexCoords = vec;
+		}
+		else
+			vertex.m_TexCoords = glm::vec2(0.0f, 0.0f);
+
+		vertices.push_back(vertex);
+	}
+
+	for (GLuint i = 0; i < mesh->mNumFaces; i++)
+	{
+		aiFace face = mesh->mFaces[i];
+
+		for (GLuint j = 0; j < face.mNumIndices; j++)
+			indices.push_back(face.mIndices[j]);
+	}
+
+	// Assimp siempre asigna un material a la malla (el de por defecto si el archivo no trae ninguno)
+	aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+
+	std::vector<MeshTexture> diffuseMaps = LoadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", directory);
+	textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+	std::vector<MeshTexture> specularMaps = LoadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", directory);
+	textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+
+	return Mesh(vertices, indices, textures);
+}
+
+// Las texturas se buscan por ruta completa en la caché, así dos modelos que usan la misma imagen la suben una vez
+std::vector<MeshTexture> ModelCache::LoadMaterialTextures(aiMaterial* material, aiTextureType type, const std::string& typeName, const std::string& directory)
+{
+	std::vector<MeshTexture> textures;
+
+	for (GLuint i = 0; i < material->GetTextureCount(type); i++)
+	{
+		aiString str;
+		material->GetTexture(type, i, &str);
+
+		MeshTexture texture;
+		texture.m_id = LoadTexture(directory + '/' + str.C_Str());
+		texture.m_type = typeName;
+		texture.m_path = str;
+		textures.push_back(texture);
+	}
+
+	return textures;
+}
+
+// Caja y radio (desde el origen del modelo, válido para cualquier rotación) de todos los vértices
+void ModelCache::ComputeBounds(ModelData& data)
+{
+	data.m_localBounds.m_min = glm::vec3(FLT_MAX);
+	data.m_localBounds.m_max = glm::vec3(-FLT_MAX);
+	data.m_boundingRadius = 0.0f;
+
+	for (auto mesh = data.m_meshes.begin(); mesh != data.m_meshes.end(); ++mesh)
+	{
+		for (auto iter = (*mesh).GetVertices().begin(); iter != (*mesh).GetVertices().end(); ++iter)
+		{
+			data.m_localBounds.m_min = glm::min(data.m_localBounds.m_min, (*iter).m_Position);
+			data.m_localBounds.m_max = glm::max(data.m_localBounds.m_max, (*iter).m_Position);
+			data.m_boundingRadius = std::max(data.m_boundingRadius, glm::length((*iter).m_Position));
+		}
+	}
+
+	if (data.m_localBounds.m_min.x > data.m_localBounds.m_max.x)
+		data.m_localBounds.m_min = data.m_localBounds.m_max = glm::vec3(0.0f);
+}
+
+void ModelCache::DestroyModel(ModelData& data)
+{
+	for (auto iter = data.m_meshes.begin(); iter != data.m_meshes.end(); ++iter)
+		(*iter).Destroy();
+
+	data.m_meshes.clear();
+}
\ No newline at end of file
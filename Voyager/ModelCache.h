@@ -0,0 +1,87 @@
+#pragma once
+#ifndef __MODELCACHE_H__
+#define __MODELCACHE_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include "TriangleBVH.h"
+#include "DynamicAABBTree.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Datos de un modelo cargado que comparten todas sus copias: las mallas (con su VAO/VBO/EBO), la caja y el radio
+// locales y el BVH de colisión. Quien tiene el handle no debe modificarlos; la transformación va en cada Model.
+struct ModelData
+{
+	ModelData();
+
+	ModelData(ModelData const&) = delete;
+	void operator=(ModelData const&) = delete;
+
+	std::vector<Mesh> m_meshes;
+	AABB m_localBounds;
+	float m_boundingRadius;
+	TriangleBVH m_collider;
+	std::string m_path;
+	bool m_shared;		// false: copia privada de un modelo instanciado (engancha su búfer de instancias a los VAO)
+};
+
+typedef std::shared_ptr<ModelData> ModelHandle;
+
+// Caché de recursos de modelos por ruta. Cada archivo se lee con Assimp y se sube a la GPU una sola vez; las siguientes
+// peticiones devuelven un handle con cuenta de referencias a los mismos datos, así N rocas cuestan una roca más N
+// transformaciones. Las texturas (por ruta completa) y los programas (por pareja de archivos) también se comparten.
+// Purge suelta lo que ya no usa nadie y Clear lo suelta todo al descargar el nivel.
+class ModelCache
+{
+public:
+	struct Stats
+	{
+		unsigned int m_modelLoads, m_modelHits;
+		unsigned int m_textureLoads, m_textureHits;
+		unsigned int m_shaderLoads, m_shaderHits;
+	};
+
+	~ModelCache();
+
+	static ModelCache& GetInstance()
+	{
+		static ModelCache instance;
+		return instance;
+	}
+
+	ModelCache(ModelCache const&) = delete;
+	void operator=(ModelCache const&) = delete;
+
+	ModelHandle Load(const std::string& path);
+	ModelHandle LoadUnique(const std::string& path);
+	GLuint LoadTexture(const std::string& path);
+	Shader LoadShader(const char* vs, const char* fs);
+
+	void Purge();
+	void Clear();
+
+	const Stats& GetStats() const { return m_stats; }
+
+private:
+	ModelCache();
+
+	std::map<std::string, ModelHandle> m_models;
+	std::vector<ModelHandle> m_uniqueModels;	// Copias de LoadUnique: no se comparten, pero la caché borra sus mallas igual
+	std::map<std::string, GLuint> m_textures;
+	std::map<std::string, Shader> m_shaders;
+	Stats m_stats;
+
+	// Private functions
+	void LoadModel(const std::string& path, ModelData& data);
+	void ProcessNode(aiNode* node, const aiScene* scene, const std::string& directory, ModelData& data);
+	Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& directory);
+	std::vector<MeshTexture> LoadMaterialTextures(aiMaterial* material, aiTextureType type, const std::string& typeName, const std::string& directory);
+	static void ComputeBounds(ModelData& data);
+	static void DestroyModel(ModelData& data);
+};
+
+#endif // !__MODELCACHE_H__
\ No newline at end of file
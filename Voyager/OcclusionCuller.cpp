@@ -0,0 +1,565 @@
+#include "OcclusionCuller.h"
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+#include "Dependencies/glm-0.9.9-a2/glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+OcclusionCuller::OcclusionCuller() :
+	m_width(0),
+	m_height(0),
+	m_tilesX(0),
+	m_tilesY(0),
+	m_viewProjection(1.0f)
+{
+	std::memset(&m_stats, 0, sizeof(m_stats));
+
+	for (unsigned int p = 0; p < 6; ++p)
+		m_planes[p] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+OcclusionCuller::~OcclusionCuller()
+{}
+
+// -------------------
+// Descripción: Función que crea el búfer de profundidad. El ancho se redondea a bloques de 8 (los píxeles se escriben
+// de cuatro en cuatro sin salirse de la fila) y el alto a franjas completas.
+// -------------------
+void OcclusionCuller::Init(int width, int height)
+{
+	m_width = std::max((width + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE, (int)TILE_SIZE);
+	m_height = std::max((height + STRIP_HEIGHT - 1) / STRIP_HEIGHT * STRIP_HEIGHT, (int)STRIP_HEIGHT);
+	m_tilesX = m_width / TILE_SIZE;
+	m_tilesY = m_height / TILE_SIZE;
+
+	m_depth.assign(m_width * m_height, 1.0f);
+	m_tileMax.assign(m_tilesX * m_tilesY, 1.0f);
+}
+
+unsigned int OcclusionCuller::AddOccluder(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices)
+{
+	Occluder occluder;
+	occluder.m_vertices = vertices;
+	occluder.m_indices = indices;
+	occluder.m_bounds.m_min = glm::vec3(FLT_MAX);
+	occluder.m_bounds.m_max = glm::vec3(-FLT_MAX);
+
+	for (auto iter = vertices.begin(); iter != vertices.end(); ++iter)
+	{
+		occluder.m_bounds.m_min = glm::min(occluder.m_bounds.m_min, *iter);
+		occluder.m_bounds.m_max = glm::max(occluder.m_bounds.m_max, *iter);
+	}
+
+	m_occluders.push_back(occluder);
+	m_triangles.resize(m_occluders.size());
+	return (unsigned int)m_occluders.size() - 1;
+}
+
+// Caja orientada (una caja local con su transformación), p. ej. el interior de una roca grande
+unsigned int OcclusionCuller::AddBoxOccluder(const glm::mat4& transform, const AABB& localBox)
+{
+	static const unsigned int BOX_INDICES[36] =
+	{
+		0, 1, 3, 0, 3, 2,	4, 6, 7, 4, 7, 5,
+		0, 4, 5, 0, 5, 1,	2, 3, 7, 2, 7, 6,
+		0, 2, 6, 0, 6, 4,	1, 5, 7, 1, 7, 3
+	};
+
+	std::vector<glm::vec3> vertices;
+
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		glm::vec3 corner((i & 4) ? localBox.m_max.x : localBox.m_min.x, (i & 2) ? localBox.m_max.y : localBox.m_min.y, (i & 1) ? localBox.m_max.z : localBox.m_min.z);
+		vertices.push_back(glm::vec3(transform * glm::vec4(corner, 1.0f)));
+	}
+
+	return AddOccluder(vertices, std::vector<unsigned int>(BOX_INDICES, BOX_INDICES + 36));
+}
+
+// -------------------
+// Descripción: Función que devuelve una altura que no supera al terreno dentro del rectángulo [x0, x1] x [z0, z1]: el
+// mínimo de todos los vértices de las casillas de la malla que lo tocan. Cada triángulo del terreno es una media de sus
+// vértices, así que ningún punto queda por debajo, sin importar cómo se partan las casillas ni cuántas caigan dentro.
+// -------------------
+static float LowestTerrainHeight(const Terrain& terrain, float x0, float z0, float x1, float z1)
+{
+	float spacing = terrain.GetCellSpacing();
+	int firstX = (int)std::floor(x0 / spacing), lastX = (int)std::ceil(x1 / spacing);
+	int firstZ = (int)std::floor(z0 / spacing), lastZ = (int)std::ceil(z1 / spacing);
+	float lowest = FLT_MAX;
+
+	for (int z = firstZ; z <= lastZ; ++z)
+		for (int x = firstX; x <= lastX; ++x)
+			lowest = std::min(lowest, terrain.GetVertexHeight(x, z));
+
+	return lowest;
+}
+
+// -------------------
+// Descripción: Función que convierte el terreno en trozos de malla gruesa (chunkCells x chunkCells celdas de cellSize).
+// Primero se busca la altura más baja del terreno en cada celda, mirando todos sus vértices aunque la celda sea más
+// grande que las casillas del terreno; cada vértice del oclusor toma el mínimo de las celdas que lo tocan. Así cada
+// triángulo, que nunca sube por encima de sus esquinas, queda por debajo del suelo y no tapa nada que el terreno real
+// deje ver. Los trozos fuera del frustum no se rasterizan.
+// -------------------
+void OcclusionCuller::AddTerrainOccluders(Terrain& terrain, float worldSize, float cellSize, unsigned int chunkCells)
+{
+	int cells = (int)std::ceil(worldSize / cellSize);
+	int samples = cells + 1;
+	std::vector<float> cellLowest(cells * cells);
+	std::vector<float> heights(samples * samples, FLT_MAX);
+
+	for (int z = 0; z < cells; ++z)
+	{
+		for (int x = 0; x < cells; ++x)
+		{
+			cellLowest[z * cells + x] = LowestTerrainHeight(terrain, x * cellSize, z * cellSize,
+				std::min((x + 1) * cellSize, worldSize), std::min((z + 1) * cellSize, worldSize));
+		}
+	}
+
+	for (int z = 0; z < samples; ++z)
+	{
+		for (int x = 0; x < samples; ++x)
+		{
+			for (int cellZ = std::max(z - 1, 0); cellZ <= std::min(z, cells - 1); ++cellZ)
+				for (int cellX = std::max(x - 1, 0); cellX <= std::min(x, cells - 1); ++cellX)
+					heights[z * samples + x] = std::min(heights[z * samples + x], cellLowest[cellZ * cells + cellX]);
+		}
+	}
+
+	for (int chunkZ = 0; chunkZ < cells; chunkZ += chunkCells)
+	{
+		for (int chunkX = 0; chunkX < cells; chunkX += chunkCells)
+		{
+			int sizeX = std::min((int)chunkCells, cells - chunkX);
+			int sizeZ = std::min((int)chunkCells, cells - chunkZ);
+			std::vector<glm::vec3> vertices;
+			std::vector<unsigned int> indices;
+
+			// La última fila y columna se recortan al borde del terreno para no tapar lo que hay fuera
+			for (int z = 0; z <= sizeZ; ++z)
+				for (int x = 0; x <= sizeX; ++x)
+					vertices.push_back(glm::vec3(std::min((chunkX + x) * cellSize, worldSize), heights[(chunkZ + z) * samples + chunkX + x],
+						std::min((chunkZ + z) * cellSize, worldSize)));
+
+			for (int z = 0; z < sizeZ; ++z)
+			{
+				for (int x = 0; x < sizeX; ++x)
+				{
+					unsigned int corner = z * (sizeX + 1) + x;
+					unsigned int quad[6] = { corner, corner + sizeX + 1, corner + 1, corner + 1, corner + sizeX + 1, corner + sizeX + 2 };
+					indices.insert(indices.end(), quad, quad + 6);
+				}
+			}
+
+			AddOccluder(vertices, indices);
+		}
+	}
+}
+
+void OcclusionCuller::ClearOccluders()
+{
+	m_occluders.clear();
+	m_triangles.clear();
+}
+
+void OcclusionCuller::BeginFrame(const glm::mat4& viewProjection)
+{
+	m_viewProjection = viewProjection;
+	FrustumCuller::ExtractPlanes(viewProjection, m_planes);
+	std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+// -------------------
+// Descripción: Función que dibuja los oclusores en dos fases repartidas entre hilos: primero se proyectan (un oclusor
+// por lote) y después cada franja de la pantalla rasteriza todos los triángulos que la tocan y calcula sus bloques.
+// -------------------
+void OcclusionCuller::RenderOccluders()
+{
+	if (m_depth.empty())
+		return;
+
+	std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+
+	JobSystem& jobs = JobSystem::GetInstance();
+
+	jobs.ParallelFor((unsigned int)m_occluders.size(), 1, [this](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int i = begin; i < end; ++i)
+		{
+			m_triangles[i].clear();
+
+			if (IsOccluderVisible(m_occluders[i].m_bounds))
+				SetupTriangles(m_occluders[i], m_triangles[i]);
+		}
+	});
+
+	for (auto iter = m_triangles.begin(); iter != m_triangles.end(); ++iter)
+	{
+		m_stats.m_occluders += (*iter).empty() ? 0 : 1;
+		m_stats.m_triangles += (unsigned int)(*iter).size();
+	}
+
+	jobs.ParallelFor(m_height / STRIP_HEIGHT, 1, [this](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int strip = begin; strip < end; ++strip)
+			RasterizeStrip(strip * STRIP_HEIGHT, (strip + 1) * STRIP_HEIGHT - 1);
+	});
+}
+
+// -------------------
+// Descripción: Función que dice si una caja está tapada del todo. Se proyectan sus esquinas; si alguna queda detrás de
+// la cámara, o la caja no sale en pantalla, se responde que no (de eso se encarga el frustum). Si no, la caja está
+// tapada cuando su punto más cercano queda detrás de todos los píxeles del rectángulo que cubre.
+// -------------------
+bool OcclusionCuller::IsOccluded(const AABB& bounds) const
+{
+	if (m_depth.empty())
+		return false;
+
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float nearest = FLT_MAX;
+
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		glm::vec3 corner((i & 4) ? bounds.m_max.x : bounds.m_min.x, (i & 2) ? bounds.m_max.y : bounds.m_min.y, (i & 1) ? bounds.m_max.z : bounds.m_min.z);
+		glm::vec4 clip = m_viewProjection * glm::vec4(corner, 1.0f);
+
+		if (clip.w <= 0.0001f || clip.z < -clip.w)
+			return false;
+
+		float x = (clip.x / clip.w * 0.5f + 0.5f) * m_width;
+		float y = (clip.y / clip.w * 0.5f + 0.5f) * m_height;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		nearest = std::min(nearest, clip.z / clip.w * 0.5f + 0.5f);
+	}
+
+	if (maxX < 0.0f || maxY < 0.0f || minX > (float)m_width || minY > (float)m_height)
+		return false;
+
+	int x0 = std::max((int)std::floor(minX), 0), x1 = std::min((int)std::ceil(maxX), m_width - 1);
+	int y0 = std::max((int)std::floor(minY), 0), y1 = std::min((int)std::ceil(maxY), m_height - 1);
+
+	for (int tileY = y0 / TILE_SIZE; tileY <= y1 / TILE_SIZE; ++tileY)
+	{
+		for (int tileX = x0 / TILE_SIZE; tileX <= x1 / TILE_SIZE; ++tileX)
+		{
+			// Todo el bloque tiene algo delante del punto más cercano de la caja
+			if (nearest > m_tileMax[tileY * m_tilesX + tileX])
+				continue;
+
+			int rowBegin = std::max(y0, tileY * TILE_SIZE), rowEnd = std::min(y1, tileY * TILE_SIZE + TILE_SIZE - 1);
+			int columnBegin = std::max(x0, tileX * TILE_SIZE), columnEnd = std::min(x1, tileX * TILE_SIZE + TILE_SIZE - 1);
+
+			for (int y = rowBegin; y <= rowEnd; ++y)
+			{
+				const float* row = &m_depth[y * m_width];
+
+				for (int x = columnBegin; x <= columnEnd; ++x)
+				{
+					if (nearest <= row[x])
+						return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// Prueba muchas cajas repartidas entre hilos; 'visible' recibe 1 si la caja no está tapada
+void OcclusionCuller::TestBatch(const AABB* bounds, unsigned int count, uint8_t* visible)
+{
+	JobSystem::GetInstance().ParallelFor(count, TEST_BATCH_SIZE, [this, bounds, visible](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int i = begin; i < end; ++i)
+			visible[i] = IsOccluded(bounds[i]) ? 0 : 1;
+	});
+
+	m_stats.m_tested += count;
+
+	for (unsigned int i = 0; i < count; ++i)
+		m_stats.m_occluded += visible[i] ? 0 : 1;
+}
+
+// -------------------
+// Descripción: Función que comprueba el rasterizador y la prueba de profundidad sin GPU: una pared de 20x20 a 20 unidades
+// delante de la cámara debe escribir su profundidad en el centro y dejar libre el borde, y las cajas de alrededor deben
+// salir tapadas o no según estén del todo detrás de ella. Imprime cada fallo y devuelve false si hay alguno.
+// -------------------
+bool OcclusionCuller::SelfTest()
+{
+	struct Case
+	{
+		glm::vec3 m_center;
+		float m_halfSize;
+		bool m_occluded;
+	};
+
+	static const Case CASES[] =
+	{
+		{ glm::vec3(0.0f, 0.0f, -40.0f), 1.0f, true },		// Detrás de la pared
+		{ glm::vec3(-8.0f, -8.0f, -100.0f), 3.0f, true },	// Lejos y detrás de una esquina
+		{ glm::vec3(0.0f, 0.0f, -20.2f), 0.1f, true },		// Dentro de la pared
+		{ glm::vec3(0.0f, 0.0f, -10.0f), 1.0f, false },		// Delante de la pared
+		{ glm::vec3(30.0f, 0.0f, -40.0f), 1.0f, false },	// A un lado
+		{ glm::vec3(0.0f, 15.0f, -25.0f), 1.0f, false },	// Asoma por encima
+		{ glm::vec3(11.5f, 0.0f, -23.0f), 1.0f, false },	// Asoma por el borde derecho
+		{ glm::vec3(0.0f, 0.0f, 5.0f), 1.0f, false }		// Detrás de la cámara
+	};
+
+	OcclusionCuller culler;
+	culler.Init(256, 128);
+
+	AABB wall;
+	wall.m_min = glm::vec3(-10.0f, -10.0f, -21.0f);
+	wall.m_max = glm::vec3(10.0f, 10.0f, -20.0f);
+	culler.AddBoxOccluder(glm::mat4(1.0f), wall);
+
+	glm::mat4 viewProjection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 1000.0f) *
+		glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	culler.BeginFrame(viewProjection);
+	culler.RenderOccluders();
+
+	bool valid = true;
+	glm::vec4 front = viewProjection * glm::vec4(0.0f, 0.0f, -20.0f, 1.0f);
+	float expected = front.z / front.w * 0.5f + 0.5f;
+	float center = culler.m_depth[(culler.m_height / 2) * culler.m_width + culler.m_width / 2];
+
+	if (std::abs(center - expected) > 0.0001f)
+	{
+		printf("ERROR: OcclusionCuller self-test depth at the centre is %f, expected %f\n", center, expected);
+		valid = false;
+	}
+
+	if (culler.m_depth[0] != 1.0f)
+	{
+		printf("ERROR: OcclusionCuller self-test wrote depth %f outside the wall\n", culler.m_depth[0]);
+		valid = false;
+	}
+
+	for (unsigned int i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i)
+	{
+		AABB bounds;
+		bounds.m_min = CASES[i].m_center - glm::vec3(CASES[i].m_halfSize);
+		bounds.m_max = CASES[i].m_center + glm::vec3(CASES[i].m_halfSize);
+
+		if (culler.IsOccluded(bounds) != CASES[i].m_occluded)
+		{
+			printf("ERROR: OcclusionCuller self-test box %u at (%.1f, %.1f, %.1f) should %sbe occluded\n", i,
+				CASES[i].m_center.x, CASES[i].m_center.y, CASES[i].m_center.z, CASES[i].m_occluded ? "" : "not ");
+			valid = false;
+		}
+	}
+
+	return valid;
+}
+
+bool OcclusionCuller::IsOccluderVisible(const AABB& bounds) const
+{
+	glm::vec3 center = (bounds.m_min + bounds.m_max) * 0.5f;
+	glm::vec3 extent = (bounds.m_max - bounds.m_min) * 0.5f;
+
+	for (unsigned int p = 0; p < 6; ++p)
+	{
+		glm::vec3 normal(m_planes[p]);
+
+		if (glm::dot(normal, center) + m_planes[p].w + glm::dot(glm::abs(normal), extent) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+void OcclusionCuller::SetupTriangles(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const
+{
+	std::vector<glm::vec4> clip(occluder.m_vertices.size());
+
+	for (size_t i = 0; i < occluder.m_vertices.size(); ++i)
+		clip[i] = m_viewProjection * glm::vec4(occluder.m_vertices[i], 1.0f);
+
+	for (size_t i = 0; i + 2 < occluder.m_indices.size(); i += 3)
+	{
+		glm::vec4 triangle[3] = { clip[occluder.m_indices[i]], clip[occluder.m_indices[i + 1]], clip[occluder.m_indices[i + 2]] };
+
+		// Todo el triángulo fuera del mismo lado de la pantalla
+		if ((triangle[0].x > triangle[0].w && triangle[1].x > triangle[1].w && triangle[2].x > triangle[2].w) ||
+			(triangle[0].x < -triangle[0].w && triangle[1].x < -triangle[1].w && triangle[2].x < -triangle[2].w) ||
+			(triangle[0].y > triangle[0].w && triangle[1].y > triangle[1].w && triangle[2].y > triangle[2].w) ||
+			(triangle[0].y < -triangle[0].w && triangle[1].y < -triangle[1].w && triangle[2].y < -triangle[2].w))
+			continue;
+
+		AddClippedTriangle(triangle, triangles);
+	}
+}
+
+// -------------------
+// Descripción: Función que recorta el triángulo contra el plano cercano (z >= -w) en espacio de recorte y proyecta lo
+// que queda (uno o dos triángulos). Los otros planos no hacen falta: la rasterización ya se limita a la pantalla.
+// -------------------
+void OcclusionCuller::AddClippedTriangle(const glm::vec4* clip, std::vector<ScreenTriangle>& triangles) const
+{
+	glm::vec4 polygon[4];
+	int count = 0;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const glm::vec4& a = clip[i];
+		const glm::vec4& b = clip[(i + 1) % 3];
+		float distanceA = a.z + a.w;
+		float distanceB = b.z + b.w;
+
+		if (distanceA >= 0.0f)
+			polygon[count++] = a;
+
+		if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+			polygon[count++] = a + (b - a) * (distanceA / (distanceA - distanceB));
+	}
+
+	for (int i = 1; i + 1 < count; ++i)
+	{
+		const glm::vec4* corners[3] = { &polygon[0], &polygon[i], &polygon[i + 1] };
+		ScreenTriangle triangle;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			float invW = 1.0f / std::max(corners[j]->w, 0.0001f);
+			triangle.m_x[j] = (corners[j]->x * invW * 0.5f + 0.5f) * m_width;
+			triangle.m_y[j] = (corners[j]->y * invW * 0.5f + 0.5f) * m_height;
+			triangle.m_z[j] = corners[j]->z * invW * 0.5f + 0.5f;
+		}
+
+		triangle.m_minY = std::min(std::min(triangle.m_y[0], triangle.m_y[1]), triangle.m_y[2]);
+		triangle.m_maxY = std::max(std::max(triangle.m_y[0], triangle.m_y[1]), triangle.m_y[2]);
+		triangles.push_back(triangle);
+	}
+}
+
+void OcclusionCuller::RasterizeStrip(int firstRow, int lastRow)
+{
+	for (auto occluder = m_triangles.begin(); occluder != m_triangles.end(); ++occluder)
+	{
+		for (auto iter = (*occluder).begin(); iter != (*occluder).end(); ++iter)
+		{
+			if ((*iter).m_maxY >= (float)firstRow && (*iter).m_minY <= (float)(lastRow + 1))
+				RasterizeTriangle(*iter, firstRow, lastRow);
+		}
+	}
+
+	// Profundidad más lejana de cada bloque de la franja
+	for (int tileY = firstRow / TILE_SIZE; tileY <= lastRow / TILE_SIZE; ++tileY)
+	{
+		for (int tileX = 0; tileX < m_tilesX; ++tileX)
+		{
+			float farthest = 0.0f;
+
+			for (int y = tileY * TILE_SIZE; y < (tileY + 1) * TILE_SIZE; ++y)
+			{
+				const float* row = &m_depth[y * m_width + tileX * TILE_SIZE];
+
+				for (int x = 0; x < TILE_SIZE; ++x)
+					farthest = std::max(farthest, row[x]);
+			}
+
+			m_tileMax[tileY * m_tilesX + tileX] = farthest;
+		}
+	}
+}
+
+// -------------------
+// Descripción: Función que rellena un triángulo dentro de las filas [firstRow, lastRow]. Un píxel está dentro si su
+// centro queda en el lado positivo de las tres aristas; la profundidad sale del plano del triángulo (z/w es lineal en
+// pantalla) y se queda la más cercana.
+// -------------------
+void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& triangle, int firstRow, int lastRow)
+{
+	float x0 = triangle.m_x[0], y0 = triangle.m_y[0], z0 = triangle.m_z[0];
+	float x1 = triangle.m_x[1], y1 = triangle.m_y[1], z1 = triangle.m_z[1];
+	float x2 = triangle.m_x[2], y2 = triangle.m_y[2], z2 = triangle.m_z[2];
+
+	float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+
+	if (std::abs(area) < 0.0001f)
+		return;
+
+	// Orden antihorario para que dentro sea siempre positivo; los oclusores se dibujan por las dos caras
+	if (area < 0.0f)
+	{
+		std::swap(x1, x2);
+		std::swap(y1, y2);
+		std::swap(z1, z2);
+		area = -area;
+	}
+
+	float edgeA[3] = { -(y1 - y0), -(y2 - y1), -(y0 - y2) };
+	float edgeB[3] = { x1 - x0, x2 - x1, x0 - x2 };
+	float edgeC[3] = { -(edgeA[0] * x0 + edgeB[0] * y0), -(edgeA[1] * x1 + edgeB[1] * y1), -(edgeA[2] * x2 + edgeB[2] * y2) };
+
+	float dzdx = ((z1 - z0) * (y2 - y0) - (z2 - z0) * (y1 - y0)) / area;
+	float dzdy = ((z2 - z0) * (x1 - x0) - (z1 - z0) * (x2 - x0)) / area;
+	float zOrigin = z0 - dzdx * x0 - dzdy * y0;
+
+	int columnBegin = std::max((int)std::floor(std::min(std::min(x0, x1), x2)), 0) & ~3;
+	int columnEnd = std::min((int)std::ceil(std::max(std::max(x0, x1), x2)), m_width - 1);
+	int rowBegin = std::max((int)std::floor(triangle.m_minY), firstRow);
+	int rowEnd = std::min((int)std::ceil(triangle.m_maxY), lastRow);
+
+	if (columnBegin > columnEnd || rowBegin > rowEnd)
+		return;
+
+	for (int y = rowBegin; y <= rowEnd; ++y)
+	{
+		float centerY = y + 0.5f;
+		float* row = &m_depth[y * m_width];
+
+#if defined(OCCLUSION_SSE)
+		__m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		__m128 zero = _mm_setzero_ps();
+		__m128 rowE0 = _mm_set1_ps(edgeB[0] * centerY + edgeC[0]);
+		__m128 rowE1 = _mm_set1_ps(edgeB[1] * centerY + edgeC[1]);
+		__m128 rowE2 = _mm_set1_ps(edgeB[2] * centerY + edgeC[2]);
+		__m128 rowZ = _mm_set1_ps(zOrigin + dzdy * centerY);
+
+		for (int x = columnBegin; x <= columnEnd; x += 4)
+		{
+			__m128 centerX = _mm_add_ps(_mm_set1_ps((float)x), laneOffset);
+			__m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeA[0]), centerX), rowE0);
+			__m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeA[1]), centerX), rowE1);
+			__m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeA[2]), centerX), rowE2);
+			__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+			if (_mm_movemask_ps(inside) == 0)
+				continue;
+
+			__m128 z = _mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), centerX), rowZ), zero);
+			__m128 depth = _mm_loadu_ps(row + x);
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, _mm_min_ps(depth, z)), _mm_andnot_ps(inside, depth)));
+		}
+#else
+		for (int x = columnBegin; x <= columnEnd; ++x)
+		{
+			float centerX = x + 0.5f;
+
+			if (edgeA[0] * centerX + edgeB[0] * centerY + edgeC[0] < 0.0f ||
+				edgeA[1] * centerX + edgeB[1] * centerY + edgeC[1] < 0.0f ||
+				edgeA[2] * centerX + edgeB[2] * centerY + edgeC[2] < 0.0f)
+				continue;
+
+			float z = std::max(zOrigin + dzdx * centerX + dzdy * centerY, 0.0f);
+			row[x] = std::min(row[x], z);
+		}
+#endif
+	}
+}
\ No newline at end of file
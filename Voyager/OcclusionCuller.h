@@ -0,0 +1,88 @@
+#pragma once
+#ifndef __OCCLUSIONCULLER_H__
+#define __OCCLUSIONCULLER_H__
+
+#include "DynamicAABBTree.h"
+#include "Terrain.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <cstdint>
+#include <vector>
+
+// Recorte por oclusión en la CPU. Cada cuadro se rasteriza un búfer de profundidad de baja resolución con oclusores
+// simplificados (trozos del terreno, cajas interiores de las rocas grandes) y después se prueban contra él las cajas de
+// los objetos: si toda la zona que cubre una caja tiene delante algo más cercano que su punto más cercano, está tapada.
+// La pantalla se reparte en franjas horizontales entre los hilos del JobSystem (ningún hilo escribe en la franja de
+// otro) y los píxeles se rellenan de cuatro en cuatro con SSE. Sobre los píxeles se guarda la profundidad más lejana de
+// cada bloque de 8x8, así la mayoría de pruebas se deciden sin bajar a los píxeles. No toca OpenGL.
+class OcclusionCuller
+{
+public:
+	struct Stats
+	{
+		unsigned int m_occluders, m_triangles;
+		unsigned int m_tested, m_occluded;
+	};
+
+	OcclusionCuller();
+	~OcclusionCuller();
+
+	void Init(int width = 256, int height = 128);
+
+	// Oclusores estáticos en espacio del mundo. Deben quedar dentro del objeto que representan, nunca sobresalir.
+	unsigned int AddOccluder(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices);
+	unsigned int AddBoxOccluder(const glm::mat4& transform, const AABB& localBox);
+	void AddTerrainOccluders(Terrain& terrain, float worldSize, float cellSize, unsigned int chunkCells = 8);
+	void ClearOccluders();
+
+	void BeginFrame(const glm::mat4& viewProjection);
+	void RenderOccluders();
+
+	bool IsOccluded(const AABB& bounds) const;
+	void TestBatch(const AABB* bounds, unsigned int count, uint8_t* visible);
+
+	// Dibuja una pared conocida en un culler propio y comprueba profundidades y pruebas (solo para depurar, sin OpenGL)
+	static bool SelfTest();
+
+	int GetWidth() const { return m_width; }
+	int GetHeight() const { return m_height; }
+	const std::vector<float>& GetDepthBuffer() const { return m_depth; }
+	const Stats& GetStats() const { return m_stats; }
+
+private:
+	enum { TILE_SIZE = 8, STRIP_HEIGHT = 16, TEST_BATCH_SIZE = 64 };
+
+	struct Occluder
+	{
+		std::vector<glm::vec3> m_vertices;
+		std::vector<unsigned int> m_indices;
+		AABB m_bounds;
+	};
+
+	// Triángulo ya proyectado: coordenadas de píxel y profundidad en [0, 1]
+	struct ScreenTriangle
+	{
+		float m_x[3], m_y[3], m_z[3];
+		float m_minY, m_maxY;
+	};
+
+	int m_width, m_height;
+	int m_tilesX, m_tilesY;
+	std::vector<float> m_depth;
+	std::vector<float> m_tileMax;
+
+	std::vector<Occluder> m_occluders;
+	std::vector<std::vector<ScreenTriangle> > m_triangles;	// Uno por oclusor, se reutilizan entre cuadros
+
+	glm::mat4 m_viewProjection;
+	glm::vec4 m_planes[6];
+	Stats m_stats;
+
+	// Private functions
+	bool IsOccluderVisible(const AABB& bounds) const;
+	void SetupTriangles(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const;
+	void AddClippedTriangle(const glm::vec4* clip, std::vector<ScreenTriangle>& triangles) const;
+	void RasterizeStrip(int firstRow, int lastRow);
+	void RasterizeTriangle(const ScreenTriangle& triangle, int firstRow, int lastRow);
+};
+
+#endif // !__OCCLUSIONCULLER_H__
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "ParticleRenderTarget.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include <cstdio>
+
+ParticleRenderTarget::ParticleRenderTarget() :
+	m_fbo(0),
+	m_colorTexture(0),
+	m_depthTexture(0),
+	m_emptyVao(0),
+	m_screenWidth(0),
+	m_screenHeight(0),
+	m_width(0),
+	m_height(0),
+	m_downsampleFactor(2),
+	m_enabled(true),
+	m_active(false),
+	m_benchmarkFrame(0),
+	m_benchmarkSwitches(0)
+{}
+
+ParticleRenderTarget::~ParticleRenderTarget()
+{
+	DestroyTargets();
+	GLState::GetInstance().DeleteVertexArrays(1, &m_emptyVao);
+}
+
+// -------------------
+// Descripción: Función que crea el programa de reducción de profundidad y los destinos de baja resolución
+// -------------------
+void ParticleRenderTarget::Init(int screenWidth, int screenHeight, int downsampleFactor)
+{
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+	m_downsampleFactor = downsampleFactor;
+
+	m_depthDownsampleShader.CreateProgram("res/Shaders/Particle System Shaders/FullscreenTriangle.vs", "res/Shaders/Particle System Shaders/DepthDownsample.fs");
+
+	// El triángulo de pantalla completa genera sus vértices a partir de gl_VertexID, pero el perfil core exige un VAO enlazado
+	glGenVertexArrays(1, &m_emptyVao);
+
+	CreateTargets();
+}
+
+void ParticleRenderTarget::SetDownsampleFactor(int downsampleFactor)
+{
+	if (downsampleFactor == m_downsampleFactor || downsampleFactor < 1)
+		return;
+
+	m_downsampleFactor = downsampleFactor;
+	DestroyTargets();
+	CreateTargets();
+}
+
+// -------------------
+// Descripción: Función que prepara el estado de GL para dibujar los efectos transparentes
+// -------------------
+void ParticleRenderTarget::BeginParticles(Framebuffer& sceneFramebuffer)
+{
+	Profiler::GetInstance().BeginGpuTimer(m_enabled ? "Particles [low-res]" : "Particles [full-res]");
+
+	GLState::GetInstance().Enable(GL_BLEND);
+	GLState::GetInstance().DepthMask(GL_FALSE);
+
+	if (!m_enabled)
+	{
+		// Modo clásico: las partículas se dibujan directamente en el framebuffer de la escena
+		GLState::GetInstance().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		m_active = false;
+		return;
+	}
+
+	DownsampleDepth(sceneFramebuffer);
+
+	// Limpiar el color a transparente (alfa = cobertura) y dibujar con la profundidad reducida como prueba
+	glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+	glViewport(0, 0, m_width, m_height);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	// El color se acumula premultiplicado y el alfa guarda cuánto del fondo queda tapado
+	GLState::GetInstance().BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	m_active = true;
+}
+
+void ParticleRenderTarget::EndParticles(Framebuffer& sceneFramebuffer)
+{
+	if (m_active)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer.GetFramebufferId());
+		glViewport(0, 0, m_screenWidth, m_screenHeight);
+		GLState::GetInstance().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		m_active = false;
+	}
+
+	GLState::GetInstance().DepthMask(GL_TRUE);
+	GLState::GetInstance().Disable(GL_BLEND);
+
+	Profiler::GetInstance().EndGpuTimer();
+}
+
+// -------------------
+// Descripción: Función que enlaza las texturas necesarias para la composición con reescalado bilateral (sensible a la profundidad)
+// -------------------
+void ParticleRenderTarget::BindCompositeInputs(Shader& postProcessingShader, Framebuffer& sceneFramebuffer, float cameraNear, float cameraFar)
+{
+	postProcessingShader.ActivateProgram();
+	postProcessingShader.SetBool("lowResParticles", m_enabled);
+
+	if (!m_enabled)
+		return;
+
+	postProcessingShader.SetInt("particleBuffer", 1);
+	postProcessingShader.SetInt("particleDepth", 2);
+	postProcessingShader.SetInt("sceneDepth", 3);
+	postProcessingShader.SetFloat("cameraNear", cameraNear);
+	postProcessingShader.SetFloat("cameraFar", cameraFar);
+
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE1);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_colorTexture);
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE2);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_depthTexture);
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE3);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, sceneFramebuffer.GetSceneDepthTexture());
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE0);
+}
+
+// -------------------
+// Descripción: Función que, en modo benchmark, alterna entre resolución completa y reducida y compara los tiempos de cuadro
+// -------------------
+void ParticleRenderTarget::UpdateBenchmark()
+{
+	Profiler& profiler = Profiler::GetInstance();
+
+	if (!profiler.IsBenchmarkMode())
+	{
+		m_benchmarkFrame = 0;
+		m_benchmarkSwitches = 0;
+		return;
+	}
+
+	if (m_benchmarkFrame == 0 && m_benchmarkSwitches == 0)
+		profiler.ResetSamples();
+
+	profiler.SetFrameTag(m_enabled ? "low-res particles" : "full-res particles");
+
+	if (++m_benchmarkFrame < BENCHMARK_INTERVAL)
+		return;
+
+	m_benchmarkFrame = 0;
+	m_enabled = !m_enabled;
+
+	if (++m_benchmarkSwitches >= BENCHMARK_SWITCHES)
+	{
+		profiler.Report();
+		profiler.SetBenchmarkMode(false);
+		profiler.SetFrameTag("");
+		m_benchmarkSwitches = 0;
+	}
+}
+
+void ParticleRenderTarget::CreateTargets()
+{
+	m_width = m_screenWidth / m_downsampleFactor;
+	m_height = m_screenHeight / m_downsampleFactor;
+
+	glGenFramebuffers(1, &m_fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+	// Color RGBA: rgb premultiplicado y alfa de cobertura
+	glGenTextures(1, &m_colorTexture);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_colorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+
+	// Profundidad reducida (la más lejana de cada bloque) para que las partículas se oculten detrás de la geometría
+	glGenTextures(1, &m_depthTexture);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_depthTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, m_width, m_height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		printf("ERROR: Unable to create low resolution particle framebuffer.\n");
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ParticleRenderTarget::DestroyTargets()
+{
+	glDeleteFramebuffers(1, &m_fbo);
+	GLState::GetInstance().DeleteTextures(1, &m_colorTexture);
+	GLState::GetInstance().DeleteTextures(1, &m_depthTexture);
+	m_fbo = m_colorTexture = m_depthTexture = 0;
+}
+
+// -------------------
+// Descripción: Función que reduce la profundidad de la escena a la resolución de las partículas
+// -------------------
+void ParticleRenderTarget::DownsampleDepth(Framebuffer& sceneFramebuffer)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+	glViewport(0, 0, m_width, m_height);
+
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	GLState::GetInstance().DepthMask(GL_TRUE);
+	GLState::GetInstance().DepthFunc(GL_ALWAYS);
+
+	m_depthDownsampleShader.ActivateProgram();
+	m_depthDownsampleShader.SetInt("sceneDepth", 0);
+	m_depthDownsampleShader.SetInt("downsampleFactor", m_downsampleFactor);
+
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, sceneFramebuffer.GetSceneDepthTexture());
+
+	GLState::GetInstance().BindVertexArray(m_emptyVao);
+	GLState::GetInstance().DrawArrays(GL_TRIANGLES, 0, 3);
+	GLState::GetInstance().BindVertexArray(0);
+
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
+	m_depthDownsampleShader.DeactivateProgram();
+
+	GLState::GetInstance().DepthFunc(GL_LESS);
+	GLState::GetInstance().DepthMask(GL_FALSE);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef __PARTICLERENDERTARGET_H__
+#define __PARTICLERENDERTARGET_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Framebuffer.h"
+#include "Shader.h"
+
+// Destino fuera de pantalla de baja resolución para efectos transparentes (explosiones, ondas expansivas, fogonazos)
+class ParticleRenderTarget
+{
+public:
+	ParticleRenderTarget();
+	~ParticleRenderTarget();
+
+	void Init(int screenWidth, int screenHeight, int downsampleFactor = 2);
+	void BeginParticles(Framebuffer& sceneFramebuffer);
+	void EndParticles(Framebuffer& sceneFramebuffer);
+	void BindCompositeInputs(Shader& postProcessingShader, Framebuffer& sceneFramebuffer, float cameraNear, float cameraFar);
+	void UpdateBenchmark();
+
+	void Toggle() { m_enabled = !m_enabled; }
+	void SetEnabled(bool enabled) { m_enabled = enabled; }
+	void SetDownsampleFactor(int downsampleFactor);
+
+	bool IsEnabled() { return m_enabled; }
+	int GetDownsampleFactor() { return m_downsampleFactor; }
+
+private:
+	enum { BENCHMARK_INTERVAL = 300, BENCHMARK_SWITCHES = 4 };
+
+	GLuint m_fbo, m_colorTexture, m_depthTexture, m_emptyVao;
+	Shader m_depthDownsampleShader;
+	int m_screenWidth, m_screenHeight;
+	int m_width, m_height, m_downsampleFactor;
+	bool m_enabled, m_active;
+	unsigned int m_benchmarkFrame, m_benchmarkSwitches;
+
+	// Private functions
+	void CreateTargets();
+	void DestroyTargets();
+	void DownsampleDepth(Framebuffer& sceneFramebuffer);
+};
+
+#endif // !__PARTICLERENDERTARGET_H__
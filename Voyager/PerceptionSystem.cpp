@@ -0,0 +1,249 @@
+#include "PerceptionSystem.h"
+#include <algorithm>
+#include <cmath>
+
+PerceptionSystem::PerceptionSystem() :
+	m_samples(0),
+	m_spacing(1.0f),
+	m_invSpacing(1.0f),
+	m_frame(0),
+	m_latencyBudget(3),
+	m_batchSize(256),
+	m_refreshInterval(0.5f),
+	m_state(STATE_IDLE),
+	m_running(false),
+	m_deterministic(false)
+{}
+
+PerceptionSystem::~PerceptionSystem()
+{
+	if (m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+
+		m_condition.notify_all();
+		m_thread.join();
+	}
+}
+
+// -------------------
+// Descripción: Función que copia las alturas del terreno en una rejilla regular y prepara la caché de cada agente
+// -------------------
+void PerceptionSystem::Init(Terrain& terrain, float worldSize, float sampleSpacing, unsigned int capacity)
+{
+	m_spacing = sampleSpacing;
+	m_invSpacing = 1.0f / sampleSpacing;
+	m_samples = (int)std::ceil(worldSize * m_invSpacing) + 1;
+
+	m_heights.resize(m_samples * m_samples);
+
+	for (int z = 0; z < m_samples; ++z)
+		for (int x = 0; x < m_samples; ++x)
+			m_heights[z * m_samples + x] = terrain.GetHeightOfTerrain(x * sampleSpacing, z * sampleSpacing);
+
+	m_from.assign(capacity, glm::vec3(0.0f));
+	m_to.assign(capacity, glm::vec3(0.0f));
+	m_requested.assign(capacity, 0);
+	m_pending.assign(capacity, 0);
+
+	// Hasta la primera respuesta se supone que el agente ve al jugador (el comportamiento de antes)
+	m_visible.assign(capacity, 1);
+	m_age.assign(capacity, m_refreshInterval);
+
+	if (!m_thread.joinable())
+	{
+		m_running = true;
+		m_thread = std::thread(&PerceptionSystem::WorkerLoop, this);
+	}
+}
+
+void PerceptionSystem::AddOccluder(const glm::vec3& center, float radius)
+{
+	Occluder occluder;
+	occluder.m_center = center;
+	occluder.m_radius = radius;
+	m_occluders.push_back(occluder);
+}
+
+void PerceptionSystem::ClearOccluders()
+{
+	m_occluders.clear();
+}
+
+// -------------------
+// Descripción: Función que encola una prueba de línea de visión para el agente (se recoge en el próximo Update)
+// -------------------
+void PerceptionSystem::RequestLineOfSight(unsigned int agent, const glm::vec3& from, const glm::vec3& to)
+{
+	m_from[agent] = from;
+	m_to[agent] = to;
+	m_requested[agent] = 1;
+}
+
+// -------------------
+// Descripción: Función que se llama una vez por cuadro desde el hilo principal. Recoge los resultados del lote anterior,
+// descarta las peticiones que superan el presupuesto de latencia (se volverán a pedir) y entrega el siguiente lote al hilo.
+// -------------------
+void PerceptionSystem::Update(float dt)
+{
+	if (m_age.empty())
+		return;
+
+	++m_frame;
+
+	for (auto iter = m_age.begin(); iter != m_age.end(); ++iter)
+		*iter += dt;
+
+	if (m_state == STATE_DONE)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (auto iter = m_results.begin(); iter != m_results.end(); ++iter)
+		{
+			m_visible[(*iter).first] = (*iter).second ? 1 : 0;
+			m_pending[(*iter).first] = 0;
+			m_age[(*iter).first] = 0.0f;
+		}
+
+		m_results.clear();
+		m_state = STATE_IDLE;
+	}
+
+	// Recoger las peticiones nuevas de los agentes
+	for (unsigned int i = 0; i < m_requested.size(); ++i)
+	{
+		if (!m_requested[i])
+			continue;
+
+		m_requested[i] = 0;
+
+		if (m_pending[i])
+			continue;
+
+		Query query;
+		query.m_agent = i;
+		query.m_frame = m_frame;
+		query.m_from = m_from[i];
+		query.m_to = m_to[i];
+
+		m_queue.push_back(query);
+		m_pending[i] = 1;
+	}
+
+	if (m_state != STATE_IDLE || m_queue.empty())
+		return;
+
+	// Las peticiones demasiado antiguas ya no sirven: el agente mantiene su último resultado y vuelve a pedir
+	auto stale = std::remove_if(m_queue.begin(), m_queue.end(), [this](const Query& query)
+	{
+		if (m_frame - query.m_frame <= m_latencyBudget)
+			return false;
+
+		m_pending[query.m_agent] = 0;
+		return true;
+	});
+
+	m_queue.erase(stale, m_queue.end());
+
+	if (m_queue.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		size_t count = std::min<size_t>(m_batchSize, m_queue.size());
+		m_workBatch.assign(m_queue.begin(), m_queue.begin() + count);
+		m_queue.erase(m_queue.begin(), m_queue.begin() + count);
+		m_workOccluders = m_occluders;
+		m_state = STATE_WORKING;
+	}
+
+	m_condition.notify_all();
+
+	// En las repeticiones el resultado no puede depender de cuánto tarde el hilo: se espera al lote y se recoge en el siguiente paso
+	if (m_deterministic)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_state != STATE_WORKING; });
+	}
+}
+
+void PerceptionSystem::WorkerLoop()
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return !m_running || m_state == STATE_WORKING; });
+
+			if (!m_running)
+				return;
+		}
+
+		// Mientras el estado es WORKING el hilo principal no toca el lote ni los resultados
+		for (auto iter = m_workBatch.begin(); iter != m_workBatch.end(); ++iter)
+			m_results.push_back(std::make_pair((*iter).m_agent, TestLineOfSight((*iter).m_from, (*iter).m_to)));
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_state = STATE_DONE;
+		}
+
+		m_condition.notify_all();
+	}
+}
+
+// -------------------
+// Descripción: Función que recorre el segmento contra la rejilla de alturas (medio paso de muestra cada vez) y las rocas
+// -------------------
+bool PerceptionSystem::TestLineOfSight(const glm::vec3& from, const glm::vec3& to)
+{
+	glm::vec3 segment = to - from;
+
+	for (auto iter = m_workOccluders.begin(); iter != m_workOccluders.end(); ++iter)
+	{
+		// Distancia del centro de la roca al segmento
+		glm::vec3 toCenter = (*iter).m_center - from;
+		float length = glm::dot(segment, segment);
+		float t = length > 0.0f ? glm::clamp(glm::dot(toCenter, segment) / length, 0.0f, 1.0f) : 0.0f;
+		glm::vec3 closest = from + segment * t - (*iter).m_center;
+
+		if (glm::dot(closest, closest) < (*iter).m_radius * (*iter).m_radius)
+			return false;
+	}
+
+	float horizontal = glm::length(glm::vec2(segment.x, segment.z));
+	int steps = std::max(1, (int)std::ceil(horizontal * m_invSpacing * 2.0f));
+
+	// Los extremos se ignoran: los ojos y el objetivo están pegados al suelo
+	for (int i = 1; i < steps; ++i)
+	{
+		glm::vec3 pos = from + segment * ((float)i / steps);
+
+		if (pos.y < SampleHeight(pos.x, pos.z))
+			return false;
+	}
+
+	return true;
+}
+
+float PerceptionSystem::SampleHeight(float x, float z)
+{
+	float gridX = glm::clamp(x * m_invSpacing, 0.0f, (float)(m_samples - 1));
+	float gridZ = glm::clamp(z * m_invSpacing, 0.0f, (float)(m_samples - 1));
+
+	int x0 = std::min((int)gridX, m_samples - 2);
+	int z0 = std::min((int)gridZ, m_samples - 2);
+	float fx = gridX - x0;
+	float fz = gridZ - z0;
+
+	float h00 = m_heights[z0 * m_samples + x0];
+	float h10 = m_heights[z0 * m_samples + x0 + 1];
+	float h01 = m_heights[(z0 + 1) * m_samples + x0];
+	float h11 = m_heights[(z0 + 1) * m_samples + x0 + 1];
+
+	return glm::mix(glm::mix(h00, h10, fx), glm::mix(h01, h11, fx), fz);
+}
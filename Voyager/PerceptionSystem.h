@@ -0,0 +1,84 @@
+#pragma once
+#ifndef __PERCEPTIONSYSTEM_H__
+#define __PERCEPTIONSYSTEM_H__
+
+#include "Terrain.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Servicio de percepción: los agentes piden pruebas de línea de visión contra el terreno y las rocas grandes,
+// un hilo aparte las resuelve por lotes y el resultado se guarda por agente hasta que toca refrescarlo.
+// Pedir es seguro desde varios hilos siempre que cada hilo pida solo por sus propios agentes.
+class PerceptionSystem
+{
+public:
+	PerceptionSystem();
+	~PerceptionSystem();
+
+	void Init(Terrain& terrain, float worldSize, float sampleSpacing, unsigned int capacity);
+	void Update(float dt);
+
+	void AddOccluder(const glm::vec3& center, float radius);
+	void ClearOccluders();
+
+	void RequestLineOfSight(unsigned int agent, const glm::vec3& from, const glm::vec3& to);
+	bool NeedsRefresh(unsigned int agent) { return m_age[agent] >= m_refreshInterval && !m_pending[agent] && !m_requested[agent]; }
+	bool HasLineOfSight(unsigned int agent) { return m_visible[agent] != 0; }
+
+	void SetRefreshInterval(float seconds) { m_refreshInterval = seconds; }
+	void SetLatencyBudget(unsigned int frames) { m_latencyBudget = frames; }
+	void SetBatchSize(unsigned int batchSize) { m_batchSize = batchSize; }
+	void SetDeterministic(bool deterministic) { m_deterministic = deterministic; }
+
+private:
+	struct Query
+	{
+		unsigned int m_agent;
+		unsigned int m_frame;
+		glm::vec3 m_from, m_to;
+	};
+
+	struct Occluder
+	{
+		glm::vec3 m_center;
+		float m_radius;
+	};
+
+	enum { STATE_IDLE, STATE_WORKING, STATE_DONE };
+
+	// Copia de las alturas del terreno para que el hilo no dependa del objeto Terrain
+	std::vector<float> m_heights;
+	int m_samples;
+	float m_spacing, m_invSpacing;
+
+	std::vector<Occluder> m_occluders, m_workOccluders;
+
+	// Estado por agente (SoA)
+	std::vector<glm::vec3> m_from, m_to;
+	std::vector<uint8_t> m_requested, m_pending, m_visible;
+	std::vector<float> m_age;
+
+	std::vector<Query> m_queue, m_workBatch;
+	std::vector<std::pair<unsigned int, bool> > m_results;
+
+	unsigned int m_frame, m_latencyBudget, m_batchSize;
+	float m_refreshInterval;
+
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::atomic<int> m_state;
+	bool m_running, m_deterministic;
+
+	// Private functions
+	void WorkerLoop();
+	bool TestLineOfSight(const glm::vec3& from, const glm::vec3& to);
+	float SampleHeight(float x, float z);
+};
+
+#endif // !__PERCEPTIONSYSTEM_H__
@@ -5,13 +5,8 @@
 #include "Camera.h"
 #include "Dependencies/SDL2/include/SDL.h"
 #include <vector>
-#include "Enemy.h"
-
-struct Ray
-{
-	glm::vec3 pos;
-	glm::vec3 dir;
-};
+#include "EnemyManager.h"
+#include "CollisionWorld.h"
 
 class Physics
 {
@@ -29,15 +24,16 @@ public:
 	void operator=(Physics const&) = delete;
 
 	void ProcessInput(Camera& cam, float dt, std::vector<SDL_Event> events);
-	void Update(Camera& cam, float dt, std::vector<SDL_Event> events, std::vector<Enemy*>& enemies);
+	void Update(Camera& cam, float dt, std::vector<SDL_Event> events, EnemyManager& enemies);
 
 	void CastRay() { m_castRay = true; }
 	Ray& GetRay() { return m_ray; }
 	bool GetDebugRayCastDraw() { return m_debugRayCastDraw; }
 	float GetGravity() { return m_gravity; }
-	void OnEnemyHit(Enemy* enemy);
+	void OnEnemyHit(EnemyManager& enemies, unsigned int enemy);
 	void OnPlayerHit(float damage);
 	bool PointInSphere(Camera& cam, glm::vec3&, float radius);
+	CollisionWorld& GetCollisionWorld() { return m_collisionWorld; }
 
 private:
 	Physics();
@@ -48,11 +44,12 @@ private:
 	bool m_collision;
 	bool m_castRay;
 	float m_gravity;
+	CollisionWorld m_collisionWorld;
 
 	// Private functions
 	Ray CastRayFromMouse(Camera& cam);
 	Ray CastRayFromWeapon(Camera& cam);
-	void CheckRaySphereCollision(Camera& cam, std::vector<Enemy*> enemies);
+	void CheckRaySphereCollision(Camera& cam, EnemyManager& enemies);
 	bool RaySphere(Camera& cam, glm::vec3 RayDirWorld, double SphereRadius, double x, double y, double z);
 };
 
@@ -6,6 +6,7 @@
 #include "Physics.h"
 #include "Weapon.h"
 #include "SpotLight.h"
+#include "CharacterController.h"
 
 class Player
 {
@@ -39,6 +40,7 @@ public:
 	Animation& GetAnimationComponent() { return m_animationComponent; }
 	Weapon& GetCurrWeapon() { return *m_currWeapon; }
 	SpotLight* GetSpotLight() { return m_spotLight; }
+	CharacterController& GetController() { return m_controller; }
 
 private:
 	Player();
@@ -54,6 +56,7 @@ private:
 	glm::vec3 m_pos;
 	SpotLight* m_spotLight;
 	Animation m_animationComponent;
+	CharacterController m_controller;
 	Weapon* m_currWeapon, * m_assaultRifle, * m_sniperRifle;
 
 private:
@@ -6,6 +6,7 @@
 #include "Physics.h"
 #include "Weapon.h"
 #include "SpotLight.h"
+#include "CharacterController.h"
 
 
 
@@ -30,6 +31,7 @@
 	Animation& GetAnimationComponent() { return m_animationComponent; }
 	Weapon& GetCurrWeapon() { return *m_currWeapon; }
 	SpotLight* GetSpotLight() { return m_spotLight; }
+	CharacterController& GetController() { return m_controller; }
 
 private:
 	Player();
@@ -45,6 +47,7 @@ private:
 	glm::vec3 m_pos;
 	SpotLight* m_spotLight;
 	Animation m_animationComponent;
+	CharacterController m_controller;
 	Weapon* m_currWeapon, * m_assaultRifle, * m_sniperRifle;
 
 private:
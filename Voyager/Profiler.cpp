@@ -0,0 +1,167 @@
+#include "Profiler.h"
+#include "GLState.h"
+#include <iostream>
+
+Profiler::Profiler() :
+	m_frameStart(0),
+	m_frameTime(0.0f),
+	m_frameCount(0),
+	m_benchmarkMode(false)
+{}
+
+Profiler::~Profiler()
+{
+	for (auto iter = m_gpuTimers.begin(); iter != m_gpuTimers.end(); ++iter)
+		glDeleteQueries(QUERY_LATENCY, iter->second.m_queries);
+}
+
+// -------------------
+// Descripción: Función que marca el inicio de un cuadro para medir su duración en la CPU
+// -------------------
+void Profiler::BeginFrame()
+{
+	m_frameStart = SDL_GetPerformanceCounter();
+}
+
+// -------------------
+// Descripción: Función que registra la duración del cuadro (etiquetada si el modo benchmark está activo)
+// -------------------
+void Profiler::EndFrame()
+{
+	Uint64 frameEnd = SDL_GetPerformanceCounter();
+	m_frameTime = (float)((frameEnd - m_frameStart) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+	++m_frameCount;
+
+	if (m_benchmarkMode && !m_frameTag.empty())
+		AddSample("Frame [" + m_frameTag + "]", m_frameTime);
+	else
+		AddSample("Frame", m_frameTime);
+
+	AddGLCounters();
+}
+
+// -------------------
+// Descripción: Función que inicia una consulta de tiempo en la GPU (GL_TIME_ELAPSED no se puede anidar)
+// -------------------
+void Profiler::BeginGpuTimer(const std::string& name)
+{
+	auto iter = m_gpuTimers.find(name);
+
+	if (iter == m_gpuTimers.end())
+	{
+		GpuTimer timer;
+		glGenQueries(QUERY_LATENCY, timer.m_queries);
+
+		for (unsigned int i = 0; i < QUERY_LATENCY; ++i)
+			timer.m_pending[i] = false;
+
+		timer.m_current = 0;
+		iter = m_gpuTimers.insert(std::pair<std::string, GpuTimer>(name, timer)).first;
+	}
+
+	GpuTimer& timer = iter->second;
+
+	// Recoge el resultado de la consulta que ocupaba esta ranura hace QUERY_LATENCY cuadros
+	if (timer.m_pending[timer.m_current])
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(timer.m_queries[timer.m_current], GL_QUERY_RESULT, &elapsed);
+		AddSample(name, (float)(elapsed / 1000000.0));
+		timer.m_pending[timer.m_current] = false;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, timer.m_queries[timer.m_current]);
+	m_activeGpuTimer = name;
+}
+
+void Profiler::EndGpuTimer()
+{
+	if (m_activeGpuTimer.empty())
+		return;
+
+	GpuTimer& timer = m_gpuTimers[m_activeGpuTimer];
+	glEndQuery(GL_TIME_ELAPSED);
+
+	timer.m_pending[timer.m_current] = true;
+	timer.m_current = (timer.m_current + 1) % QUERY_LATENCY;
+	m_activeGpuTimer.clear();
+}
+
+void Profiler::AddSample(const std::string& name, float ms)
+{
+	Sample& sample = m_samples[name];
+	sample.m_total += ms;
+	sample.m_last = ms;
+	++sample.m_count;
+}
+
+// -------------------
+// Descripción: Función que registra el valor de un contador en este cuadro
+// -------------------
+void Profiler::AddCounter(const std::string& name, unsigned int value)
+{
+	Counter& counter = m_counters[name];
+	counter.m_total += value;
+	counter.m_last = value;
+	++counter.m_count;
+}
+
+void Profiler::ResetSamples()
+{
+	m_samples.clear();
+	m_counters.clear();
+}
+
+unsigned int Profiler::GetCounter(const std::string& name)
+{
+	auto iter = m_counters.find(name);
+	return iter != m_counters.end() ? iter->second.m_last : 0;
+}
+
+float Profiler::GetAverage(const std::string& name)
+{
+	auto iter = m_samples.find(name);
+
+	if (iter == m_samples.end() || iter->second.m_count == 0)
+		return 0.0f;
+
+	return (float)(iter->second.m_total / iter->second.m_count);
+}
+
+// -------------------
+// Descripción: Función que imprime el promedio de cada muestra registrada
+// -------------------
+void Profiler::Report()
+{
+	std::cout << "---------- Profiler (" << m_frameCount << " frames) ----------\n";
+
+	for (auto iter = m_samples.begin(); iter != m_samples.end(); ++iter)
+	{
+		std::cout << iter->first << ": " << GetAverage(iter->first) << " ms avg, "
+			<< iter->second.m_last << " ms last (" << iter->second.m_count << " samples)\n";
+	}
+
+	for (auto iter = m_counters.begin(); iter != m_counters.end(); ++iter)
+	{
+		std::cout << iter->first << ": " << (double)iter->second.m_total / iter->second.m_count << " avg, "
+			<< iter->second.m_last << " last\n";
+	}
+}
+
+// -------------------
+// Descripción: Función que cierra el cuadro de GLState y guarda sus contadores (así una regresión de la caché de estado
+// se ve en el informe sin abrir un depurador de GPU)
+// -------------------
+void Profiler::AddGLCounters()
+{
+	const GLState::Counters& counters = GLState::GetInstance().EndFrame();
+
+	AddCounter("GL draw calls", counters.m_drawCalls);
+	AddCounter("GL program binds", counters.m_programBinds);
+	AddCounter("GL texture binds", counters.m_textureBinds);
+	AddCounter("GL VAO binds", counters.m_vaoBinds);
+	AddCounter("GL buffer binds", counters.m_bufferBinds);
+	AddCounter("GL state changes", counters.m_stateChanges);
+	AddCounter("GL uniform uploads", counters.m_uniformUploads);
+	AddCounter("GL skipped calls", counters.m_skippedCalls);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/SDL2/include/SDL.h"
+#include <map>
+#include <string>
+
+class Profiler
+{
+public:
+	~Profiler();
+
+	static Profiler& GetInstance()
+	{
+		static Profiler instance;
+		return instance;
+	}
+
+	Profiler(Profiler const&) = delete;
+	void operator=(Profiler const&) = delete;
+
+	void BeginFrame();
+	void EndFrame();
+	void BeginGpuTimer(const std::string& name);
+	void EndGpuTimer();
+	void AddSample(const std::string& name, float ms);
+	void AddCounter(const std::string& name, unsigned int value);
+	void ResetSamples();
+	void Report();
+
+	void SetBenchmarkMode(bool benchmark) { m_benchmarkMode = benchmark; }
+	void SetFrameTag(const std::string& tag) { m_frameTag = tag; }
+
+	bool IsBenchmarkMode() { return m_benchmarkMode; }
+	float GetAverage(const std::string& name);
+	unsigned int GetCounter(const std::string& name);
+	float GetFrameTime() { return m_frameTime; }
+	unsigned int GetFrameCount() { return m_frameCount; }
+
+private:
+	Profiler();
+
+	// Numero de consultas en vuelo por temporizador (evita bloquear la CPU esperando a la GPU)
+	enum { QUERY_LATENCY = 4 };
+
+	struct GpuTimer
+	{
+		GLuint m_queries[QUERY_LATENCY];
+		bool m_pending[QUERY_LATENCY];
+		unsigned int m_current;
+	};
+
+	struct Sample
+	{
+		double m_total;
+		unsigned int m_count;
+		float m_last;
+	};
+
+	std::map<std::string, GpuTimer> m_gpuTimers;
+	// Contadores por cuadro (llamadas de dibujo, enlaces...); se promedian igual que las muestras pero no son tiempos
+	struct Counter
+	{
+		unsigned long long m_total;
+		unsigned int m_count;
+		unsigned int m_last;
+	};
+
+	std::map<std::string, Sample> m_samples;
+	std::map<std::string, Counter> m_counters;
+	std::string m_activeGpuTimer;
+	std::string m_frameTag;
+	Uint64 m_frameStart;
+	float m_frameTime;
+	unsigned int m_frameCount;
+	bool m_benchmarkMode;
+
+	// Private functions
+	void AddGLCounters();
+};
+
+#endif // !__PROFILER_H__
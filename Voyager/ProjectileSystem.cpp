@@ -0,0 +1,464 @@
+#include "ProjectileSystem.h"
+#include "Renderer.h"
+#include "Physics.h"
+#include "Player.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Steering.h"
+#include <algorithm>
+#include <cmath>
+
+ProjectileSystem::ProjectileSystem() :
+	m_capacity(0),
+	m_gravity(-9.81f),
+	m_playerRadius(2.0f)
+{
+	// Velocidad, escala de gravedad, tiempo de vida, radio, daño, escala de dibujo, altura de vuelo y radio de llegada
+	m_specs[PROJECTILE_DRONE] = { 100.0f, 0.0f, 10.0f, 1.0f, 10.0f, 0.25f, 10.0f, 3.0f };
+	m_specs[PROJECTILE_BULLET] = { 300.0f, 1.0f, 3.0f, 0.1f, 25.0f, 0.1f, 0.0f, 0.0f };
+	m_specs[PROJECTILE_SNIPER] = { 900.0f, 0.5f, 4.0f, 0.05f, 100.0f, 0.05f, 0.0f, 0.0f };
+
+	for (int i = 0; i < TOTAL_PROJECTILE_TYPES; ++i)
+		m_renderObjects[i] = -1;
+}
+
+ProjectileSystem::~ProjectileSystem()
+{}
+
+// -------------------
+// Descripción: Función que reserva el grupo de proyectiles una sola vez
+// -------------------
+void ProjectileSystem::Init(unsigned int capacity)
+{
+	m_capacity = capacity;
+
+	m_posX.resize(capacity); m_posY.resize(capacity); m_posZ.resize(capacity);
+	m_velX.resize(capacity); m_velY.resize(capacity); m_velZ.resize(capacity);
+	m_targetX.resize(capacity); m_targetY.resize(capacity); m_targetZ.resize(capacity);
+	m_lifeTime.resize(capacity);
+	m_owner.resize(capacity);
+	m_type.resize(capacity);
+	m_fromPlayer.resize(capacity);
+	m_homing.resize(capacity);
+
+	m_active.reserve(capacity);
+	m_hits.reserve(capacity);
+
+	m_homingGrid.Init(0.0f, 0.0f, (float)WORLD_SIZE, (float)WORLD_SIZE, (float)GRID_CELL_SIZE);
+
+	if (m_instancingShader.GetShaderProgram() == 0)
+		m_instancingShader.CreateProgram("res/Shaders/EnemyInstancing.vs", "res/Shaders/EnemyInstancing.fs");
+
+	Clear();
+}
+
+void ProjectileSystem::Clear()
+{
+	m_active.clear();
+	m_free.clear();
+	m_homingGrid.Clear();
+	m_homingGrid.Build();
+
+	// Un tiempo de vida de cero marca el hueco como libre
+	std::fill(m_lifeTime.begin(), m_lifeTime.end(), 0.0f);
+
+	// Los índices bajos salen primero de la pila
+	for (unsigned int i = m_capacity; i > 0; --i)
+		m_free.push_back(i - 1);
+}
+
+// -------------------
+// Descripción: Función que dispara un proyectil. Devuelve -1 si el grupo está lleno.
+// -------------------
+int ProjectileSystem::Fire(ProjectileType type, const glm::vec3& pos, const glm::vec3& dir, bool fromPlayer)
+{
+	return Allocate(type, pos, glm::normalize(dir) * m_specs[type].m_speed, fromPlayer);
+}
+
+// -------------------
+// Descripción: Función que lanza un proyectil guiado de un enemigo hacia 'target'. Sale parado y acelera con la
+// fuerza de dirección; al desaparecer se avisa al enemigo 'owner'. Devuelve -1 si el grupo está lleno.
+// -------------------
+int ProjectileSystem::FireHoming(ProjectileType type, const glm::vec3& pos, const glm::vec3& target, unsigned int owner)
+{
+	int projectile = Allocate(type, pos, glm::vec3(0.0f, 0.0f, 0.0f), false);
+
+	if (projectile < 0)
+		return -1;
+
+	m_targetX[projectile] = target.x;
+	m_targetY[projectile] = target.y;
+	m_targetZ[projectile] = target.z;
+	m_owner[projectile] = owner;
+	m_homing[projectile] = 1;
+	return projectile;
+}
+
+void ProjectileSystem::QueryHoming(const glm::vec3& center, float radius, std::vector<unsigned int>& projectiles)
+{
+	m_homingGrid.QueryRadius(center, radius, projectiles);
+}
+
+int ProjectileSystem::Allocate(ProjectileType type, const glm::vec3& pos, const glm::vec3& velocity, bool fromPlayer)
+{
+	if (m_free.empty())
+		return -1;
+
+	unsigned int projectile = m_free.back();
+	m_free.pop_back();
+	m_active.push_back(projectile);
+
+	m_posX[projectile] = pos.x;
+	m_posY[projectile] = pos.y;
+	m_posZ[projectile] = pos.z;
+	m_velX[projectile] = velocity.x;
+	m_velY[projectile] = velocity.y;
+	m_velZ[projectile] = velocity.z;
+	m_lifeTime[projectile] = m_specs[type].m_lifeTime;
+	m_type[projectile] = (uint8_t)type;
+	m_fromPlayer[projectile] = fromPlayer ? 1 : 0;
+	m_owner[projectile] = NO_OWNER;
+	m_homing[projectile] = 0;
+
+	return (int)projectile;
+}
+
+// -------------------
+// Descripción: Función que avanza todos los proyectiles activos y resuelve sus impactos (el más cercano en el segmento recorrido).
+// Los guiados ya traen la velocidad de este paso calculada en lote por SteerHoming.
+// -------------------
+void ProjectileSystem::Update(Terrain& terrain, EnemyManager& enemies, Camera& cam, float dt)
+{
+	m_hits.clear();
+
+	glm::vec3 playerPos = cam.GetCameraPos();
+
+	SteerHoming(dt);
+
+	for (unsigned int a = 0; a < m_active.size();)
+	{
+		unsigned int p = m_active[a];
+		const ProjectileSpec& spec = m_specs[m_type[p]];
+
+		m_lifeTime[p] -= dt;
+
+		if (m_lifeTime[p] <= 0.0f)
+		{
+			Release(a, enemies);
+			continue;
+		}
+
+		// Integración semi-implícita con caída balística
+		if (!m_homing[p])
+			m_velY[p] += m_gravity * spec.m_gravityScale * dt;
+
+		glm::vec3 start(m_posX[p], m_posY[p], m_posZ[p]);
+		glm::vec3 end = start + glm::vec3(m_velX[p], m_velY[p], m_velZ[p]) * dt;
+
+		if (spec.m_hoverHeight > 0.0f)
+			end.y = terrain.GetHeightOfTerrain(end.x, end.z) + spec.m_hoverHeight;
+
+		// Buscar el primer impacto a lo largo del segmento
+		ProjectileHit hit;
+		hit.m_enemy = 0;
+		float closest = 2.0f;
+		float t;
+		unsigned int enemy;
+
+		if (m_fromPlayer[p] && SweepEnemies(enemies, start, end, spec.m_radius, t, enemy) && t < closest)
+		{
+			closest = t;
+			hit.m_target = HIT_ENEMY;
+			hit.m_enemy = enemy;
+		}
+
+		if (!m_fromPlayer[p] && SweepSphere(start, end, playerPos, m_playerRadius + spec.m_radius, t) && t < closest)
+		{
+			closest = t;
+			hit.m_target = HIT_PLAYER;
+		}
+
+		// Los que vuelan a una altura fija sobre el terreno no pueden chocar con él
+		if (spec.m_hoverHeight <= 0.0f && SweepTerrain(terrain, start, end, t) && t < closest)
+		{
+			closest = t;
+			hit.m_target = HIT_TERRAIN;
+		}
+
+		if (closest <= 1.0f)
+		{
+			hit.m_type = (ProjectileType)m_type[p];
+			hit.m_pos = start + (end - start) * closest;
+
+			if (hit.m_target == HIT_ENEMY)
+				enemies.ReduceHealth(hit.m_enemy, (int)spec.m_damage);
+			else if (hit.m_target == HIT_PLAYER)
+				Physics::GetInstance().OnPlayerHit(spec.m_damage);
+
+			m_hits.push_back(hit);
+			Release(a, enemies);
+			continue;
+		}
+
+		m_posX[p] = end.x;
+		m_posY[p] = end.y;
+		m_posZ[p] = end.z;
+
+		// Comprueba si el guiado alcanzó su objetivo (solo plano XZ, comparando distancias al cuadrado)
+		if (m_homing[p])
+		{
+			float dx = end.x - m_targetX[p];
+			float dz = end.z - m_targetZ[p];
+
+			if (dx * dx + dz * dz <= spec.m_arrivalRadius * spec.m_arrivalRadius)
+			{
+				Release(a, enemies);
+				continue;
+			}
+		}
+
+		++a;
+	}
+
+	RebuildGrid();
+}
+
+// -------------------
+// Descripción: Función que calcula la velocidad de este paso de todos los proyectiles guiados con los núcleos de
+// dirección en lote (buscar + separación), usando la rejilla de guiados del paso anterior para las listas de vecinos
+// -------------------
+void ProjectileSystem::SteerHoming(float dt)
+{
+	Uint64 start = SDL_GetPerformanceCounter();
+	HomingSwarm& swarm = m_swarm;
+
+	// Compactar los guiados activos en arreglos contiguos
+	swarm.m_agents.clear();
+	swarm.m_idToAgent.assign(m_capacity, 0xFFFFFFFF);
+
+	for (auto iter = m_active.begin(); iter != m_active.end(); ++iter)
+	{
+		if (!m_homing[*iter])
+			continue;
+
+		swarm.m_idToAgent[*iter] = (unsigned int)swarm.m_agents.size();
+		swarm.m_agents.push_back(*iter);
+	}
+
+	unsigned int count = (unsigned int)swarm.m_agents.size();
+
+	if (count == 0)
+		return;
+
+	swarm.m_posX.resize(count); swarm.m_posY.resize(count); swarm.m_posZ.resize(count);
+	swarm.m_velX.resize(count); swarm.m_velY.resize(count); swarm.m_velZ.resize(count);
+	swarm.m_targetX.resize(count); swarm.m_targetY.resize(count); swarm.m_targetZ.resize(count);
+	swarm.m_forceX.resize(count); swarm.m_forceY.resize(count); swarm.m_forceZ.resize(count);
+	swarm.m_neighbourCount.resize(count);
+	swarm.m_neighbours.resize(count * HOMING_NEIGHBOURS);
+
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		unsigned int p = swarm.m_agents[k];
+		swarm.m_posX[k] = m_posX[p]; swarm.m_posY[k] = m_posY[p]; swarm.m_posZ[k] = m_posZ[p];
+		swarm.m_velX[k] = m_velX[p]; swarm.m_velY[k] = m_velY[p]; swarm.m_velZ[k] = m_velZ[p];
+		swarm.m_targetX[k] = m_targetX[p]; swarm.m_targetY[k] = m_targetY[p]; swarm.m_targetZ[k] = m_targetZ[p];
+	}
+
+	SteeringAgents agents;
+	agents.m_posX = swarm.m_posX.data(); agents.m_posY = swarm.m_posY.data(); agents.m_posZ = swarm.m_posZ.data();
+	agents.m_velX = swarm.m_velX.data(); agents.m_velY = swarm.m_velY.data(); agents.m_velZ = swarm.m_velZ.data();
+	agents.m_targetX = swarm.m_targetX.data(); agents.m_targetY = swarm.m_targetY.data(); agents.m_targetZ = swarm.m_targetZ.data();
+	agents.m_count = count;
+
+	// Todos los guiados son drones: comparten velocidad y fuerza máximas
+	SteeringParams params;
+	params.m_maximumSpeed = m_specs[PROJECTILE_DRONE].m_speed;
+	params.m_maximumForce = params.m_maximumSpeed * 4.0f;
+	params.m_seekWeight = 1.0f;
+	params.m_fleeWeight = 0.0f;
+	params.m_fleeRadius = 0.0f;
+	params.m_arrivalRadius = 0.0f;
+	params.m_separationWeight = 1.0f;
+	params.m_separationRadius = 4.0f;
+
+	JobSystem& jobs = JobSystem::GetInstance();
+
+	jobs.ParallelFor(count, PARALLEL_BATCH_SIZE, [this, &swarm, &agents, &params](unsigned int begin, unsigned int end)
+	{
+		Steering::BuildNeighbours(m_homingGrid, agents, begin, end, swarm.m_idToAgent, params.m_separationRadius, HOMING_NEIGHBOURS,
+			swarm.m_neighbourCount.data(), swarm.m_neighbours.data());
+		Steering::ComputeForces(agents, params, begin, end, swarm.m_neighbourCount.data(), swarm.m_neighbours.data(), HOMING_NEIGHBOURS,
+			swarm.m_forceX.data(), swarm.m_forceY.data(), swarm.m_forceZ.data());
+	});
+
+	// Integrar después de que todas las fuerzas estén calculadas (la separación lee las posiciones de otros lotes)
+	jobs.ParallelFor(count, PARALLEL_BATCH_SIZE, [&swarm, &agents, &params, dt](unsigned int begin, unsigned int end)
+	{
+		Steering::Integrate(agents, begin, end, swarm.m_forceX.data(), swarm.m_forceY.data(), swarm.m_forceZ.data(), params.m_maximumSpeed, dt);
+	});
+
+	// Solo se devuelve la velocidad: el movimiento lo hace Update para probar el segmento recorrido
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		unsigned int p = swarm.m_agents[k];
+		m_velX[p] = swarm.m_velX[k]; m_velY[p] = swarm.m_velY[k]; m_velZ[p] = swarm.m_velZ[k];
+	}
+
+	Profiler::GetInstance().AddSample("Drone steering", (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency()));
+}
+
+void ProjectileSystem::RebuildGrid()
+{
+	m_homingGrid.Clear();
+
+	for (auto iter = m_active.begin(); iter != m_active.end(); ++iter)
+	{
+		if (m_homing[*iter])
+			m_homingGrid.Insert(*iter, GetPos(*iter), m_specs[m_type[*iter]].m_radius);
+	}
+
+	m_homingGrid.Build();
+}
+
+// -------------------
+// Descripción: Función que dibuja los proyectiles activos con el objeto asignado a su tipo, un lote instanciado por tipo
+// -------------------
+void ProjectileSystem::Draw(Camera& cam)
+{
+	for (int type = 0; type < TOTAL_PROJECTILE_TYPES; ++type)
+	{
+		if (m_renderObjects[type] >= 0 && !m_batches[type].IsReady())
+			m_batches[type].Init(Renderer::GetInstance().GetComponent(m_renderObjects[type]), m_capacity);
+
+		m_batches[type].Clear();
+	}
+
+	for (auto iter = m_active.begin(); iter != m_active.end(); ++iter)
+	{
+		unsigned int p = *iter;
+
+		if (m_batches[m_type[p]].IsReady())
+			m_batches[m_type[p]].Add(GetPos(p), m_specs[m_type[p]].m_drawScale);
+	}
+
+	for (int type = 0; type < TOTAL_PROJECTILE_TYPES; ++type)
+		m_batches[type].Draw(m_instancingShader, cam, Player::GetInstance().GetSpotLight());
+}
+
+// -------------------
+// Descripción: Función que busca el enemigo vivo más cercano tocado por la esfera barrida.
+// Solo se prueban los enemigos de la rejilla cercanos al segmento (esfera que lo envuelve).
+// -------------------
+bool ProjectileSystem::SweepEnemies(EnemyManager& enemies, const glm::vec3& start, const glm::vec3& end, float radius, float& t, unsigned int& enemy)
+{
+	glm::vec3 center = (start + end) * 0.5f;
+	float reach = glm::length(end - start) * 0.5f + radius;
+
+	enemies.QueryRadius(center, reach, m_nearbyEnemies);
+
+	bool found = false;
+	t = 2.0f;
+
+	for (auto iter = m_nearbyEnemies.begin(); iter != m_nearbyEnemies.end(); ++iter)
+	{
+		float hitTime;
+
+		if (enemies.IsAlive(*iter) && SweepSphere(start, end, enemies.GetPos(*iter), enemies.GetRadius() + radius, hitTime) && hitTime < t)
+		{
+			t = hitTime;
+			enemy = *iter;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+// -------------------
+// Descripción: Función que recorre el segmento en pasos del tamaño de una celda del terreno y, al cruzar el suelo,
+// refina el punto de impacto por bisección
+// -------------------
+bool ProjectileSystem::SweepTerrain(Terrain& terrain, const glm::vec3& start, const glm::vec3& end, float& t)
+{
+	const float stepLength = 3.0f;
+
+	glm::vec3 segment = end - start;
+	int steps = std::max(1, (int)std::ceil(glm::length(glm::vec2(segment.x, segment.z)) / stepLength));
+	float previous = 0.0f;
+
+	for (int i = 1; i <= steps; ++i)
+	{
+		float current = (float)i / steps;
+		glm::vec3 pos = start + segment * current;
+
+		if (pos.y <= terrain.GetHeightOfTerrain(pos.x, pos.z))
+		{
+			float low = previous, high = current;
+
+			for (int j = 0; j < 6; ++j)
+			{
+				float middle = 0.5f * (low + high);
+				glm::vec3 probe = start + segment * middle;
+
+				if (probe.y <= terrain.GetHeightOfTerrain(probe.x, probe.z))
+					high = middle;
+				else
+					low = middle;
+			}
+
+			t = high;
+			return true;
+		}
+
+		previous = current;
+	}
+
+	return false;
+}
+
+// -------------------
+// Descripción: Función que calcula cuándo (t en [0, 1]) el segmento start-end entra en la esfera 'center'/'radius'
+// -------------------
+bool ProjectileSystem::SweepSphere(const glm::vec3& start, const glm::vec3& end, const glm::vec3& center, float radius, float& t)
+{
+	glm::vec3 d = end - start;
+	glm::vec3 m = start - center;
+
+	float c = glm::dot(m, m) - radius * radius;
+
+	// Empieza dentro de la esfera
+	if (c <= 0.0f)
+	{
+		t = 0.0f;
+		return true;
+	}
+
+	float a = glm::dot(d, d);
+	float b = glm::dot(m, d);
+
+	if (b >= 0.0f || a <= 0.0f)
+		return false;
+
+	float discriminant = b * b - a * c;
+
+	if (discriminant < 0.0f)
+		return false;
+
+	t = (-b - std::sqrt(discriminant)) / a;
+	return t <= 1.0f;
+}
+
+// Devuelve el proyectil al grupo y, si era de un enemigo, le permite lanzar el siguiente
+void ProjectileSystem::Release(unsigned int activeIndex, EnemyManager& enemies)
+{
+	unsigned int projectile = m_active[activeIndex];
+
+	if (m_owner[projectile] != NO_OWNER)
+		enemies.OnProjectileReleased(m_owner[projectile]);
+
+	m_lifeTime[projectile] = 0.0f;
+	m_free.push_back(projectile);
+	m_active[activeIndex] = m_active.back();
+	m_active.pop_back();
+}
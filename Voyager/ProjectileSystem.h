@@ -0,0 +1,127 @@
+#pragma once
+#ifndef __PROJECTILESYSTEM_H__
+#define __PROJECTILESYSTEM_H__
+
+#include "Camera.h"
+#include "Terrain.h"
+#include "EnemyManager.h"
+#include "SpatialGrid.h"
+#include "InstancedBatch.h"
+#include "Shader.h"
+#include <cstdint>
+#include <vector>
+
+enum ProjectileType { PROJECTILE_DRONE, PROJECTILE_BULLET, PROJECTILE_SNIPER, TOTAL_PROJECTILE_TYPES };
+enum ProjectileTarget { HIT_ENEMY, HIT_PLAYER, HIT_TERRAIN };
+
+struct ProjectileHit
+{
+	ProjectileType m_type;
+	ProjectileTarget m_target;
+	unsigned int m_enemy;
+	glm::vec3 m_pos;
+};
+
+// Sistema de proyectiles con un grupo de capacidad fija (sin reservas de memoria durante el juego).
+// Cada paso mueve los proyectiles con caída balística y prueba el segmento recorrido como una esfera barrida
+// contra los enemigos, el jugador y el terreno, así un proyectil rápido no puede atravesar nada entre dos cuadros.
+// Los proyectiles guiados (los drones de los enemigos) buscan su objetivo con los núcleos de dirección en lote,
+// se separan de los demás guiados y avisan a su dueño cuando desaparecen para que pueda lanzar otro.
+class ProjectileSystem
+{
+public:
+	ProjectileSystem();
+	~ProjectileSystem();
+
+	void Init(unsigned int capacity);
+	int Fire(ProjectileType type, const glm::vec3& pos, const glm::vec3& dir, bool fromPlayer);
+	int FireHoming(ProjectileType type, const glm::vec3& pos, const glm::vec3& target, unsigned int owner);
+	void Update(Terrain& terrain, EnemyManager& enemies, Camera& cam, float dt);
+	void Draw(Camera& cam);
+	void Clear();
+
+	// Consulta de los proyectiles guiados (rejilla reconstruida al final de cada Update)
+	void QueryHoming(const glm::vec3& center, float radius, std::vector<unsigned int>& projectiles);
+
+	void SetRenderObject(ProjectileType type, short int objId) { m_renderObjects[type] = objId; }
+	void SetPlayerRadius(float radius) { m_playerRadius = radius; }
+
+	const std::vector<ProjectileHit>& GetHits() { return m_hits; }
+	unsigned int GetActiveCount() { return (unsigned int)m_active.size(); }
+	unsigned int GetCapacity() { return m_capacity; }
+	bool IsActive(unsigned int projectile) { return m_lifeTime[projectile] > 0.0f; }
+	ProjectileType GetType(unsigned int projectile) { return (ProjectileType)m_type[projectile]; }
+	glm::vec3 GetPos(unsigned int projectile) { return glm::vec3(m_posX[projectile], m_posY[projectile], m_posZ[projectile]); }
+	float GetRadius(ProjectileType type) { return m_specs[type].m_radius; }
+
+private:
+	enum { NO_OWNER = 0xFFFFFFFF };
+
+	// Área del terreno (256 vértices x 3 unidades) y tamaño de celda de la rejilla de proyectiles guiados
+	enum { WORLD_SIZE = 768, GRID_CELL_SIZE = 16 };
+
+	// Vecinos máximos que cada proyectil guiado tiene en cuenta para la separación
+	enum { HOMING_NEIGHBOURS = 8, PARALLEL_BATCH_SIZE = 256 };
+
+	// Propiedades de cada tipo de proyectil. Con 'm_hoverHeight' > 0 el proyectil vuela a esa altura sobre el terreno;
+	// los guiados desaparecen al llegar a 'm_arrivalRadius' de su objetivo en el plano XZ.
+	struct ProjectileSpec
+	{
+		float m_speed;
+		float m_gravityScale;
+		float m_lifeTime;
+		float m_radius;
+		float m_damage;
+		float m_drawScale;
+		float m_hoverHeight;
+		float m_arrivalRadius;
+	};
+
+	// Copia compacta de los proyectiles guiados para los núcleos de dirección en lote
+	struct HomingSwarm
+	{
+		std::vector<unsigned int> m_agents, m_idToAgent;
+		std::vector<float> m_posX, m_posY, m_posZ;
+		std::vector<float> m_velX, m_velY, m_velZ;
+		std::vector<float> m_targetX, m_targetY, m_targetZ;
+		std::vector<float> m_forceX, m_forceY, m_forceZ;
+		std::vector<unsigned int> m_neighbourCount, m_neighbours;
+	};
+
+	ProjectileSpec m_specs[TOTAL_PROJECTILE_TYPES];
+	short int m_renderObjects[TOTAL_PROJECTILE_TYPES];
+
+	// Estado de cada proyectil en arreglos paralelos
+	std::vector<float> m_posX, m_posY, m_posZ;
+	std::vector<float> m_velX, m_velY, m_velZ;
+	std::vector<float> m_targetX, m_targetY, m_targetZ;
+	std::vector<float> m_lifeTime;
+	std::vector<unsigned int> m_owner;
+	std::vector<uint8_t> m_type, m_fromPlayer, m_homing;
+
+	// Proyectiles libres (pila) y activos (arreglo denso, se elimina intercambiando con el último)
+	std::vector<unsigned int> m_free, m_active;
+	std::vector<unsigned int> m_nearbyEnemies;
+	std::vector<ProjectileHit> m_hits;
+
+	SpatialGrid m_homingGrid;
+	HomingSwarm m_swarm;
+
+	// Un lote instanciado por tipo de proyectil
+	InstancedBatch m_batches[TOTAL_PROJECTILE_TYPES];
+	Shader m_instancingShader;
+
+	unsigned int m_capacity;
+	float m_gravity, m_playerRadius;
+
+	// Private functions
+	int Allocate(ProjectileType type, const glm::vec3& pos, const glm::vec3& velocity, bool fromPlayer);
+	void SteerHoming(float dt);
+	void RebuildGrid();
+	bool SweepEnemies(EnemyManager& enemies, const glm::vec3& start, const glm::vec3& end, float radius, float& t, unsigned int& enemy);
+	bool SweepTerrain(Terrain& terrain, const glm::vec3& start, const glm::vec3& end, float& t);
+	bool SweepSphere(const glm::vec3& start, const glm::vec3& end, const glm::vec3& center, float radius, float& t);
+	void Release(unsigned int activeIndex, EnemyManager& enemies);
+};
+
+#endif // !__PROJECTILESYSTEM_H__
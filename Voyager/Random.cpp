@@ -0,0 +1,190 @@
+#include "Random.h"
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define RANDOM_SSE
+#include <emmintrin.h>
+#endif
+
+// -------------------
+// Descripción: mezclador SplitMix64, para derivar estados bien distribuidos a partir de semillas parecidas (0, 1, 2...)
+// -------------------
+static inline uint64_t SplitMix64(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+static inline uint32_t RotateLeft(uint32_t value, int bits)
+{
+	return (value << bits) | (value >> (32 - bits));
+}
+
+RandomStream::RandomStream() :
+	m_state(0x853C49E6748FEA9Bull),
+	m_increment(0xDA3E39CB94B95BDBull)
+{}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream) :
+	m_state(0),
+	m_increment((stream << 1) | 1)
+{
+	NextUInt();
+	m_state += seed;
+	NextUInt();
+}
+
+uint32_t RandomStream::NextUInt()
+{
+	uint64_t old = m_state;
+	m_state = old * 6364136223846793005ull + m_increment;
+
+	uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+	uint32_t rotation = (uint32_t)(old >> 59);
+	return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+// -------------------
+// Descripción: Función que devuelve un número en [0, 1) con los 24 bits altos (la precisión de un float)
+// -------------------
+float RandomStream::NextFloat()
+{
+	return (NextUInt() >> 8) * (1.0f / 16777216.0f);
+}
+
+float RandomStream::Range(float min, float max)
+{
+	return min + (max - min) * NextFloat();
+}
+
+// -------------------
+// Descripción: Función que devuelve un entero en [min, max] (ambos incluidos) con una multiplicación en vez del módulo
+// -------------------
+int RandomStream::RangeInt(int min, int max)
+{
+	uint32_t range = (uint32_t)(max - min) + 1;
+	return min + (int)(((uint64_t)NextUInt() * range) >> 32);
+}
+
+// -------------------
+// Descripción: Función que crea un flujo hijo independiente; el padre avanza un paso, así dos Split seguidos dan flujos distintos
+// -------------------
+RandomStream RandomStream::Split(uint64_t id)
+{
+	uint64_t seed = SplitMix64(((uint64_t)NextUInt() << 32) ^ m_state);
+	return RandomStream(seed, SplitMix64(id ^ m_increment));
+}
+
+// -------------------
+// Descripción: Función que llena 'values' con números en [min, max) para partículas e instancias.
+// Usa cuatro generadores xoshiro128+ en paralelo (uno por carril SSE) sembrados desde este flujo; la versión escalar
+// calcula los mismos carriles, así el resultado no depende de si hay SSE.
+// -------------------
+void RandomStream::Fill(float* values, unsigned int count, float min, float max)
+{
+	uint32_t lanes[4][4];
+
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int lane = 0; lane < 4; ++lane)
+			lanes[i][lane] = NextUInt();
+	}
+
+	// xoshiro no puede tener el estado entero a cero
+	for (int lane = 0; lane < 4; ++lane)
+		lanes[0][lane] |= 1;
+
+	float scale = (max - min) * (1.0f / 16777216.0f);
+	unsigned int blocks = count / 4;
+	float tail[4];
+
+#if defined(RANDOM_SSE)
+	__m128i s0 = _mm_loadu_si128((const __m128i*)lanes[0]);
+	__m128i s1 = _mm_loadu_si128((const __m128i*)lanes[1]);
+	__m128i s2 = _mm_loadu_si128((const __m128i*)lanes[2]);
+	__m128i s3 = _mm_loadu_si128((const __m128i*)lanes[3]);
+	__m128 scale4 = _mm_set1_ps(scale);
+	__m128 min4 = _mm_set1_ps(min);
+
+	for (unsigned int block = 0; block <= blocks; ++block)
+	{
+		__m128i result = _mm_add_epi32(s0, s3);
+		__m128i t = _mm_slli_epi32(s1, 9);
+
+		s2 = _mm_xor_si128(s2, s0);
+		s3 = _mm_xor_si128(s3, s1);
+		s1 = _mm_xor_si128(s1, s2);
+		s0 = _mm_xor_si128(s0, s3);
+		s2 = _mm_xor_si128(s2, t);
+		s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+		__m128 value = _mm_add_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), scale4));
+
+		if (block < blocks)
+			_mm_storeu_ps(values + block * 4, value);
+		else
+			_mm_storeu_ps(tail, value);
+	}
+#else
+	for (unsigned int block = 0; block <= blocks; ++block)
+	{
+		float* out = block < blocks ? values + block * 4 : tail;
+
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			uint32_t result = lanes[0][lane] + lanes[3][lane];
+			uint32_t t = lanes[1][lane] << 9;
+
+			lanes[2][lane] ^= lanes[0][lane];
+			lanes[3][lane] ^= lanes[1][lane];
+			lanes[1][lane] ^= lanes[2][lane];
+			lanes[0][lane] ^= lanes[3][lane];
+			lanes[2][lane] ^= t;
+			lanes[3][lane] = RotateLeft(lanes[3][lane], 11);
+
+			out[lane] = min + (float)(result >> 8) * scale;
+		}
+	}
+#endif
+
+	std::memcpy(values + blocks * 4, tail, sizeof(float) * (count - blocks * 4));
+}
+
+Random::Random() :
+	m_seed(0x5EED5EED5EEDull)
+{
+	SetSeed(m_seed);
+}
+
+Random::~Random()
+{}
+
+// -------------------
+// Descripción: Función que fija la semilla de la partida y reinicia los contadores de flujos de cada sistema
+// -------------------
+void Random::SetSeed(uint64_t seed)
+{
+	m_seed = seed;
+
+	for (int i = 0; i < TOTAL_STREAMS; ++i)
+		m_nextIndex[i] = 0;
+}
+
+// -------------------
+// Descripción: Función que deriva el flujo (sistema, índice) de la semilla; seguro desde cualquier hilo
+// -------------------
+RandomStream Random::GetStream(Stream system, uint64_t index)
+{
+	uint64_t key = SplitMix64(((uint64_t)system << 48) ^ index);
+	return RandomStream(SplitMix64(m_seed ^ key), key);
+}
+
+// -------------------
+// Descripción: Función que entrega el siguiente flujo del sistema (para objetos creados en orden desde el hilo principal)
+// -------------------
+RandomStream Random::CreateStream(Stream system)
+{
+	return GetStream(system, m_nextIndex[system]++);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef __RANDOM_H__
+#define __RANDOM_H__
+
+#include <cstdint>
+
+// Flujo de números aleatorios PCG32: 64 bits de estado y un incremento propio por flujo, así dos flujos con la misma
+// semilla no se solapan. Es un objeto de valor: cada sistema, hilo o lote de trabajo guarda el suyo y no comparte estado.
+class RandomStream
+{
+public:
+	RandomStream();
+	RandomStream(uint64_t seed, uint64_t stream);
+
+	uint32_t NextUInt();
+	float NextFloat();
+	float Range(float min, float max);
+	int RangeInt(int min, int max);
+	bool Chance(float probability) { return NextFloat() < probability; }
+	RandomStream Split(uint64_t id);
+
+	void Fill(float* values, unsigned int count, float min, float max);
+
+private:
+	uint64_t m_state, m_increment;
+};
+
+// Subsistema de aleatoriedad: una semilla de partida de la que se derivan los flujos de cada sistema.
+// GetStream(sistema, índice) depende solo de la semilla, el sistema y el índice (no del hilo ni del orden de llamada),
+// de modo que la generación en paralelo sigue siendo determinista si cada lote usa su índice.
+class Random
+{
+public:
+	enum Stream { STREAM_ENEMIES, STREAM_ATMOSPHERE, STREAM_ASTEROIDS, STREAM_PARTICLES, STREAM_AUDIO, TOTAL_STREAMS };
+
+	~Random();
+
+	static Random& GetInstance()
+	{
+		static Random instance;
+		return instance;
+	}
+
+	Random(Random const&) = delete;
+	void operator=(Random const&) = delete;
+
+	void SetSeed(uint64_t seed);
+	uint64_t GetSeed() { return m_seed; }
+
+	RandomStream GetStream(Stream system, uint64_t index);
+	RandomStream CreateStream(Stream system);
+
+private:
+	Random();
+
+	uint64_t m_seed;
+	uint64_t m_nextIndex[TOTAL_STREAMS];
+};
+
+#endif // !__RANDOM_H__
@@ -0,0 +1,294 @@
+#include "RenderQueue.h"
+#include "GLState.h"
+#include "Mesh.h"
+#include <algorithm>
+#include <cstdio>
+
+DrawPacket::DrawPacket() :
+	m_shader(nullptr),
+	m_vao(0),
+	m_mode(GL_TRIANGLES),
+	m_count(0),
+	m_instanceCount(1),
+	m_indexed(true),
+	m_indirectBuffer(0),
+	m_indirectOffset(0),
+	m_totalTextures(0),
+	m_flags(0),
+	m_samplerLayout(0),
+	m_model(1.0f)
+{}
+
+RenderQueue::RenderQueue() :
+	m_viewPos(0.0f),
+	m_lightPos(0.0f),
+	m_maxDepth(3000.0f),
+	m_stats()
+{}
+
+RenderQueue::~RenderQueue()
+{}
+
+// -------------------
+// Descripción: Función que guarda un paquete junto con su clave; no llama a OpenGL
+// -------------------
+void RenderQueue::Submit(Pass pass, const DrawPacket& packet)
+{
+	if (packet.m_shader == nullptr || packet.m_count == 0)
+	{
+		printf("ERROR: Draw packet submitted without a shader or geometry\n");
+		return;
+	}
+
+	SortItem item;
+	item.m_key = MakeKey(pass, packet);
+	item.m_index = (uint32_t)m_packets.size();
+
+	m_items.push_back(item);
+	m_packets.push_back(packet);
+}
+
+// -------------------
+// Descripción: Función que ordena los paquetes del cuadro, los dibuja a través de GLState y vacía la cola
+// -------------------
+void RenderQueue::Flush()
+{
+	m_stats = Stats();
+
+	if (m_items.empty())
+		return;
+
+	RadixSort();
+	m_initialisedPrograms.clear();
+
+	GLState& state = GLState::GetInstance();
+	GLState::Counters before = state.GetFrameCounters();
+
+	// El estado de mezcla y profundidad de antes de la cola se restaura al final
+	bool blend = state.IsEnabled(GL_BLEND);
+	bool depthTest = state.IsEnabled(GL_DEPTH_TEST);
+	bool depthMask = state.GetDepthMask();
+	GLenum depthFunc = state.GetDepthFunc();
+	GLenum blendFunc[4];
+	state.GetBlendFunc(blendFunc);
+	unsigned int currentPass = TOTAL_PASSES;
+
+	for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
+	{
+		const DrawPacket& packet = m_packets[(*iter).m_index];
+		unsigned int pass = (unsigned int)((*iter).m_key >> 60);
+
+		if (pass != currentPass)
+		{
+			SetPassState(pass);
+			currentPass = pass;
+		}
+
+		GLuint program = packet.m_shader->GetShaderProgram();
+		state.UseProgram(program);
+
+		// Los uniformes que no cambian entre objetos se suben una vez por programa y cuadro
+		if (std::find(m_initialisedPrograms.begin(), m_initialisedPrograms.end(), program) == m_initialisedPrograms.end())
+		{
+			packet.m_shader->SetVec3("lightPos", m_lightPos);
+			m_initialisedPrograms.push_back(program);
+		}
+
+		packet.m_shader->SetMat4("model", packet.m_model);
+		packet.m_shader->SetBool("EnableSpotlight", (packet.m_flags & DrawPacket::FLAG_SPOTLIGHT) != 0);
+		packet.m_shader->SetBool("fogActive", (packet.m_flags & DrawPacket::FLAG_FOG) != 0);
+
+		// Un programa compartido por mallas con distintos tipos de textura necesita otros samplers al cambiar de malla
+		Mesh::BindSamplers(*packet.m_shader, packet.m_samplerLayout);
+
+		for (unsigned int i = 0; i < packet.m_totalTextures; ++i)
+			state.BindTextureUnit(i, packet.m_textures[i]);
+
+		state.BindVertexArray(packet.m_vao);
+
+		if (packet.m_indirectBuffer != 0)
+		{
+			state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, packet.m_indirectBuffer);
+			state.DrawElementsIndirect(packet.m_mode, packet.m_indirectOffset);
+		}
+		else if (packet.m_indexed)
+			state.DrawElements(packet.m_mode, packet.m_count, packet.m_instanceCount);
+		else
+			state.DrawArrays(packet.m_mode, 0, packet.m_count, packet.m_instanceCount);
+
+		++m_stats.m_draws;
+		++m_stats.m_requestedPrograms;
+		m_stats.m_requestedTextures += packet.m_totalTextures * 2;
+		m_stats.m_requestedVaos += 2;
+	}
+
+	state.DepthMask(depthMask ? GL_TRUE : GL_FALSE);
+	state.DepthFunc(depthFunc);
+	state.BlendFuncSeparate(blendFunc[0], blendFunc[1], blendFunc[2], blendFunc[3]);
+
+	if (blend)
+		state.Enable(GL_BLEND);
+	else
+		state.Disable(GL_BLEND);
+
+	if (depthTest)
+		state.Enable(GL_DEPTH_TEST);
+	else
+		state.Disable(GL_DEPTH_TEST);
+
+	const GLState::Counters& after = state.GetFrameCounters();
+	m_stats.m_issuedPrograms = after.m_programBinds - before.m_programBinds;
+	m_stats.m_issuedTextures = after.m_textureBinds - before.m_textureBinds;
+	m_stats.m_issuedVaos = after.m_vaoBinds - before.m_vaoBinds;
+
+	Clear();
+}
+
+void RenderQueue::Clear()
+{
+	m_packets.clear();
+	m_items.clear();
+}
+
+void RenderQueue::PrintStats() const
+{
+	printf("RenderQueue: %u draws | programs %u -> %u | textures %u -> %u | VAOs %u -> %u\n", m_stats.m_draws,
+		m_stats.m_requestedPrograms, m_stats.m_issuedPrograms, m_stats.m_requestedTextures, m_stats.m_issuedTextures,
+		m_stats.m_requestedVaos, m_stats.m_issuedVaos);
+}
+
+// -------------------
+// Descripción: Función que construye la clave de orden. El material es un hash de las texturas reducido a 16 bits y la
+// profundidad es la distancia a la cámara del origen del objeto, cuantizada a 20 bits sobre m_maxDepth.
+// -------------------
+uint64_t RenderQueue::MakeKey(Pass pass, const DrawPacket& packet)
+{
+	uint32_t hash = 2166136261u;
+
+	for (unsigned int i = 0; i < packet.m_totalTextures; ++i)
+		hash = (hash ^ packet.m_textures[i]) * 16777619u;
+
+	uint64_t program = GetProgramIndex(packet.m_shader->GetShaderProgram()) & 0xFFF;
+	uint64_t material = (hash ^ (hash >> 16)) & 0xFFFF;
+	uint64_t vao = packet.m_vao & 0xFFF;
+
+	float distance = glm::length(glm::vec3(packet.m_model[3]) - m_viewPos);
+	uint64_t depth = (uint64_t)(glm::clamp(distance / m_maxDepth, 0.0f, 1.0f) * 0xFFFFF);
+
+	if (pass == PASS_TRANSPARENT)
+		return ((uint64_t)pass << 60) | ((0xFFFFF - depth) << 40) | (program << 28) | (material << 12) | vao;
+
+	return ((uint64_t)pass << 60) | (program << 48) | (material << 32) | (vao << 20) | depth;
+}
+
+// -------------------
+// Descripción: Función que traduce el nombre del programa a un índice pequeño (orden de aparición) para la clave
+// -------------------
+unsigned int RenderQueue::GetProgramIndex(GLuint program)
+{
+	auto iter = std::find(m_programIds.begin(), m_programIds.end(), program);
+
+	if (iter != m_programIds.end())
+		return (unsigned int)(iter - m_programIds.begin());
+
+	m_programIds.push_back(program);
+	return (unsigned int)m_programIds.size() - 1;
+}
+
+// -------------------
+// Descripción: Radix sort LSD de 8 bits por pasada. Los ocho histogramas se cuentan en un solo recorrido y se salta
+// cada byte que vale lo mismo en todas las claves (con pocos pases y programas la mayoría de los bytes altos).
+// -------------------
+void RenderQueue::RadixSort()
+{
+	size_t count = m_items.size();
+	m_scratch.resize(count);
+
+	uint32_t histograms[8][256] = {};
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		uint64_t key = m_items[i].m_key;
+
+		for (int byte = 0; byte < 8; ++byte)
+			++histograms[byte][(key >> (byte * 8)) & 0xFF];
+	}
+
+	SortItem* source = m_items.data();
+	SortItem* destination = m_scratch.data();
+
+	for (int byte = 0; byte < 8; ++byte)
+	{
+		uint32_t* histogram = histograms[byte];
+		int shift = byte * 8;
+
+		if (histogram[(source[0].m_key >> shift) & 0xFF] == (uint32_t)count)
+			continue;
+
+		uint32_t offset = 0;
+
+		for (int bucket = 0; bucket < 256; ++bucket)
+		{
+			uint32_t total = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += total;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+			destination[histogram[(source[i].m_key >> shift) & 0xFF]++] = source[i];
+
+		std::swap(source, destination);
+	}
+
+	if (source != m_items.data())
+		m_items.swap(m_scratch);
+}
+
+// -------------------
+// Descripción: Función que prepara el estado fijo de cada pase. Cada pase fija todo su estado de mezcla y profundidad,
+// así no hereda nada del pase anterior ni de lo que hubiera antes de la cola.
+//   opacos:         profundidad con escritura, sin mezcla
+//   cielo:          se dibuja detrás de los opacos en el plano lejano (GL_LEQUAL) sin escribir profundidad
+//   transparentes:  mezcla alfa, profundidad sin escritura
+//   interfaz:       mezcla alfa, sin prueba de profundidad
+// -------------------
+void RenderQueue::SetPassState(unsigned int pass)
+{
+	GLState& state = GLState::GetInstance();
+
+	switch (pass)
+	{
+	case PASS_OPAQUE:
+		state.Enable(GL_DEPTH_TEST);
+		state.DepthFunc(GL_LESS);
+		state.DepthMask(GL_TRUE);
+		state.Disable(GL_BLEND);
+		break;
+
+	case PASS_SKY:
+		state.Enable(GL_DEPTH_TEST);
+		state.DepthFunc(GL_LEQUAL);
+		state.DepthMask(GL_FALSE);
+		state.Disable(GL_BLEND);
+		break;
+
+	case PASS_TRANSPARENT:
+		state.Enable(GL_DEPTH_TEST);
+		state.DepthFunc(GL_LESS);
+		state.DepthMask(GL_FALSE);
+		state.Enable(GL_BLEND);
+		state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		break;
+
+	case PASS_OVERLAY:
+		state.Disable(GL_DEPTH_TEST);
+		state.DepthMask(GL_FALSE);
+		state.Enable(GL_BLEND);
+		state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		break;
+
+	default:
+		printf("ERROR: Unknown render pass %u\n", pass);
+		break;
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#ifndef __RENDERQUEUE_H__
+#define __RENDERQUEUE_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "Shader.h"
+#include <cstdint>
+#include <vector>
+
+// Paquete de dibujo: todo lo que hace falta para emitir una llamada sin volver a preguntar al objeto que lo envió
+struct DrawPacket
+{
+	enum { MAX_TEXTURES = 8 };
+	enum { FLAG_SPOTLIGHT = 1 << 0, FLAG_FOG = 1 << 1 };
+
+	DrawPacket();
+
+	Shader* m_shader;
+	GLuint m_vao;
+	GLenum m_mode;
+	GLsizei m_count;
+	GLsizei m_instanceCount;
+	bool m_indexed;
+	GLuint m_indirectBuffer;	// Si no es 0, el dibujo lee sus parámetros de este búfer (p. ej. escritos por GpuCuller)
+	GLintptr m_indirectOffset;
+	GLuint m_textures[MAX_TEXTURES];
+	unsigned int m_totalTextures;
+	unsigned int m_flags;
+	unsigned int m_samplerLayout;	// Disposición de samplers de una malla (Mesh::GetSamplerLayout); 0 si el objeto pone los suyos
+	glm::mat4 m_model;
+};
+
+// Cola de dibujo ordenada. Los sistemas envían paquetes durante el cuadro y Flush los ordena por una clave de 64 bits
+// (pase, programa, material, VAO, profundidad) con un radix sort y los emite a través de GLState, que se salta
+// glUseProgram, glBindTexture y glBindVertexArray cuando el valor ya está puesto.
+// Disposición de la clave (del bit más alto al más bajo):
+//   opacos, cielo, interfaz:  pase (4) | programa (12) | material (16) | VAO (12) | profundidad de cerca a lejos (20)
+//   transparentes:            pase (4) | profundidad de lejos a cerca (20) | programa (12) | material (16) | VAO (12)
+class RenderQueue
+{
+public:
+	enum Pass { PASS_OPAQUE, PASS_SKY, PASS_TRANSPARENT, PASS_OVERLAY, TOTAL_PASSES };
+
+	// Cambios de estado de un Flush. "Requested" es lo que harían las llamadas inmediatas sin ordenar ni filtrar (un
+	// glUseProgram por objeto, y enlazar y desenlazar cada textura y el VAO); "Issued" es lo que GLState deja llegar a OpenGL.
+	struct Stats
+	{
+		unsigned int m_draws;
+		unsigned int m_requestedPrograms, m_issuedPrograms;
+		unsigned int m_requestedTextures, m_issuedTextures;
+		unsigned int m_requestedVaos, m_issuedVaos;
+	};
+
+	RenderQueue();
+	~RenderQueue();
+
+	void Submit(Pass pass, const DrawPacket& packet);
+	void Flush();
+	void Clear();
+
+	void SetViewPosition(const glm::vec3& viewPos) { m_viewPos = viewPos; }
+	void SetLightPosition(const glm::vec3& lightPos) { m_lightPos = lightPos; }
+	void SetMaxDepth(float maxDepth) { m_maxDepth = maxDepth; }
+
+	unsigned int GetTotalPackets() const { return (unsigned int)m_packets.size(); }
+	const Stats& GetStats() const { return m_stats; }
+	void PrintStats() const;
+
+private:
+	struct SortItem
+	{
+		uint64_t m_key;
+		uint32_t m_index;
+	};
+
+	std::vector<DrawPacket> m_packets;
+	std::vector<SortItem> m_items, m_scratch;
+	std::vector<GLuint> m_programIds;
+	std::vector<GLuint> m_initialisedPrograms;
+	glm::vec3 m_viewPos, m_lightPos;
+	float m_maxDepth;
+	Stats m_stats;
+
+	// Private functions
+	uint64_t MakeKey(Pass pass, const DrawPacket& packet);
+	unsigned int GetProgramIndex(GLuint program);
+	void RadixSort();
+	void SetPassState(unsigned int pass);
+};
+
+#endif // !__RENDERQUEUE_H__
@@ -0,0 +1,101 @@
+#include "SceneUniforms.h"
+#include "GLState.h"
+#include <cstring>
+
+SceneUniforms::SceneUniforms() :
+	m_cameraUbo(0),
+	m_lightUbo(0)
+{}
+
+SceneUniforms::~SceneUniforms()
+{}
+
+// -------------------
+// Descripción: Función que crea los dos búferes y los deja enlazados a sus puntos fijos para el resto del programa
+// -------------------
+void SceneUniforms::Init()
+{
+	if (m_cameraUbo != 0)
+		return;
+
+	glGenBuffers(1, &m_cameraUbo);
+	GLState::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, m_cameraUbo);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraData), nullptr, GL_DYNAMIC_DRAW);
+
+	glGenBuffers(1, &m_lightUbo);
+	GLState::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, m_lightUbo);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(LightData), nullptr, GL_DYNAMIC_DRAW);
+	GLState::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	GLState::GetInstance().BindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BINDING, m_cameraUbo);
+	GLState::GetInstance().BindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BINDING, m_lightUbo);
+}
+
+// -------------------
+// Descripción: Función que sube las matrices y la posición de la cámara principal (una vez por cuadro, antes de dibujar)
+// -------------------
+void SceneUniforms::UpdateCamera(Camera& cam, float time)
+{
+	CameraData data;
+	data.m_view = cam.GetViewMatrix();
+	data.m_projection = cam.GetProjectionMatrix();
+	data.m_viewProjection = data.m_projection * data.m_view;
+	data.m_viewPos = cam.GetCameraPos();
+	data.m_time = time;
+
+	GLState::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, m_cameraUbo);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
+	GLState::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// -------------------
+// Descripción: Función que sube el conjunto de luces; una luz nula se sube apagada (todo a cero)
+// -------------------
+void SceneUniforms::UpdateLights(DirectionalLight* directionLight, PointLight* lamp, SpotLight* spotlight)
+{
+	LightData data;
+	std::memset(&data, 0, sizeof(data));
+
+	if (directionLight != nullptr)
+	{
+		data.m_dirLight.m_direction = directionLight->GetDirection();
+		data.m_dirLight.m_ambient = directionLight->GetAmbient();
+		data.m_dirLight.m_diffuse = directionLight->GetDiffuse();
+		data.m_dirLight.m_specular = directionLight->GetSpecular();
+		data.m_dirLight.m_lightColour = directionLight->GetColour();
+	}
+
+	// Con todo a cero la atenuación y el cono dividirían entre cero
+	data.m_pointLight.m_constant = 1.0f;
+	data.m_spotlight.m_constant = 1.0f;
+	data.m_spotlight.m_cutOff = 1.0f;
+
+	if (lamp != nullptr)
+	{
+		data.m_pointLight.m_position = lamp->GetPos();
+		data.m_pointLight.m_ambient = lamp->GetAmbient();
+		data.m_pointLight.m_diffuse = lamp->GetDiffuse();
+		data.m_pointLight.m_specular = lamp->GetSpecular();
+		data.m_pointLight.m_lightColour = lamp->GetColour();
+		data.m_pointLight.m_constant = lamp->GetConstant();
+		data.m_pointLight.m_linear = lamp->GetLinear();
+		data.m_pointLight.m_quadratic = lamp->GetQuadratic();
+	}
+
+	if (spotlight != nullptr)
+	{
+		data.m_spotlight.m_position = spotlight->GetPosition();
+		data.m_spotlight.m_direction = spotlight->GetDirection();
+		data.m_spotlight.m_diffuse = spotlight->GetDiffuse();
+		data.m_spotlight.m_specular = spotlight->GetSpecular();
+		data.m_spotlight.m_constant = spotlight->GetConstant();
+		data.m_spotlight.m_linear = spotlight->GetLinear();
+		data.m_spotlight.m_quadratic = spotlight->GetQuadratic();
+		data.m_spotlight.m_cutOff = glm::cos(glm::radians(spotlight->GetCutOff()));
+		data.m_spotlight.m_outerCutOff = glm::cos(glm::radians(spotlight->GetOuterCutOff()));
+	}
+
+	GLState::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, m_lightUbo);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
+	GLState::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef __SCENEUNIFORMS_H__
+#define __SCENEUNIFORMS_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "Camera.h"
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+
+// Bloques de uniformes (std140) compartidos por todos los programas: la cámara y el conjunto de luces se suben una vez
+// por cuadro y cada programa que declara "CameraBlock" o "LightBlock" los lee sin volver a fijar sus uniformes.
+// Las estructuras de aquí deben coincidir campo a campo con las de los sombreadores.
+class SceneUniforms
+{
+public:
+	enum { CAMERA_BINDING = 0, LIGHT_BINDING = 1 };
+
+	~SceneUniforms();
+
+	static SceneUniforms& GetInstance()
+	{
+		static SceneUniforms instance;
+		return instance;
+	}
+
+	SceneUniforms(SceneUniforms const&) = delete;
+	void operator=(SceneUniforms const&) = delete;
+
+	void Init();
+	void UpdateCamera(Camera& cam, float time);
+	void UpdateLights(DirectionalLight* directionLight, PointLight* lamp, SpotLight* spotlight);
+
+private:
+	SceneUniforms();
+
+	// layout (std140) uniform CameraBlock
+	struct CameraData
+	{
+		glm::mat4 m_view;
+		glm::mat4 m_projection;
+		glm::mat4 m_viewProjection;
+		glm::vec3 m_viewPos;
+		float m_time;
+	};
+
+	struct DirectionalLightData
+	{
+		glm::vec3 m_direction;
+		float m_padding0;
+		glm::vec3 m_ambient;
+		float m_padding1;
+		glm::vec3 m_diffuse;
+		float m_padding2;
+		glm::vec3 m_specular;
+		float m_padding3;
+		glm::vec3 m_lightColour;
+		float m_padding4;
+	};
+
+	struct PointLightData
+	{
+		glm::vec3 m_position;
+		float m_constant;
+		glm::vec3 m_ambient;
+		float m_linear;
+		glm::vec3 m_diffuse;
+		float m_quadratic;
+		glm::vec3 m_specular;
+		float m_padding0;
+		glm::vec3 m_lightColour;
+		float m_padding1;
+	};
+
+	struct SpotlightData
+	{
+		glm::vec3 m_position;
+		float m_cutOff;
+		glm::vec3 m_direction;
+		float m_outerCutOff;
+		glm::vec3 m_diffuse;
+		float m_constant;
+		glm::vec3 m_specular;
+		float m_linear;
+		float m_quadratic;
+		float m_padding[3];
+	};
+
+	// layout (std140) uniform LightBlock
+	struct LightData
+	{
+		DirectionalLightData m_dirLight;
+		PointLightData m_pointLight;
+		SpotlightData m_spotlight;
+	};
+
+	static_assert(sizeof(CameraData) == 208, "CameraData no coincide con CameraBlock (std140)");
+	static_assert(sizeof(LightData) == 240, "LightData no coincide con LightBlock (std140)");
+
+	GLuint m_cameraUbo, m_lightUbo;
+};
+
+#endif // !__SCENEUNIFORMS_H__
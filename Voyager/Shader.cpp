@@ -1,355 +1,278 @@
-#include "Shape.h"
+#include "Shader.h"
+#include "SceneUniforms.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+Shader::Shader() :
+	m_program(0)
+{}
+
+Shader::~Shader()
+{}
+
+GLuint Shader::CreateProgram(const char* vertexShaderFile, const char* fragmentShaderFile)
+{
+	GLuint shaders[2] = { CompileShader(vertexShaderFile, GL_VERTEX_SHADER), CompileShader(fragmentShaderFile, GL_FRAGMENT_SHADER) };
+	return LinkProgram(shaders, 2);
+}
+
+GLuint Shader::CreateProgram(const char* vertexShaderFile, const char* geometryShaderFile, const char* fragmentShaderFile)
+{
+	GLuint shaders[3] = { CompileShader(vertexShaderFile, GL_VERTEX_SHADER), CompileShader(geometryShaderFile, GL_GEOMETRY_SHADER),
+		CompileShader(fragmentShaderFile, GL_FRAGMENT_SHADER) };
+	return LinkProgram(shaders, 3);
+}
+
+GLuint Shader::CreateComputeProgram(const char* computeShaderFile)
+{
+	GLuint shader = CompileShader(computeShaderFile, GL_COMPUTE_SHADER);
+	return LinkProgram(&shader, 1);
+}
 
 // -------------------
-// Descripcin: funcin auxiliar que calcula la tangente de un vrtice dado de un tringulo
+// Descripción: Función que libera el programa. No se hace en el destructor porque los Shader se copian por valor
+// (componentes de GameObject, mallas) y todas las copias comparten el mismo programa.
 // -------------------
-std::vector<glm::vec3> CalculateVertexTangent(std::vector<glm::vec3> positions, std::vector<glm::vec2> textures)
+void Shader::DestroyProgram()
 {
-	std::vector<glm::vec3> tangents;
-	glm::vec3 tan1, tan2;
-
-	// Triangle 1
-	glm::vec3 edge1 = positions.at(1) - positions.at(0);
-	glm::vec3 edge2 = positions.at(2) - positions.at(0);
-	glm::vec2 deltaUV1 = textures.at(1) - textures.at(0);
-	glm::vec2 deltaUV2 = textures.at(2) - textures.at(0);
-
-	float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-
-	tan1.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-	tan1.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-	tan1.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-	tan1 = glm::normalize(tan1);
-	tangents.push_back(tan1);
-
-	// Triangle 2
-	edge1 = positions.at(2) - positions.at(0);
-	edge2 = positions.at(3) - positions.at(0);
-	deltaUV1 = textures.at(2) - textures.at(0);
-	deltaUV2 = textures.at(3) - textures.at(0);
-
-	f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-
-	tan2.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-	tan2.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-	tan2.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-	tan2 = glm::normalize(tan2);
-	tangents.push_back(tan2);
-
-	return tangents;
+	if (m_program != 0)
+		GLState::GetInstance().DeleteProgram(m_program);
+
+	m_program = 0;
+	m_uniforms.clear();
 }
 
-class Triangle : public Shape
+// -------------------
+// Descripción: Función que busca la posición de un uniforme en la caché (búsqueda binaria por hash); -1 si el programa no lo usa
+// -------------------
+GLint Shader::GetUniformLocation(UniformName name) const
 {
-public:
-	virtual void InitVertexData() override
-	{
-		m_triVertices.push_back(Vertex(glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-		m_triVertices.push_back(Vertex(glm::vec3(0.5f, -0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(0.5f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-		m_triVertices.push_back(Vertex(glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-	}
+	auto iter = std::lower_bound(m_uniforms.begin(), m_uniforms.end(), name.GetHash(),
+		[](const std::pair<uint32_t, GLint>& uniform, uint32_t hash) { return uniform.first < hash; });
 
-	virtual std::vector<Vertex> GetVertexData() override
-	{
-		return m_triVertices;
-	}
+	if (iter == m_uniforms.end() || iter->first != name.GetHash())
+		return -1;
 
-	virtual unsigned int GetVertexDataCount() override
-	{
-		return m_triVertices.size();
-	}
+	return iter->second;
+}
 
-	virtual unsigned int* GetIndexData() override
-	{
-		return m_triIndices;
-	}
+void Shader::SetBool(UniformName name, bool value) const
+{
+	GLint location = GetUniformLocation(name);
 
-	virtual unsigned int GetIndexDataCount() override
+	if (location >= 0)
 	{
-		return (sizeof(m_triIndices) / sizeof(m_triIndices[0]));
+		glUniform1i(location, (int)value);
+		GLState::GetInstance().CountUniformUpload();
 	}
+}
 
-private:
-	std::vector<Vertex> m_triVertices;
-	unsigned int m_triIndices[3] =
-	{
-		0, 1, 2
-	};
-};
-
-class Quad : public Shape
+void Shader::SetInt(UniformName name, int value) const
 {
-public:
-	virtual void InitVertexData() override
-	{
-		m_quadVertices.push_back(Vertex(glm::vec3(-1.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-		m_quadVertices.push_back(Vertex(glm::vec3(1.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-		m_quadVertices.push_back(Vertex(glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-		m_quadVertices.push_back(Vertex(glm::vec3(-1.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-	}
+	GLint location = GetUniformLocation(name);
 
-	virtual std::vector<Vertex> GetVertexData() override
+	if (location >= 0)
 	{
-		return m_quadVertices;
+		glUniform1i(location, value);
+		GLState::GetInstance().CountUniformUpload();
 	}
+}
 
-	virtual unsigned int GetVertexDataCount() override
-	{
-		return m_quadVertices.size();
-	}
+void Shader::SetFloat(UniformName name, float value) const
+{
+	GLint location = GetUniformLocation(name);
 
-	virtual unsigned int* GetIndexData() override
+	if (location >= 0)
 	{
-		return m_quadIndices;
+		glUniform1f(location, value);
+		GLState::GetInstance().CountUniformUpload();
 	}
+}
 
-	virtual unsigned int GetIndexDataCount() override
-	{
-		return (sizeof(m_quadIndices) / sizeof(m_quadIndices[0]));
-	}
+void Shader::SetVec2(UniformName name, const glm::vec2& value) const
+{
+	GLint location = GetUniformLocation(name);
 
-private:
-	std::vector<Vertex> m_quadVertices;
-	unsigned int m_quadIndices[6] =
+	if (location >= 0)
 	{
-		0, 1, 2,
-		2, 3, 0
-	};
-};
+		glUniform2fv(location, 1, glm::value_ptr(value));
+		GLState::GetInstance().CountUniformUpload();
+	}
+}
 
-class Cube : public Shape
+void Shader::SetVec3(UniformName name, const glm::vec3& value) const
 {
-	virtual void InitVertexData() override
-	{
-		// El cubo se dibuja en un formato de bobinado en sentido contrario a las agujas del reloj para permitir la eliminacin de rostros.
-		// Cara frontal
-		std::vector<glm::vec3> frontFacePos;
-		frontFacePos.push_back(glm::vec3(-0.5f, -0.5f, 0.5f));
-		frontFacePos.push_back(glm::vec3(0.5f, -0.5f, 0.5f));
-		frontFacePos.push_back(glm::vec3(0.5f, 0.5f, 0.5f));
-		frontFacePos.push_back(glm::vec3(-0.5f, 0.5f, 0.5f));
-
-		std::vector<glm::vec2> textures;
-		textures.push_back(glm::vec2(0.0f, 0.0f));
-		textures.push_back(glm::vec2(1.0f, 0.0f));
-		textures.push_back(glm::vec2(1.0f, 1.0f));
-		textures.push_back(glm::vec2(0.0f, 1.0f));
-
-		std::vector<glm::vec3> frontFaceTan = CalculateVertexTangent(frontFacePos, textures);
-
-		m_cubeVertices.push_back(Vertex(frontFacePos.at(0), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(0), glm::vec3(0.0f, 0.0f, 1.0f), frontFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(frontFacePos.at(1), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(1), glm::vec3(0.0f, 0.0f, 1.0f), frontFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(frontFacePos.at(2), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(2), glm::vec3(0.0f, 0.0f, 1.0f), frontFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(frontFacePos.at(3), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(3), glm::vec3(0.0f, 0.0f, 1.0f), frontFaceTan.at(1)));
-
-		// Calcular tangentes para la cara posterior
-		std::vector<glm::vec3> backFacePos;
-		backFacePos.push_back(glm::vec3(0.5f, -0.5f, -0.5f));
-		backFacePos.push_back(glm::vec3(-0.5f, -0.5f, -0.5f));
-		backFacePos.push_back(glm::vec3(-0.5f, 0.5f, -0.5f));
-		backFacePos.push_back(glm::vec3(0.5f, 0.5f, -0.5f));
-
-		std::vector<glm::vec3> backFaceTan = CalculateVertexTangent(backFacePos, textures);
-
-		// Cara posterior
-		m_cubeVertices.push_back(Vertex(backFacePos.at(0), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(0), glm::vec3(0.0f, 0.0f, -1.0f), backFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(backFacePos.at(1), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(1), glm::vec3(0.0f, 0.0f, -1.0f), backFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(backFacePos.at(2), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(2), glm::vec3(0.0f, 0.0f, -1.0f), backFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(backFacePos.at(3), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(3), glm::vec3(0.0f, 0.0f, -1.0f), backFaceTan.at(1)));
-
-		// Calcular tangentes para la cara derecha
-		std::vector<glm::vec3> rightFacePos;
-		rightFacePos.push_back(glm::vec3(0.5f, -0.5f, 0.5f));
-		rightFacePos.push_back(glm::vec3(0.5f, -0.5f, -0.5f));
-		rightFacePos.push_back(glm::vec3(0.5f, 0.5f, -0.5f));
-		rightFacePos.push_back(glm::vec3(0.5f, 0.5f, 0.5f));
-
-		std::vector<glm::vec3> rightFaceTan = CalculateVertexTangent(rightFacePos, textures);
-
-		// cara derecha
-		m_cubeVertices.push_back(Vertex(rightFacePos.at(0), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(0), glm::vec3(1.0f, 0.0f, 0.0f), rightFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(rightFacePos.at(1), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(1), glm::vec3(1.0f, 0.0f, 0.0f), rightFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(rightFacePos.at(2), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(2), glm::vec3(1.0f, 0.0f, 0.0f), rightFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(rightFacePos.at(3), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(3), glm::vec3(1.0f, 0.0f, 0.0f), rightFaceTan.at(1)));
-
-		// Calcular tangentes para la cara izquierda
-		std::vector<glm::vec3> leftFacePos;
-		leftFacePos.push_back(glm::vec3(-0.5f, -0.5f, -0.5f));
-		leftFacePos.push_back(glm::vec3(-0.5f, -0.5f, 0.5f));
-		leftFacePos.push_back(glm::vec3(-0.5f, 0.5f, 0.5f));
-		leftFacePos.push_back(glm::vec3(-0.5f, 0.5f, -0.5f));
-
-		std::vector<glm::vec3> leftFaceTan = CalculateVertexTangent(leftFacePos, textures);
-
-		// cara izquierda
-		m_cubeVertices.push_back(Vertex(leftFacePos.at(0), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(0), glm::vec3(-1.0f, 0.0f, 0.0f), leftFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(leftFacePos.at(1), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(1), glm::vec3(-1.0f, 0.0f, 0.0f), leftFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(leftFacePos.at(2), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(2), glm::vec3(-1.0f, 0.0f, 0.0f), leftFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(leftFacePos.at(3), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(3), glm::vec3(-1.0f, 0.0f, 0.0f), leftFaceTan.at(1)));
-
-		// Calcular tangentes para la cara superior
-		std::vector<glm::vec3> topFacePos;
-		topFacePos.push_back(glm::vec3(-0.5f, 0.5f, 0.5f));
-		topFacePos.push_back(glm::vec3(0.5f, 0.5f, 0.5f));
-		topFacePos.push_back(glm::vec3(0.5f, 0.5f, -0.5f));
-		topFacePos.push_back(glm::vec3(-0.5f, 0.5f, -0.5f));
-
-		std::vector<glm::vec3> topFaceTan = CalculateVertexTangent(topFacePos, textures);
-
-		// cara superior
-		m_cubeVertices.push_back(Vertex(topFacePos.at(0), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(0), glm::vec3(0.0f, 1.0f, 0.0f), topFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(topFacePos.at(1), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(1), glm::vec3(0.0f, 1.0f, 0.0f), topFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(topFacePos.at(2), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(2), glm::vec3(0.0f, 1.0f, 0.0f), topFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(topFacePos.at(3), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(3), glm::vec3(0.0f, 1.0f, 0.0f), topFaceTan.at(1)));
-
-		// Calcular tangentes para la cara inferior
-		std::vector<glm::vec3> bottomFacePos;
-		bottomFacePos.push_back(glm::vec3(0.5f, -0.5f, 0.5f));
-		bottomFacePos.push_back(glm::vec3(-0.5f, -0.5f, 0.5f));
-		bottomFacePos.push_back(glm::vec3(-0.5f, -0.5f, -0.5f));
-		bottomFacePos.push_back(glm::vec3(0.5f, -0.5f, -0.5f));
-
-		std::vector<glm::vec3> bottomFaceTan = CalculateVertexTangent(bottomFacePos, textures);
-
-		// Cara inferior
-		m_cubeVertices.push_back(Vertex(bottomFacePos.at(0), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(0), glm::vec3(0.0f, -1.0f, 0.0f), bottomFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(bottomFacePos.at(1), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(1), glm::vec3(0.0f, -1.0f, 0.0f), bottomFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(bottomFacePos.at(2), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(2), glm::vec3(0.0f, -1.0f, 0.0f), bottomFaceTan.at(0)));
-		m_cubeVertices.push_back(Vertex(bottomFacePos.at(3), glm::vec3(1.0f, 0.0f, 0.0f), textures.at(3), glm::vec3(0.0f, -1.0f, 0.0f), bottomFaceTan.at(1)));
-	}
+	GLint location = GetUniformLocation(name);
 
-	virtual std::vector<Vertex> GetVertexData() override
+	if (location >= 0)
 	{
-		return m_cubeVertices;
+		glUniform3fv(location, 1, glm::value_ptr(value));
+		GLState::GetInstance().CountUniformUpload();
 	}
+}
 
-	virtual unsigned int GetVertexDataCount() override
-	{
-		return m_cubeVertices.size();
-	}
+void Shader::SetVec4(UniformName name, const glm::vec4& value) const
+{
+	GLint location = GetUniformLocation(name);
 
-	virtual unsigned int* GetIndexData() override
+	if (location >= 0)
 	{
-		return m_cubeIndices;
+		glUniform4fv(location, 1, glm::value_ptr(value));
+		GLState::GetInstance().CountUniformUpload();
 	}
+}
+
+// Arreglo de vec4 (p. ej. "frustumPlanes[6]"): se sube entero desde la posición del primer elemento
+void Shader::SetVec4Array(UniformName name, const glm::vec4* values, GLsizei count) const
+{
+	GLint location = GetUniformLocation(name);
 
-	virtual unsigned int GetIndexDataCount() override
+	if (location >= 0)
 	{
-		return (sizeof(m_cubeIndices) / sizeof(m_cubeIndices[0]));
+		glUniform4fv(location, count, glm::value_ptr(values[0]));
+		GLState::GetInstance().CountUniformUpload();
 	}
+}
+
+void Shader::SetMat4(UniformName name, const glm::mat4& value) const
+{
+	GLint location = GetUniformLocation(name);
 
-private:
-	std::vector<Vertex> m_cubeVertices;
-	unsigned int m_cubeIndices[36] =
+	if (location >= 0)
 	{
-		0, 1, 2,
-		2, 3, 0,
+		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+		GLState::GetInstance().CountUniformUpload();
+	}
+}
 
-		4, 5, 6,
-		6, 7, 4,
+// -------------------
+// Descripción: Función que lee y compila un sombreador; devuelve 0 si falla
+// -------------------
+GLuint Shader::CompileShader(const char* file, GLenum type)
+{
+	std::ifstream stream(file);
 
-		8, 9, 10,
-		10, 11, 8,
+	if (!stream.is_open())
+	{
+		printf("ERROR: Unable to open shader file: %s\n", file);
+		return 0;
+	}
 
-		12, 13, 14,
-		14, 15, 12,
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+	std::string source = buffer.str();
+	const char* sourcePtr = source.c_str();
 
-		16, 17, 18,
-		18, 19, 16,
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &sourcePtr, nullptr);
+	glCompileShader(shader);
 
-		20, 21, 22,
-		22, 23, 20
-	};
-};
+	GLint success;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
 
-class Sphere : public Shape
-{
-	virtual void InitVertexData() override
+	if (!success)
 	{
-		float phyStep = m_PI / (float)m_stacks;
-		float thetaStep = 2.0f * m_PI / (float)m_slices;
+		char infoLog[1024];
+		glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+		printf("ERROR: Shader compilation failed (%s)\n%s\n", file, infoLog);
+		glDeleteShader(shader);
+		return 0;
+	}
 
-		for (int i = 0; i <= m_stacks; ++i)
-		{
-			float phi = i * phyStep;
+	return shader;
+}
 
-			for (int j = 0; j <= m_slices; ++j)
-			{
-				float theta = j * thetaStep;
+// -------------------
+// Descripción: Función que enlaza el programa, guarda las posiciones de sus uniformes y enlaza los bloques compartidos
+// -------------------
+GLuint Shader::LinkProgram(const GLuint* shaders, unsigned int count)
+{
+	m_program = glCreateProgram();
 
-				float x = cosf(theta) * sinf(phi);
-				float y = cosf(phi);
-				float z = sinf(theta) * sinf(phi);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (shaders[i] != 0)
+			glAttachShader(m_program, shaders[i]);
+	}
 
-				m_sphereVertices.push_back(Vertex(glm::vec3(x * m_radius, y * m_radius, z * m_radius), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec2(theta / (m_PI * 2.0f), phi / m_PI), glm::vec3(x, y, z)));
-			}
-		}
+	glLinkProgram(m_program);
 
-		for (int i = 0; i < m_slices * m_stacks + m_slices; ++i)
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (shaders[i] != 0)
 		{
-			m_sphereIndices.push_back(i);
-			m_sphereIndices.push_back(i + m_slices + 1);
-			m_sphereIndices.push_back(i + m_slices);
-
-			m_sphereIndices.push_back(i + m_slices + 1);
-			m_sphereIndices.push_back(i);
-			m_sphereIndices.push_back(i + 1);
+			glDetachShader(m_program, shaders[i]);
+			glDeleteShader(shaders[i]);
 		}
 	}
 
-	virtual unsigned int GetVertexDataCount() override
-	{
-		return m_sphereVertices.size();
-	}
+	GLint success;
+	glGetProgramiv(m_program, GL_LINK_STATUS, &success);
 
-	virtual std::vector<Vertex> GetVertexData() override
+	if (!success)
 	{
-		return m_sphereVertices;
+		char infoLog[1024];
+		glGetProgramInfoLog(m_program, sizeof(infoLog), nullptr, infoLog);
+		printf("ERROR: Shader program linking failed\n%s\n", infoLog);
+		return m_program;
 	}
 
-	virtual unsigned int* GetIndexData() override
-	{
-		return &m_sphereIndices[0];
-	}
+	CacheUniforms();
+	BindUniformBlocks();
+	return m_program;
+}
 
-	virtual unsigned int GetIndexDataCount() override
-	{
-		return m_sphereIndices.size();
-	}
+// -------------------
+// Descripción: Función que recorre los uniformes activos una sola vez. Los que están dentro de un bloque tienen posición -1
+// y no se guardan; los arreglos se guardan también sin el "[0]" final ("texture[0]" y "texture").
+// -------------------
+void Shader::CacheUniforms()
+{
+	m_uniforms.clear();
 
-private:
-	int m_stacks = 75;
-	int m_slices = 75;
-	int m_radius = 3;
-	const float m_PI = 3.14159265359f;
+	GLint count = 0, maxLength = 0;
+	glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
 
-	std::vector<Vertex> m_sphereVertices;
-	std::vector<unsigned int> m_sphereIndices;
-};
+	std::vector<char> name(std::max(maxLength, 1));
 
-Shape* Shape::CreateShape(unsigned int shapeID)
-{
-	switch (shapeID)
+	for (GLint i = 0; i < count; ++i)
 	{
-	case 0:
-		return new Triangle;
-		break;
+		GLint size;
+		GLenum type;
+		glGetActiveUniform(m_program, (GLuint)i, (GLsizei)name.size(), nullptr, &size, &type, name.data());
 
-	case 1:
-		return new Quad;
-		break;
+		GLint location = glGetUniformLocation(m_program, name.data());
 
-	case 2:
-		return new Cube;
-		break;
+		if (location < 0)
+			continue;
 
-	case 3:
-		return new Sphere;
-		break;
+		std::string uniform(name.data());
+		m_uniforms.push_back(std::make_pair(UniformName(uniform).GetHash(), location));
 
-	default:
-		break;
+		if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+			m_uniforms.push_back(std::make_pair(UniformName(uniform.substr(0, uniform.size() - 3)).GetHash(), location));
 	}
 
-	return nullptr;
-}
\ No newline at end of file
+	std::sort(m_uniforms.begin(), m_uniforms.end());
+
+	for (size_t i = 1; i < m_uniforms.size(); ++i)
+	{
+		if (m_uniforms[i].first == m_uniforms[i - 1].first && m_uniforms[i].second != m_uniforms[i - 1].second)
+			printf("ERROR: Two uniforms share the hash %08x, rename one of them\n", m_uniforms[i].first);
+	}
+}
+
+void Shader::BindUniformBlocks()
+{
+	GLuint camera = glGetUniformBlockIndex(m_program, "CameraBlock");
+	GLuint lights = glGetUniformBlockIndex(m_program, "LightBlock");
+
+	if (camera != GL_INVALID_INDEX)
+		glUniformBlockBinding(m_program, camera, SceneUniforms::CAMERA_BINDING);
+
+	if (lights != GL_INVALID_INDEX)
+		glUniformBlockBinding(m_program, lights, SceneUniforms::LIGHT_BINDING);
+}
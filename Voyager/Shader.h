@@ -1,20 +1,75 @@
 #pragma once
-#ifndef __SHAPE_H__
-#define __SHAPE_H__
+#ifndef __SHADER_H__
+#define __SHADER_H__
 
-#include "Vertices.h"
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "Dependencies/glm-0.9.9-a2/glm/gtc/matrix_transform.hpp"
+#include "Dependencies/glm-0.9.9-a2/glm/gtc/type_ptr.hpp"
+#include "GLState.h"
+#include <cstdint>
+#include <string>
+#include <utility>
 #include <vector>
 
-class Shape
+// Nombre de un uniforme reducido a su hash FNV-1a. Con un literal el hash se puede calcular al compilar,
+// así SetMat4("view", ...) no recorre ni compara cadenas en cada cuadro.
+class UniformName
 {
 public:
-	static Shape* CreateShape(unsigned int shapeID);
+	constexpr UniformName(const char* name) : m_hash(Hash(name, 2166136261u)) {}
+	UniformName(const std::string& name) : m_hash(Hash(name.c_str(), 2166136261u)) {}
 
-	virtual std::vector<Vertex> GetVertexData() = 0;
-	virtual unsigned int GetVertexDataCount() = 0;
-	virtual unsigned int* GetIndexData() = 0;
-	virtual unsigned int GetIndexDataCount() = 0;
-	virtual void InitVertexData() = 0;
+	constexpr uint32_t GetHash() const { return m_hash; }
+
+	static constexpr uint32_t Hash(const char* name, uint32_t hash)
+	{
+		return *name ? Hash(name + 1, (hash ^ (uint8_t)*name) * 16777619u) : hash;
+	}
+
+private:
+	uint32_t m_hash;
+};
+
+// Programa de sombreado. Al enlazar se leen todos los uniformes activos y se guardan sus posiciones ordenadas por hash,
+// y los bloques de uniformes compartidos (cámara y luces, ver SceneUniforms) se enlazan a sus puntos fijos.
+// Los Set* de un uniforme que el programa no usa no llegan a llamar a OpenGL; los demás se cuentan en GLState.
+class Shader
+{
+public:
+	Shader();
+	~Shader();
+
+	GLuint CreateProgram(const char* vertexShaderFile, const char* fragmentShaderFile);
+	GLuint CreateProgram(const char* vertexShaderFile, const char* geometryShaderFile, const char* fragmentShaderFile);
+	GLuint CreateComputeProgram(const char* computeShaderFile);
+	void DestroyProgram();
+
+	void ActivateProgram() { GLState::GetInstance().UseProgram(m_program); }
+	void DeactivateProgram() { GLState::GetInstance().UseProgram(0); }
+	GLuint GetShaderProgram() { return m_program; }
+
+	GLint GetUniformLocation(UniformName name) const;
+	bool HasUniform(UniformName name) const { return GetUniformLocation(name) >= 0; }
+
+	void SetBool(UniformName name, bool value) const;
+	void SetInt(UniformName name, int value) const;
+	void SetFloat(UniformName name, float value) const;
+	void SetVec2(UniformName name, const glm::vec2& value) const;
+	void SetVec3(UniformName name, const glm::vec3& value) const;
+	void SetVec4(UniformName name, const glm::vec4& value) const;
+	void SetVec4Array(UniformName name, const glm::vec4* values, GLsizei count) const;
+	void SetMat4(UniformName name, const glm::mat4& value) const;
+
+private:
+	GLuint m_program;
+	std::vector<std::pair<uint32_t, GLint> > m_uniforms;
+
+	// Private functions
+	GLuint CompileShader(const char* file, GLenum type);
+	GLuint LinkProgram(const GLuint* shaders, unsigned int count);
+	void CacheUniforms();
+	void BindUniformBlocks();
 };
 
-#endif // !__SHAPE_H__
\ No newline at end of file
+#endif // !__SHADER_H__
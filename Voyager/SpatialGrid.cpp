@@ -0,0 +1,320 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+SpatialGrid::SpatialGrid() :
+	m_minX(0.0f),
+	m_minZ(0.0f),
+	m_maxX(0.0f),
+	m_maxZ(0.0f),
+	m_cellSize(1.0f),
+	m_invCellSize(1.0f),
+	m_cellsX(1),
+	m_cellsZ(1)
+{}
+
+SpatialGrid::~SpatialGrid()
+{}
+
+// -------------------
+// Descripción: Función que define el área cubierta por la rejilla y el tamaño de cada celda
+// -------------------
+void SpatialGrid::Init(float minX, float minZ, float maxX, float maxZ, float cellSize)
+{
+	m_minX = minX;
+	m_minZ = minZ;
+	m_maxX = maxX;
+	m_maxZ = maxZ;
+	m_cellSize = cellSize;
+	m_invCellSize = 1.0f / cellSize;
+	m_cellsX = std::max(1, (int)std::ceil((maxX - minX) * m_invCellSize));
+	m_cellsZ = std::max(1, (int)std::ceil((maxZ - minZ) * m_invCellSize));
+
+	m_cellStart.assign(m_cellsX * m_cellsZ + 1, 0);
+	m_cellItems.clear();
+	m_items.clear();
+}
+
+void SpatialGrid::Clear()
+{
+	m_items.clear();
+}
+
+// -------------------
+// Descripción: Función que añade una esfera a la rejilla. Las entidades fuera del área se guardan en las celdas del borde.
+// -------------------
+void SpatialGrid::Insert(unsigned int id, const glm::vec3& pos, float radius)
+{
+	Item item;
+	item.m_pos = pos;
+	item.m_radius = radius;
+	item.m_id = id;
+	item.m_minCellX = CellX(pos.x - radius);
+	item.m_minCellZ = CellZ(pos.z - radius);
+	item.m_maxCellX = CellX(pos.x + radius);
+	item.m_maxCellZ = CellZ(pos.z + radius);
+
+	m_items.push_back(item);
+}
+
+// -------------------
+// Descripción: Función que ordena las entidades por celda (ordenamiento por conteo, sin reservas de memoria tras el primer cuadro)
+// -------------------
+void SpatialGrid::Build()
+{
+	// Sin Init no hay celdas donde repartir las entidades
+	if (m_cellStart.empty())
+	{
+		m_cellItems.clear();
+		return;
+	}
+
+	std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+
+	// Contar cuántas entidades toca cada celda
+	for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
+	{
+		for (int z = (*iter).m_minCellZ; z <= (*iter).m_maxCellZ; ++z)
+			for (int x = (*iter).m_minCellX; x <= (*iter).m_maxCellX; ++x)
+				++m_cellStart[z * m_cellsX + x + 1];
+	}
+
+	for (size_t i = 1; i < m_cellStart.size(); ++i)
+		m_cellStart[i] += m_cellStart[i - 1];
+
+	m_cellItems.resize(m_cellStart.back());
+
+	// Rellenar usando el inicio de cada celda como cursor; al terminar, cada cursor apunta al inicio de la celda siguiente
+	for (unsigned int i = 0; i < m_items.size(); ++i)
+	{
+		const Item& item = m_items[i];
+
+		for (int z = item.m_minCellZ; z <= item.m_maxCellZ; ++z)
+			for (int x = item.m_minCellX; x <= item.m_maxCellX; ++x)
+				m_cellItems[m_cellStart[z * m_cellsX + x]++] = i;
+	}
+
+	for (size_t i = m_cellStart.size() - 1; i > 0; --i)
+		m_cellStart[i] = m_cellStart[i - 1];
+
+	m_cellStart[0] = 0;
+}
+
+// -------------------
+// Descripción: Función que devuelve los ids de las esferas que se solapan con la esfera de consulta
+// -------------------
+void SpatialGrid::QueryRadius(const glm::vec3& center, float radius, std::vector<unsigned int>& results) const
+{
+	std::vector<SpatialHit> hits;
+	GatherCells(center, radius, true, hits);
+
+	results.clear();
+
+	for (auto iter = hits.begin(); iter != hits.end(); ++iter)
+		results.push_back((*iter).m_id);
+}
+
+// -------------------
+// Descripción: Función que devuelve las 'k' entidades más cercanas (por centro) ordenadas por distancia.
+// El radio de búsqueda se duplica hasta encontrar suficientes candidatos o cubrir toda la rejilla.
+// -------------------
+void SpatialGrid::QueryNearest(const glm::vec3& center, unsigned int k, float maxDistance, std::vector<SpatialHit>& results) const
+{
+	results.clear();
+
+	if (k == 0 || m_items.empty())
+		return;
+
+	float gridExtent = std::max(m_maxX - m_minX, m_maxZ - m_minZ);
+	float radius = std::min(m_cellSize, maxDistance);
+
+	while (true)
+	{
+		GatherCells(center, radius, false, results);
+
+		if (results.size() >= k || radius >= maxDistance || radius >= gridExtent)
+			break;
+
+		radius = std::min(radius * 2.0f, maxDistance);
+	}
+
+	size_t count = std::min<size_t>(k, results.size());
+	std::partial_sort(results.begin(), results.begin() + count, results.end());
+	results.resize(count);
+}
+
+// -------------------
+// Descripción: Función que recorre las celdas atravesadas por el rayo (DDA sobre el plano XZ) y devuelve la esfera más cercana.
+// La búsqueda termina en cuanto el impacto más cercano queda dentro de la celda actual.
+// -------------------
+bool SpatialGrid::Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, SpatialHit& hit,
+	const std::function<bool(unsigned int)>& accept) const
+{
+	if (m_cellStart.empty())
+		return false;
+
+	glm::vec3 rayDir = glm::normalize(dir);
+
+	// Recortar el rayo al área de la rejilla
+	float tEnter = 0.0f;
+	float tExit = maxDistance;
+	const float origins[2] = { origin.x, origin.z };
+	const float dirs[2] = { rayDir.x, rayDir.z };
+	const float mins[2] = { m_minX, m_minZ };
+	const float maxs[2] = { m_maxX, m_maxZ };
+
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		if (std::fabs(dirs[axis]) < 1e-8f)
+		{
+			if (origins[axis] < mins[axis] || origins[axis] > maxs[axis])
+				return false;
+
+			continue;
+		}
+
+		float t0 = (mins[axis] - origins[axis]) / dirs[axis];
+		float t1 = (maxs[axis] - origins[axis]) / dirs[axis];
+
+		if (t0 > t1)
+			std::swap(t0, t1);
+
+		tEnter = std::max(tEnter, t0);
+		tExit = std::min(tExit, t1);
+	}
+
+	if (tEnter > tExit)
+		return false;
+
+	glm::vec3 start = origin + rayDir * tEnter;
+	int cellX = CellX(start.x);
+	int cellZ = CellZ(start.z);
+	int stepX = rayDir.x > 0.0f ? 1 : -1;
+	int stepZ = rayDir.z > 0.0f ? 1 : -1;
+
+	float tMaxX = FLT_MAX, tMaxZ = FLT_MAX, tDeltaX = FLT_MAX, tDeltaZ = FLT_MAX;
+
+	if (std::fabs(rayDir.x) >= 1e-8f)
+	{
+		float boundary = m_minX + (cellX + (stepX > 0 ? 1 : 0)) * m_cellSize;
+		tMaxX = (boundary - origin.x) / rayDir.x;
+		tDeltaX = m_cellSize / std::fabs(rayDir.x);
+	}
+
+	if (std::fabs(rayDir.z) >= 1e-8f)
+	{
+		float boundary = m_minZ + (cellZ + (stepZ > 0 ? 1 : 0)) * m_cellSize;
+		tMaxZ = (boundary - origin.z) / rayDir.z;
+		tDeltaZ = m_cellSize / std::fabs(rayDir.z);
+	}
+
+	hit.m_distance = FLT_MAX;
+
+	while (true)
+	{
+		unsigned int cell = cellZ * m_cellsX + cellX;
+
+		for (unsigned int i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+		{
+			const Item& item = m_items[m_cellItems[i]];
+
+			// Intersección rayo-esfera (dirección normalizada)
+			glm::vec3 oc = origin - item.m_pos;
+			float b = glm::dot(oc, rayDir);
+			float c = glm::dot(oc, oc) - item.m_radius * item.m_radius;
+
+			if (c > 0.0f && b > 0.0f)
+				continue;
+
+			float discriminant = b * b - c;
+
+			if (discriminant < 0.0f)
+				continue;
+
+			float t = std::max(0.0f, -b - std::sqrt(discriminant));
+
+			if (t <= maxDistance && t < hit.m_distance && (!accept || accept(item.m_id)))
+			{
+				hit.m_id = item.m_id;
+				hit.m_distance = t;
+			}
+		}
+
+		float cellExit = std::min(tMaxX, tMaxZ);
+
+		if (hit.m_distance <= cellExit || cellExit > tExit)
+			break;
+
+		if (tMaxX < tMaxZ)
+		{
+			cellX += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			cellZ += stepZ;
+			tMaxZ += tDeltaZ;
+		}
+
+		if (cellX < 0 || cellX >= m_cellsX || cellZ < 0 || cellZ >= m_cellsZ)
+			break;
+	}
+
+	return hit.m_distance != FLT_MAX;
+}
+
+int SpatialGrid::CellX(float x) const
+{
+	return std::min(std::max((int)std::floor((x - m_minX) * m_invCellSize), 0), m_cellsX - 1);
+}
+
+int SpatialGrid::CellZ(float z) const
+{
+	return std::min(std::max((int)std::floor((z - m_minZ) * m_invCellSize), 0), m_cellsZ - 1);
+}
+
+// -------------------
+// Descripción: Función que recoge las entidades de las celdas que toca la esfera de consulta.
+// Una entidad que ocupa varias celdas solo se reporta en la primera celda compartida con la consulta, así no hay duplicados.
+// -------------------
+void SpatialGrid::GatherCells(const glm::vec3& center, float radius, bool includeItemRadius, std::vector<SpatialHit>& results) const
+{
+	results.clear();
+
+	if (m_cellStart.empty())
+		return;
+
+	int minX = CellX(center.x - radius);
+	int minZ = CellZ(center.z - radius);
+	int maxX = CellX(center.x + radius);
+	int maxZ = CellZ(center.z + radius);
+
+	for (int z = minZ; z <= maxZ; ++z)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			unsigned int cell = z * m_cellsX + x;
+
+			for (unsigned int i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+			{
+				const Item& item = m_items[m_cellItems[i]];
+
+				if (x != std::max(item.m_minCellX, minX) || z != std::max(item.m_minCellZ, minZ))
+					continue;
+
+				glm::vec3 diff = item.m_pos - center;
+				float distanceSquared = glm::dot(diff, diff);
+				float reach = includeItemRadius ? radius + item.m_radius : radius;
+
+				if (distanceSquared <= reach * reach)
+				{
+					SpatialHit hit;
+					hit.m_id = item.m_id;
+					hit.m_distance = std::sqrt(distanceSquared);
+					results.push_back(hit);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef __SPATIALGRID_H__
+#define __SPATIALGRID_H__
+
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <functional>
+#include <vector>
+
+struct SpatialHit
+{
+	unsigned int m_id;
+	float m_distance;
+
+	bool operator<(const SpatialHit& other) const { return m_distance < other.m_distance; }
+};
+
+// Rejilla uniforme sobre el plano XZ del terreno. Cada cuadro se vacía, se insertan las esferas
+// (enemigos, drones, proyectiles) y se ordenan por celda, de modo que las consultas solo recorren
+// las celdas que tocan en vez de todas las entidades.
+class SpatialGrid
+{
+public:
+	SpatialGrid();
+	~SpatialGrid();
+
+	void Init(float minX, float minZ, float maxX, float maxZ, float cellSize);
+
+	void Clear();
+	void Insert(unsigned int id, const glm::vec3& pos, float radius);
+	void Build();
+
+	void QueryRadius(const glm::vec3& center, float radius, std::vector<unsigned int>& results) const;
+	void QueryNearest(const glm::vec3& center, unsigned int k, float maxDistance, std::vector<SpatialHit>& results) const;
+	bool Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, SpatialHit& hit,
+		const std::function<bool(unsigned int)>& accept = nullptr) const;
+
+	unsigned int GetCount() const { return (unsigned int)m_items.size(); }
+
+private:
+	struct Item
+	{
+		glm::vec3 m_pos;
+		float m_radius;
+		unsigned int m_id;
+		int m_minCellX, m_minCellZ, m_maxCellX, m_maxCellZ;
+	};
+
+	std::vector<Item> m_items;
+	std::vector<unsigned int> m_cellStart, m_cellItems;
+
+	float m_minX, m_minZ, m_maxX, m_maxZ, m_cellSize, m_invCellSize;
+	int m_cellsX, m_cellsZ;
+
+	// Private functions
+	int CellX(float x) const;
+	int CellZ(float z) const;
+	void GatherCells(const glm::vec3& center, float radius, bool includeItemRadius, std::vector<SpatialHit>& results) const;
+};
+
+#endif // !__SPATIALGRID_H__
@@ -0,0 +1,299 @@
+#include "StaticBatcher.h"
+#include "GLState.h"
+#include "Player.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+StaticBatcher::StaticBatcher() :
+	m_vao(0),
+	m_vbo(0),
+	m_ebo(0),
+	m_commandBuffer(0),
+	m_transformBuffer(0)
+{
+	std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+StaticBatcher::~StaticBatcher()
+{
+	Destroy();
+}
+
+bool StaticBatcher::IsSupported()
+{
+	return GLEW_VERSION_4_3 != 0;
+}
+
+void StaticBatcher::Init(const char* vs, const char* fs)
+{
+	if (!IsSupported())
+	{
+		printf("ERROR: Static batching needs OpenGL 4.3 (multi-draw indirect and shader storage buffers)\n");
+		return;
+	}
+
+	m_shader.CreateProgram(vs, fs);
+}
+
+// -------------------
+// Descripción: Función que apunta un dibujo por malla del modelo con la transformación dada. La geometría se copia ya
+// (el modelo puede desaparecer antes de Build) y las mallas se reconocen por dirección, así cien rocas que comparten
+// malla ocupan su geometría una sola vez.
+// -------------------
+void StaticBatcher::Add(Model& model, const glm::mat4& transform)
+{
+	if (m_vao != 0)
+	{
+		printf("ERROR: Static batch already built, objects must be added before Build\n");
+		return;
+	}
+
+	unsigned int transformIndex = (unsigned int)m_transforms.size();
+	m_transforms.push_back(transform);
+
+	for (GLuint i = 0; i < model.GetMeshes().size(); ++i)
+	{
+		const Mesh& mesh = model.GetMeshes()[i];
+
+		if (mesh.GetIndices().empty())
+			continue;
+
+		Entry entry;
+		entry.m_bucket = FindBucket(mesh.GetTextures());
+		entry.m_range = AddMeshRange(mesh);
+		entry.m_transform = transformIndex;
+		m_entries.push_back(entry);
+	}
+
+	++m_stats.m_objects;
+}
+
+// -------------------
+// Descripción: Función que sube todo a la GPU. Los dibujos se ordenan por grupo de material para que los comandos de
+// cada grupo queden seguidos; el dibujo i lleva baseInstance = i, que es también su fila en el SSBO de transformaciones.
+// Después se sueltan las copias de la CPU: lo estático ya no cambia.
+// -------------------
+void StaticBatcher::Build()
+{
+	if (m_vao != 0 || m_entries.empty() || m_shader.GetShaderProgram() == 0)
+		return;
+
+	std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) { return a.m_bucket < b.m_bucket; });
+
+	unsigned int draws = (unsigned int)m_entries.size();
+	std::vector<DrawElementsIndirectCommand> commands(draws);
+	std::vector<glm::mat4> transforms(draws);
+
+	for (unsigned int i = 0; i < draws; ++i)
+	{
+		const Entry& entry = m_entries[i];
+		const MeshRange& range = m_ranges[entry.m_range];
+
+		commands[i].m_count = range.m_count;
+		commands[i].m_instanceCount = 1;
+		commands[i].m_firstIndex = range.m_firstIndex;
+		commands[i].m_baseVertex = range.m_baseVertex;
+		commands[i].m_baseInstance = i;
+		transforms[i] = m_transforms[entry.m_transform];
+
+		Bucket& bucket = m_buckets[entry.m_bucket];
+
+		if (bucket.m_drawCount == 0)
+			bucket.m_offset = i * sizeof(DrawElementsIndirectCommand);
+
+		++bucket.m_drawCount;
+	}
+
+	GLState& state = GLState::GetInstance();
+
+	glGenVertexArrays(1, &m_vao);
+	glGenBuffers(1, &m_vbo);
+	glGenBuffers(1, &m_ebo);
+
+	state.BindVertexArray(m_vao);
+	state.BindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(MeshVertex) * m_vertices.size(), m_vertices.data(), GL_STATIC_DRAW);
+
+	state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * m_indices.size(), m_indices.data(), GL_STATIC_DRAW);
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, m_Normal));
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, m_TexCoords));
+
+	// Identificador de dibujo: un entero por "instancia"; con baseInstance = i cada comando lee el suyo
+	m_drawIds.Init(sizeof(GLuint), draws, GL_STATIC_DRAW);
+	m_drawIds.AddAttribute(DRAW_ID_ATTRIBUTE, 1, GL_UNSIGNED_INT, 0);
+
+	for (GLuint i = 0; i < draws; ++i)
+		m_drawIds.Add(&i);
+
+	m_drawIds.Upload();
+	m_drawIds.Attach(m_vao);
+	state.BindVertexArray(0);
+
+	glGenBuffers(1, &m_commandBuffer);
+	state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STATIC_DRAW);
+
+	glGenBuffers(1, &m_transformBuffer);
+	state.BindBuffer(GL_SHADER_STORAGE_BUFFER, m_transformBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, transforms.size() * sizeof(glm::mat4), transforms.data(), GL_STATIC_DRAW);
+
+	// Los samplers solo se vuelven a asociar cuando un grupo cambia los tipos de textura respecto al que se dibuja antes
+	const Bucket* previous = nullptr;
+
+	for (auto iter = m_buckets.begin(); iter != m_buckets.end(); ++iter)
+	{
+		if ((*iter).m_drawCount == 0)
+			continue;
+
+		(*iter).m_bindSamplers = previous == nullptr || !SameSamplerLayout(previous->m_textures, (*iter).m_textures);
+		previous = &(*iter);
+	}
+
+	m_stats.m_draws = draws;
+	m_stats.m_buckets = (unsigned int)m_buckets.size();
+	m_stats.m_vertices = (unsigned int)m_vertices.size();
+	m_stats.m_indices = (unsigned int)m_indices.size();
+
+	std::vector<MeshVertex>().swap(m_vertices);
+	std::vector<GLuint>().swap(m_indices);
+	std::vector<glm::mat4>().swap(m_transforms);
+	m_meshRanges.clear();
+}
+
+// -------------------
+// Descripción: Función que dibuja toda la geometría estática: un VAO, un búfer indirecto y un SSBO para todo, y por
+// cada grupo de material sus texturas (y sus samplers si cambian de orden) y una sola llamada de dibujo.
+// -------------------
+void StaticBatcher::Draw(Camera& cam, bool bUseSpotlight)
+{
+	if (m_vao == 0)
+		return;
+
+	GLState& state = GLState::GetInstance();
+
+	m_shader.ActivateProgram();
+	m_shader.SetVec3("lightPos", glm::vec3(cam.GetCameraPos().x, cam.GetCameraPos().y + 5.0f, cam.GetCameraPos().z));
+	m_shader.SetBool("EnableSpotlight", bUseSpotlight && Player::GetInstance().GetSpotLight() != nullptr);
+
+	state.BindVertexArray(m_vao);
+	state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, TRANSFORM_BINDING, m_transformBuffer);
+
+	for (auto iter = m_buckets.begin(); iter != m_buckets.end(); ++iter)
+	{
+		const Bucket& bucket = *iter;
+
+		if (bucket.m_drawCount == 0)
+			continue;
+
+		if (bucket.m_bindSamplers)
+			Mesh::BindSamplers(m_shader, bucket.m_textures);
+
+		for (unsigned int i = 0; i < bucket.m_textures.size(); ++i)
+			state.BindTextureUnit(i, bucket.m_textures[i].m_id);
+
+		state.MultiDrawElementsIndirect(GL_TRIANGLES, bucket.m_offset, bucket.m_drawCount);
+	}
+}
+
+void StaticBatcher::Destroy()
+{
+	GLState& state = GLState::GetInstance();
+
+	if (m_vao != 0)
+		state.DeleteVertexArrays(1, &m_vao);
+
+	GLuint buffers[] = { m_vbo, m_ebo, m_commandBuffer, m_transformBuffer };
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		if (buffers[i] != 0)
+			state.DeleteBuffers(1, &buffers[i]);
+	}
+
+	m_drawIds.Destroy();
+	m_vao = m_vbo = m_ebo = m_commandBuffer = m_transformBuffer = 0;
+
+	m_vertices.clear();
+	m_indices.clear();
+	m_meshRanges.clear();
+	m_ranges.clear();
+	m_buckets.clear();
+	m_entries.clear();
+	m_transforms.clear();
+	std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+// Un grupo por combinación de texturas (mismo orden y mismos tipos); las mallas sin textura comparten el suyo
+unsigned int StaticBatcher::FindBucket(const std::vector<MeshTexture>& textures)
+{
+	for (unsigned int b = 0; b < m_buckets.size(); ++b)
+	{
+		const std::vector<MeshTexture>& other = m_buckets[b].m_textures;
+
+		if (other.size() != textures.size())
+			continue;
+
+		bool same = true;
+
+		for (unsigned int i = 0; i < textures.size() && same; ++i)
+			same = other[i].m_id == textures[i].m_id && other[i].m_type == textures[i].m_type;
+
+		if (same)
+			return b;
+	}
+
+	Bucket bucket;
+	bucket.m_textures = textures;
+	bucket.m_offset = 0;
+	bucket.m_drawCount = 0;
+	bucket.m_bindSamplers = true;
+	m_buckets.push_back(bucket);
+	return (unsigned int)m_buckets.size() - 1;
+}
+
+// Dos grupos comparten samplers si sus texturas tienen los mismos tipos en el mismo orden (BindSamplers numera por tipo)
+bool StaticBatcher::SameSamplerLayout(const std::vector<MeshTexture>& a, const std::vector<MeshTexture>& b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (unsigned int i = 0; i < a.size(); ++i)
+	{
+		if (a[i].m_type != b[i].m_type)
+			return false;
+	}
+
+	return true;
+}
+
+// Copia la malla al final de los búferes compartidos (una sola vez por malla); los índices se quedan locales a la
+// malla y el comando los desplaza con baseVertex
+unsigned int StaticBatcher::AddMeshRange(const Mesh& mesh)
+{
+	auto found = m_meshRanges.find(&mesh);
+
+	if (found != m_meshRanges.end())
+		return found->second;
+
+	MeshRange range;
+	range.m_firstIndex = (GLuint)m_indices.size();
+	range.m_count = (GLuint)mesh.GetIndices().size();
+	range.m_baseVertex = (GLint)m_vertices.size();
+
+	m_vertices.insert(m_vertices.end(), mesh.GetVertices().begin(), mesh.GetVertices().end());
+	m_indices.insert(m_indices.end(), mesh.GetIndices().begin(), mesh.GetIndices().end());
+
+	m_ranges.push_back(range);
+	m_meshRanges[&mesh] = (unsigned int)m_ranges.size() - 1;
+	return (unsigned int)m_ranges.size() - 1;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#ifndef __STATICBATCHER_H__
+#define __STATICBATCHER_H__
+
+#include "Dependencies/glew/include/GL/glew.h"
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include "Camera.h"
+#include "GpuCuller.h"
+#include "InstanceBuffer.h"
+#include "Mesh.h"
+#include "Model.h"
+#include "Shader.h"
+#include <map>
+#include <vector>
+
+// Agrupación de la geometría estática (rocas, accesorios) que comparte sombreador. Al cargar el nivel se añaden los
+// modelos con su transformación; Build copia todas sus mallas a un único VBO/EBO (el formato es siempre MeshVertex),
+// escribe un comando indirecto por malla y objeto y sube las transformaciones a un SSBO. Las mallas con las mismas
+// texturas forman un grupo de material cuyos comandos quedan seguidos, y cada grupo se dibuja con un solo
+// glMultiDrawElementsIndirect. El vértice encuentra su transformación con un atributo por instancia que devuelve el
+// baseInstance del comando, así basta OpenGL 4.3 (sin gl_DrawID ni gl_BaseInstance).
+class StaticBatcher
+{
+public:
+	enum { DRAW_ID_ATTRIBUTE = 3 };
+	enum { TRANSFORM_BINDING = 0 };
+
+	struct Stats
+	{
+		unsigned int m_objects, m_draws, m_buckets;
+		unsigned int m_vertices, m_indices;
+	};
+
+	StaticBatcher();
+	~StaticBatcher();
+
+	StaticBatcher(StaticBatcher const&) = delete;
+	void operator=(StaticBatcher const&) = delete;
+
+	static bool IsSupported();
+
+	void Init(const char* vs, const char* fs);
+
+	// Solo antes de Build. La geometría se copia al añadir; una malla que ya estaba se reutiliza sin duplicarla
+	void Add(Model& model, const glm::mat4& transform);
+	void Add(Model& model) { Add(model, model.GetModelMatrix()); }
+	void Build();
+	void Draw(Camera& cam, bool bUseSpotlight = false);
+	void Destroy();
+
+	Shader& GetShaderProgram() { return m_shader; }
+	const Stats& GetStats() const { return m_stats; }
+
+private:
+	// Sitio de una malla dentro del VBO/EBO compartido
+	struct MeshRange
+	{
+		GLuint m_firstIndex, m_count;
+		GLint m_baseVertex;
+	};
+
+	// Grupo de material: texturas que se enlazan una vez y rango de sus comandos en el búfer indirecto. Si sus tipos de
+	// textura no siguen el orden del grupo anterior hay que volver a asociar los samplers antes de dibujarlo
+	struct Bucket
+	{
+		std::vector<MeshTexture> m_textures;
+		GLintptr m_offset;
+		GLsizei m_drawCount;
+		bool m_bindSamplers;
+	};
+
+	// Dibujo pendiente de Build: qué malla, con qué material y con qué transformación
+	struct Entry
+	{
+		unsigned int m_bucket, m_range, m_transform;
+	};
+
+	Shader m_shader;
+	GLuint m_vao, m_vbo, m_ebo;
+	GLuint m_commandBuffer, m_transformBuffer;
+	InstanceBuffer m_drawIds;
+
+	std::vector<MeshVertex> m_vertices;
+	std::vector<GLuint> m_indices;
+	std::map<const Mesh*, unsigned int> m_meshRanges;
+	std::vector<MeshRange> m_ranges;
+	std::vector<Bucket> m_buckets;
+	std::vector<Entry> m_entries;
+	std::vector<glm::mat4> m_transforms;
+	Stats m_stats;
+
+	// Private functions
+	unsigned int FindBucket(const std::vector<MeshTexture>& textures);
+	static bool SameSamplerLayout(const std::vector<MeshTexture>& a, const std::vector<MeshTexture>& b);
+	unsigned int AddMeshRange(const Mesh& mesh);
+};
+
+#endif // !__STATICBATCHER_H__
\ No newline at end of file
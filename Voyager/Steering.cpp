@@ -0,0 +1,316 @@
+#include "Steering.h"
+#include <algorithm>
+#include <cmath>
+
+// El núcleo AVX2 se compila aparte del resto de la unidad (atributo target en GCC/Clang; MSVC admite los intrínsecos
+// sin /arch) y solo se llama si la CPU y el sistema lo soportan. Así el archivo entero, y cualquier función en línea
+// que instancie, sigue siendo SSE2 y no puede colarse código AVX2 en otros archivos a través del enlazador.
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define STEERING_AVX2_TARGET
+#else
+#include <cpuid.h>
+#define STEERING_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#define STEERING_AVX2 1
+#else
+#define STEERING_AVX2 0
+#endif
+
+#if STEERING_AVX2
+// Lee las hojas de CPUID y XCR0: AVX2 y FMA en la CPU, y los registros YMM guardados por el sistema operativo
+static bool DetectAVX2()
+{
+	unsigned int regs[4] = { 0, 0, 0, 0 };
+	unsigned long long xcr0 = 0;
+
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+
+	if (info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	regs[2] = (unsigned int)info[2];
+#else
+	if (__get_cpuid_max(0, nullptr) < 7)
+		return false;
+
+	__cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+	bool fma = (regs[2] & (1u << 12)) != 0;
+	bool osxsave = (regs[2] & (1u << 27)) != 0;
+	bool avx = (regs[2] & (1u << 28)) != 0;
+
+	if (!fma || !osxsave || !avx)
+		return false;
+
+#if defined(_MSC_VER)
+	xcr0 = _xgetbv(0);
+	__cpuidex(info, 7, 0);
+	regs[1] = (unsigned int)info[1];
+#else
+	unsigned int low, high;
+	__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	xcr0 = ((unsigned long long)high << 32) | low;
+	__cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+	return (xcr0 & 6) == 6 && (regs[1] & (1u << 5)) != 0;
+}
+
+static bool HasAVX2()
+{
+	static const bool supported = DetectAVX2();
+	return supported;
+}
+
+// -------------------
+// Descripción: Núcleo AVX2 de ComputeForces: procesa los agentes de 8 en 8 y devuelve el primer índice que queda
+// para la versión escalar
+// -------------------
+STEERING_AVX2_TARGET
+static unsigned int ComputeForcesAVX2(const SteeringAgents& agents, const SteeringParams& params, unsigned int begin, unsigned int end,
+	const unsigned int* neighbourCount, const unsigned int* neighbours, unsigned int maximumNeighbours,
+	float* forceX, float* forceY, float* forceZ)
+{
+	unsigned int i = begin;
+
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 epsilon = _mm256_set1_ps(1e-6f);
+	const __m256 maximumSpeed = _mm256_set1_ps(params.m_maximumSpeed);
+	const __m256 maximumForceSquared = _mm256_set1_ps(params.m_maximumForce * params.m_maximumForce);
+	const __m256 maximumForce = _mm256_set1_ps(params.m_maximumForce);
+	const __m256 seekWeight = _mm256_set1_ps(params.m_seekWeight);
+	const __m256 fleeWeight = _mm256_set1_ps(-params.m_fleeWeight);
+	const __m256 fleeRadiusSquared = _mm256_set1_ps(params.m_fleeRadius * params.m_fleeRadius);
+	const __m256 inverseArrivalRadius = _mm256_set1_ps(params.m_arrivalRadius > 0.0f ? 1.0f / params.m_arrivalRadius : 0.0f);
+	const __m256 separationWeight = _mm256_set1_ps(params.m_separationWeight);
+	const __m256 separationRadiusSquared = _mm256_set1_ps(params.m_separationRadius * params.m_separationRadius);
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	for (; i + 8 <= end; i += 8)
+	{
+		__m256 px = _mm256_loadu_ps(agents.m_posX + i);
+		__m256 py = _mm256_loadu_ps(agents.m_posY + i);
+		__m256 pz = _mm256_loadu_ps(agents.m_posZ + i);
+
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(agents.m_targetX + i), px);
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(agents.m_targetY + i), py);
+		__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(agents.m_targetZ + i), pz);
+
+		__m256 distanceSquared = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+		__m256 distance = _mm256_sqrt_ps(distanceSquared);
+		__m256 inverseDistance = _mm256_blendv_ps(zero, _mm256_div_ps(one, distance), _mm256_cmp_ps(distance, epsilon, _CMP_GT_OQ));
+
+		// Llegada: la velocidad deseada baja linealmente dentro del radio de llegada (solo al buscar)
+		__m256 fleeing = _mm256_cmp_ps(distanceSquared, fleeRadiusSquared, _CMP_LT_OQ);
+		__m256 speed = maximumSpeed;
+
+		if (params.m_arrivalRadius > 0.0f)
+			speed = _mm256_min_ps(maximumSpeed, _mm256_mul_ps(maximumSpeed, _mm256_mul_ps(distance, inverseArrivalRadius)));
+
+		speed = _mm256_blendv_ps(speed, maximumSpeed, fleeing);
+
+		// Huir es buscar con la dirección invertida
+		__m256 weight = _mm256_blendv_ps(seekWeight, fleeWeight, fleeing);
+		__m256 scale = _mm256_mul_ps(_mm256_mul_ps(inverseDistance, speed), weight);
+
+		__m256 absWeight = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), weight);
+		__m256 fx = _mm256_sub_ps(_mm256_mul_ps(dx, scale), _mm256_mul_ps(_mm256_loadu_ps(agents.m_velX + i), absWeight));
+		__m256 fy = _mm256_sub_ps(_mm256_mul_ps(dy, scale), _mm256_mul_ps(_mm256_loadu_ps(agents.m_velY + i), absWeight));
+		__m256 fz = _mm256_sub_ps(_mm256_mul_ps(dz, scale), _mm256_mul_ps(_mm256_loadu_ps(agents.m_velZ + i), absWeight));
+
+		// Separación: cada carril recorre su propia lista de vecinos; los carriles con menos vecinos quedan enmascarados
+		if (neighbourCount && params.m_separationWeight > 0.0f)
+		{
+			alignas(32) int count[8];
+			int maximumCount = 0;
+
+			for (int lane = 0; lane < 8; ++lane)
+			{
+				count[lane] = (int)neighbourCount[i + lane];
+				if (count[lane] > maximumCount)
+					maximumCount = count[lane];
+			}
+
+			__m256i counts = _mm256_load_si256((const __m256i*)count);
+			__m256 sx = zero, sy = zero, sz = zero;
+
+			for (int k = 0; k < maximumCount; ++k)
+			{
+				alignas(32) int index[8];
+
+				for (int lane = 0; lane < 8; ++lane)
+					index[lane] = k < count[lane] ? (int)neighbours[(i + lane) * maximumNeighbours + k] : (int)(i + lane);
+
+				__m256i indices = _mm256_load_si256((const __m256i*)index);
+				__m256 active = _mm256_castsi256_ps(_mm256_cmpgt_epi32(counts, _mm256_set1_epi32(k)));
+
+				__m256 ox = _mm256_sub_ps(px, _mm256_i32gather_ps(agents.m_posX, indices, 4));
+				__m256 oy = _mm256_sub_ps(py, _mm256_i32gather_ps(agents.m_posY, indices, 4));
+				__m256 oz = _mm256_sub_ps(pz, _mm256_i32gather_ps(agents.m_posZ, indices, 4));
+
+				__m256 offsetSquared = _mm256_fmadd_ps(ox, ox, _mm256_fmadd_ps(oy, oy, _mm256_mul_ps(oz, oz)));
+				__m256 inside = _mm256_and_ps(active, _mm256_and_ps(_mm256_cmp_ps(offsetSquared, separationRadiusSquared, _CMP_LT_OQ),
+					_mm256_cmp_ps(offsetSquared, epsilon, _CMP_GT_OQ)));
+
+				// Empuje inversamente proporcional a la distancia (offset / distancia^2)
+				__m256 push = _mm256_and_ps(inside, _mm256_div_ps(one, _mm256_max_ps(offsetSquared, epsilon)));
+
+				sx = _mm256_fmadd_ps(ox, push, sx);
+				sy = _mm256_fmadd_ps(oy, push, sy);
+				sz = _mm256_fmadd_ps(oz, push, sz);
+			}
+
+			__m256 separationScale = _mm256_mul_ps(separationWeight, maximumSpeed);
+			fx = _mm256_fmadd_ps(sx, separationScale, fx);
+			fy = _mm256_fmadd_ps(sy, separationScale, fy);
+			fz = _mm256_fmadd_ps(sz, separationScale, fz);
+		}
+
+		// Limitar la magnitud de la fuerza
+		__m256 forceSquared = _mm256_fmadd_ps(fx, fx, _mm256_fmadd_ps(fy, fy, _mm256_mul_ps(fz, fz)));
+		__m256 clampScale = _mm256_blendv_ps(one, _mm256_div_ps(maximumForce, _mm256_sqrt_ps(forceSquared)),
+			_mm256_cmp_ps(forceSquared, maximumForceSquared, _CMP_GT_OQ));
+
+		_mm256_storeu_ps(forceX + i, _mm256_mul_ps(fx, clampScale));
+		_mm256_storeu_ps(forceY + i, _mm256_mul_ps(fy, clampScale));
+		_mm256_storeu_ps(forceZ + i, _mm256_mul_ps(fz, clampScale));
+	}
+	return i;
+}
+#endif
+
+// -------------------
+// Descripción: Función que rellena la lista de vecinos más cercanos de cada agente del rango a partir de la rejilla espacial.
+// 'idToAgent' traduce los ids de la rejilla a índices de agente (vacío = mismos índices).
+// -------------------
+void Steering::BuildNeighbours(const SpatialGrid& grid, const SteeringAgents& agents, unsigned int begin, unsigned int end,
+	const std::vector<unsigned int>& idToAgent, float radius, unsigned int maximumNeighbours,
+	unsigned int* neighbourCount, unsigned int* neighbours)
+{
+	std::vector<SpatialHit> hits;
+
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		unsigned int* list = neighbours + i * maximumNeighbours;
+		unsigned int found = 0;
+
+		// Se pide un vecino más porque el propio agente también aparece en la consulta
+		grid.QueryNearest(glm::vec3(agents.m_posX[i], agents.m_posY[i], agents.m_posZ[i]), maximumNeighbours + 1, radius, hits);
+
+		for (auto iter = hits.begin(); iter != hits.end() && found < maximumNeighbours; ++iter)
+		{
+			unsigned int agent = idToAgent.empty() ? (*iter).m_id : idToAgent[(*iter).m_id];
+
+			if (agent != i && agent < agents.m_count && (*iter).m_distance <= radius)
+				list[found++] = agent;
+		}
+
+		neighbourCount[i] = found;
+	}
+}
+
+// -------------------
+// Descripción: Función que calcula la fuerza combinada de cada agente: buscar (o huir si el objetivo está demasiado cerca)
+// con frenado de llegada, más separación de los vecinos, limitada a la fuerza máxima
+// -------------------
+void Steering::ComputeForces(const SteeringAgents& agents, const SteeringParams& params, unsigned int begin, unsigned int end,
+	const unsigned int* neighbourCount, const unsigned int* neighbours, unsigned int maximumNeighbours,
+	float* forceX, float* forceY, float* forceZ)
+{
+	unsigned int i = begin;
+
+#if STEERING_AVX2
+	if (HasAVX2())
+		i = ComputeForcesAVX2(agents, params, begin, end, neighbourCount, neighbours, maximumNeighbours, forceX, forceY, forceZ);
+#endif
+
+	// Resto de agentes (o todos si la CPU no tiene AVX2)
+	ComputeForcesScalar(agents, params, i, end, neighbourCount, neighbours, maximumNeighbours, forceX, forceY, forceZ);
+}
+
+// -------------------
+// Descripción: Función que aplica las fuerzas, limita la velocidad y mueve a los agentes (bucle simple que el compilador vectoriza)
+// -------------------
+void Steering::Integrate(SteeringAgents& agents, unsigned int begin, unsigned int end,
+	const float* forceX, const float* forceY, const float* forceZ, float maximumSpeed, float dt)
+{
+	float maximumSpeedSquared = maximumSpeed * maximumSpeed;
+
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		float vx = agents.m_velX[i] + forceX[i] * dt;
+		float vy = agents.m_velY[i] + forceY[i] * dt;
+		float vz = agents.m_velZ[i] + forceZ[i] * dt;
+
+		float speedSquared = vx * vx + vy * vy + vz * vz;
+		float scale = speedSquared > maximumSpeedSquared ? maximumSpeed / std::sqrt(speedSquared) : 1.0f;
+
+		agents.m_velX[i] = vx * scale;
+		agents.m_velY[i] = vy * scale;
+		agents.m_velZ[i] = vz * scale;
+
+		agents.m_posX[i] += agents.m_velX[i] * dt;
+		agents.m_posY[i] += agents.m_velY[i] * dt;
+		agents.m_posZ[i] += agents.m_velZ[i] * dt;
+	}
+}
+
+void Steering::ComputeForcesScalar(const SteeringAgents& agents, const SteeringParams& params, unsigned int begin, unsigned int end,
+	const unsigned int* neighbourCount, const unsigned int* neighbours, unsigned int maximumNeighbours,
+	float* forceX, float* forceY, float* forceZ)
+{
+	float separationRadiusSquared = params.m_separationRadius * params.m_separationRadius;
+
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		glm::vec3 pos(agents.m_posX[i], agents.m_posY[i], agents.m_posZ[i]);
+		glm::vec3 vel(agents.m_velX[i], agents.m_velY[i], agents.m_velZ[i]);
+		glm::vec3 toTarget = glm::vec3(agents.m_targetX[i], agents.m_targetY[i], agents.m_targetZ[i]) - pos;
+
+		float distanceSquared = glm::dot(toTarget, toTarget);
+		float distance = std::sqrt(distanceSquared);
+		float inverseDistance = distance > 1e-6f ? 1.0f / distance : 0.0f;
+		bool fleeing = distanceSquared < params.m_fleeRadius * params.m_fleeRadius;
+
+		float speed = params.m_maximumSpeed;
+
+		if (!fleeing && params.m_arrivalRadius > 0.0f)
+			speed = std::min(params.m_maximumSpeed, params.m_maximumSpeed * distance / params.m_arrivalRadius);
+
+		float weight = fleeing ? -params.m_fleeWeight : params.m_seekWeight;
+		glm::vec3 force = toTarget * (inverseDistance * speed * weight) - vel * std::fabs(weight);
+
+		if (neighbourCount && params.m_separationWeight > 0.0f)
+		{
+			glm::vec3 separation(0.0f, 0.0f, 0.0f);
+
+			for (unsigned int n = 0; n < neighbourCount[i]; ++n)
+			{
+				unsigned int other = neighbours[i * maximumNeighbours + n];
+				glm::vec3 offset = pos - glm::vec3(agents.m_posX[other], agents.m_posY[other], agents.m_posZ[other]);
+				float offsetSquared = glm::dot(offset, offset);
+
+				if (offsetSquared < separationRadiusSquared && offsetSquared > 1e-6f)
+					separation += offset / offsetSquared;
+			}
+
+			force += separation * (params.m_separationWeight * params.m_maximumSpeed);
+		}
+
+		float forceSquared = glm::dot(force, force);
+
+		if (forceSquared > params.m_maximumForce * params.m_maximumForce)
+			force *= params.m_maximumForce / std::sqrt(forceSquared);
+
+		forceX[i] = force.x;
+		forceY[i] = force.y;
+		forceZ[i] = force.z;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef __STEERING_H__
+#define __STEERING_H__
+
+#include "SpatialGrid.h"
+#include <vector>
+
+// Arreglos paralelos (SoA) de los agentes que se dirigen en lote
+struct SteeringAgents
+{
+	float* m_posX;
+	float* m_posY;
+	float* m_posZ;
+	float* m_velX;
+	float* m_velY;
+	float* m_velZ;
+	const float* m_targetX;
+	const float* m_targetY;
+	const float* m_targetZ;
+	unsigned int m_count;
+};
+
+struct SteeringParams
+{
+	float m_maximumSpeed;
+	float m_maximumForce;
+	float m_seekWeight;
+	float m_fleeWeight;
+	float m_fleeRadius;
+	float m_arrivalRadius;
+	float m_separationWeight;
+	float m_separationRadius;
+};
+
+// Núcleos de comportamiento de dirección (buscar, huir, llegada y separación) que procesan 8 agentes a la vez con AVX2.
+// El soporte se comprueba en tiempo de ejecución (CPUID); sin AVX2 se usa la misma fórmula agente por agente. Las listas de vecinos tienen un tamaño fijo por agente
+// ('maximumNeighbours' huecos) y todas las funciones trabajan sobre un rango para poder repartirse entre hilos.
+class Steering
+{
+public:
+	static void BuildNeighbours(const SpatialGrid& grid, const SteeringAgents& agents, unsigned int begin, unsigned int end,
+		const std::vector<unsigned int>& idToAgent, float radius, unsigned int maximumNeighbours,
+		unsigned int* neighbourCount, unsigned int* neighbours);
+
+	static void ComputeForces(const SteeringAgents& agents, const SteeringParams& params, unsigned int begin, unsigned int end,
+		const unsigned int* neighbourCount, const unsigned int* neighbours, unsigned int maximumNeighbours,
+		float* forceX, float* forceY, float* forceZ);
+
+	static void Integrate(SteeringAgents& agents, unsigned int begin, unsigned int end,
+		const float* forceX, const float* forceY, const float* forceZ, float maximumSpeed, float dt);
+
+private:
+	// Private functions
+	static void ComputeForcesScalar(const SteeringAgents& agents, const SteeringParams& params, unsigned int begin, unsigned int end,
+		const unsigned int* neighbourCount, const unsigned int* neighbours, unsigned int maximumNeighbours,
+		float* forceX, float* forceY, float* forceZ);
+};
+
+#endif // !__STEERING_H__
@@ -1,4 +1,5 @@
 #include "Terrain.h"
+#include "GLState.h"
 #include <fstream>
 #include "Dependencies\soil\include\SOIL.h"
 #include <cstdlib>
@@ -14,7 +15,8 @@ Terrain::Terrain() :
 	m_terrainLength(256), m_terrainWidth(256),
 	m_model(1.0f),
 	m_terrainXPos(0.0f),
-	m_terrainZPos(0.0f)
+	m_terrainZPos(0.0f),
+	seed(static_cast<std::uint32_t>(time(0)))
 {
 	m_model = glm::translate(glm::vec3(m_terrainXPos, 0.0f, m_terrainZPos));
 }
@@ -31,6 +33,17 @@ Terrain::~Terrain()
 void Terrain::InitTerrain(char* vs, char* fs)
 {
 	m_terrainShader.CreateProgram(vs, fs);
+
+	// Las unidades de textura no cambian: se fijan una sola vez al crear el programa
+	m_terrainShader.ActivateProgram();
+	m_terrainShader.SetInt("meshTexture", 0);
+	m_terrainShader.SetInt("rTexture", 1);
+	m_terrainShader.SetInt("gTexture", 2);
+	m_terrainShader.SetInt("bTexture", 3);
+	m_terrainShader.SetInt("blendMap", 4);
+	m_terrainShader.SetInt("grassNormalMap", 5);
+	m_terrainShader.DeactivateProgram();
+
 	std::vector<char*> images{ "soil", "soil2", "grass", "soil4", "blendMap", "grassNormalMap" };
 	m_terrainTexture.GenerateMultipleTextures(images);
 }
@@ -73,10 +86,14 @@ void Terrain::LoadHeightmapImage(const char* FileName)
 	std::vector<glm::vec2> Textures;
 	std::vector<glm::vec3> Normals;
 
+	m_vertexHeights.assign(m_vHeights.size() * m_vHeights[0].size(), 0.0f);
+
 	for (unsigned int i = 0; i < m_vHeights.size(); ++i)
 	{
 		for (unsigned int j = 0; j < m_vHeights[0].size(); ++j)
 		{
+			m_vertexHeights[i * m_vHeights[0].size() + j] = m_vHeights[i][j] * m_fTerrainHeight;
+
 			if (m_vHeights[i][j] <= 0.0)
 			{
 				continue;
@@ -108,36 +125,37 @@ void Terrain::LoadHeightmapImage(const char* FileName)
 	std::cout << "Terrain loading operation completed \n";
 
 	glGenVertexArrays(1, &m_VAO);
-	glBindVertexArray(m_VAO);
+	GLState::GetInstance().BindVertexArray(m_VAO);
 
 	glGenBuffers(1, &m_VBO[VERTEX_BUFFER]);
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO[VERTEX_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_VBO[VERTEX_BUFFER]);
 	glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(glm::vec3), &Vertices[0], GL_STATIC_DRAW);
 
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
 	glGenBuffers(1, &m_VBO[TEXTURE_BUFFER]);
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO[TEXTURE_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_VBO[TEXTURE_BUFFER]);
 	glBufferData(GL_ARRAY_BUFFER, Textures.size() * sizeof(glm::vec2), &Textures[0], GL_STATIC_DRAW);
 
 	glEnableVertexAttribArray(2);
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
 	glGenBuffers(1, &m_VBO[NORMAL_BUFFER]);
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO[NORMAL_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_VBO[NORMAL_BUFFER]);
 	glBufferData(GL_ARRAY_BUFFER, Normals.size() * sizeof(glm::vec3), &Normals[0], GL_STATIC_DRAW);
 
 	glEnableVertexAttribArray(3);
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
 	glGenBuffers(1, &m_VBO[ELEMENT_BUFFER]);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_VBO[ELEMENT_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_VBO[ELEMENT_BUFFER]);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), &m_indices[0], GL_STATIC_DRAW);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	// El VAO guarda el bfer de ndices: se desenlaza despus del VAO para no borrarlo de l
+	GLState::GetInstance().BindVertexArray(0);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::GetInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
 	std::cout << "Terrain loaded successfully!\n";
 }
@@ -147,8 +165,8 @@ void Terrain::LoadHeightmapImage(const char* FileName)
 // -------------------
 void Terrain::CreateTerrainWithPerlinNoise()
 {
-	// Establecer la semilla del ruido para que sea diferente cada vez.
-	noise.SetSeed(static_cast<unsigned int>(time(0)));
+	// Establecer la semilla del ruido: distinta cada vez salvo que se fije con SetSeed (repeticiones).
+	noise.SetSeed(static_cast<unsigned int>(seed));
 	double frequency = 4.2;
 	int octaves = 5;
 
@@ -223,6 +241,12 @@ void Terrain::CreateTerrainWithPerlinNoise()
 		}
 	}
 
+	// Guardar la altura con la que qued cada vrtice, as los oclusores siguen tambin a los bordes elevados
+	m_vertexHeights.resize(Vertices.size());
+
+	for (unsigned int i = 0; i < Vertices.size(); ++i)
+		m_vertexHeights[i] = Vertices[i].y;
+
 	// Calcular ndices
 	for (unsigned int i = 0; i < m_vHeights.size() - 1; ++i)
 	{
@@ -264,37 +288,38 @@ void Terrain::CreateTerrainWithPerlinNoise()
 	}
 
 	glGenVertexArrays(1, &m_VAO);
-	glBindVertexArray(m_VAO);
+	GLState::GetInstance().BindVertexArray(m_VAO);
 
 	glGenBuffers(TOTAL_BUFFERS, m_VBO);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO[VERTEX_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_VBO[VERTEX_BUFFER]);
 	glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(glm::vec3), &Vertices[0], GL_STATIC_DRAW);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO[TEXTURE_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_VBO[TEXTURE_BUFFER]);
 	glBufferData(GL_ARRAY_BUFFER, Textures.size() * sizeof(glm::vec2), &Textures[0], GL_STATIC_DRAW);
 	glEnableVertexAttribArray(2);
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO[NORMAL_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_VBO[NORMAL_BUFFER]);
 	glBufferData(GL_ARRAY_BUFFER, Normals.size() * sizeof(glm::vec3), &Normals[0], GL_STATIC_DRAW);
 	glEnableVertexAttribArray(3);
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO[TANGENT_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, m_VBO[TANGENT_BUFFER]);
 	glBufferData(GL_ARRAY_BUFFER, tangents.size() * sizeof(glm::vec3), &tangents[0], GL_STATIC_DRAW);
 	glEnableVertexAttribArray(4);
 	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
 
 	glGenBuffers(1, &m_VBO[ELEMENT_BUFFER]);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_VBO[ELEMENT_BUFFER]);
+	GLState::GetInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_VBO[ELEMENT_BUFFER]);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), &m_indices[0], GL_STATIC_DRAW);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	// El VAO guarda el bfer de ndices: se desenlaza despus del VAO para no borrarlo de l
+	GLState::GetInstance().BindVertexArray(0);
+	GLState::GetInstance().BindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::GetInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 // -------------------
@@ -363,6 +388,22 @@ float Terrain::GetHeightOfTerrain(float _X, float _Z)
 	return result;
 }
 
+// -------------------
+// Descripcin: Funcin que devuelve la altura con la que se subi a la GPU el vrtice (x, z) de la malla del terreno,
+// que est en (x * m_cellSpacing, z * m_cellSpacing); incluye la elevacin de los bordes. Fuera de la cuadrcula (o
+// antes de crear el terreno) devuelve 0, igual que GetHeightOfTerrain.
+// -------------------
+float Terrain::GetVertexHeight(int x, int z) const
+{
+	if (m_vHeights.empty() || x < 0 || z < 0 || x >= (int)m_vHeights.size() || z >= (int)m_vHeights[0].size() ||
+		m_vertexHeights.size() != m_vHeights.size() * m_vHeights[0].size())
+	{
+		return 0.0f;
+	}
+
+	return m_vertexHeights[x * m_vHeights[0].size() + z];
+}
+
 // -------------------
 // Descripcin: funcin de ayuda utilizada para encontrar la altura de un tringulo en el que se encuentra actualmente el jugador
 // -------------------
@@ -378,59 +419,16 @@ float Terrain::BarryCentric(glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, glm::vec2
 // -------------------
 // Descripcin: funcin que vincula el objeto de matriz de vrtices de terreno (VAO) y dibuja sus datos de vrtice
 // -------------------
-void Terrain::Draw(Camera& _cam, DirectionalLight* directionLight, PointLight* lamp, SpotLight* spotlight)
+void Terrain::Draw()
 {
 	m_terrainShader.ActivateProgram();
 
-	// Propiedades de textura
-	m_terrainShader.SetInt("meshTexture", 0);
-	m_terrainShader.SetInt("rTexture", 1);
-	m_terrainShader.SetInt("gTexture", 2);
-	m_terrainShader.SetInt("bTexture", 3);
-	m_terrainShader.SetInt("blendMap", 4);
-	m_terrainShader.SetInt("grassNormalMap", 5);
-
-	// Activa todas las texturas
+	// Activa todas las texturas (GLState se salta las unidades que ya tienen su textura del cuadro anterior)
 	for (unsigned int i = 0; i < 6; ++i)
 		m_terrainTexture.ActivateTextures(i);
 
-	// Matriz de transformacin de MVP
+	// La cmara y las luces llegan por los bloques compartidos (SceneUniforms); aqu solo queda la matriz del modelo
 	m_terrainShader.SetMat4("model", m_model);
-	m_terrainShader.SetMat4("view", _cam.GetViewMatrix());
-	m_terrainShader.SetMat4("projection", _cam.GetProjectionMatrix());
-	m_terrainShader.SetVec3("viewPos", _cam.GetCameraPos());
-
-	// ----------------------
-	// Propiedades de iluminacin
-	// ----------------------
-
-	// a. Luz direccional
-	m_terrainShader.SetVec3("dirLight.direction", directionLight->GetDirection());
-	m_terrainShader.SetVec3("dirLight.ambient", directionLight->GetAmbient());
-	m_terrainShader.SetVec3("dirLight.diffuse", directionLight->GetDiffuse());
-	m_terrainShader.SetVec3("dirLight.specular", directionLight->GetSpecular());
-	m_terrainShader.SetVec3("dirLight.lightColour", directionLight->GetColour());
-
-	// b. Algunas bombillas
-	m_terrainShader.SetVec3("pointLight.position", lamp->GetPos());
-	m_terrainShader.SetVec3("pointLight.ambient", lamp->GetAmbient());
-	m_terrainShader.SetVec3("pointLight.diffuse", lamp->GetDiffuse());
-	m_terrainShader.SetVec3("pointLight.specular", lamp->GetSpecular());
-	m_terrainShader.SetVec3("pointLight.lightColour", lamp->GetColour());
-	m_terrainShader.SetFloat("pointLight.constant", lamp->GetConstant());
-	m_terrainShader.SetFloat("pointLight.linear", lamp->GetLinear());
-	m_terrainShader.SetFloat("pointLight.quadratic", lamp->GetQuadratic());
-
-	// C. Destacar
-	m_terrainShader.SetVec3("spotlight.position", spotlight->GetPosition());
-	m_terrainShader.SetVec3("spotlight.direction", spotlight->GetDirection());
-	m_terrainShader.SetVec3("spotlight.diffuse", spotlight->GetDiffuse());
-	m_terrainShader.SetVec3("spotlight.specular", spotlight->GetSpecular());
-	m_terrainShader.SetFloat("spotlight.constant", spotlight->GetConstant());
-	m_terrainShader.SetFloat("spotlight.linear", spotlight->GetLinear());
-	m_terrainShader.SetFloat("spotlight.quadratic", spotlight->GetQuadratic());
-	m_terrainShader.SetFloat("spotlight.cutOff", glm::cos(glm::radians(spotlight->GetCutOff())));
-	m_terrainShader.SetFloat("spotlight.outerCutOff", glm::cos(glm::radians(spotlight->GetOuterCutOff())));
 
 	// efecto niebla
 	if (m_fog)
@@ -438,12 +436,26 @@ void Terrain::Draw(Camera& _cam, DirectionalLight* directionLight, PointLight* l
 	else
 		m_terrainShader.SetBool("fogActive", false);
 
-	// dibujar el terreno
-	glBindVertexArray(m_VAO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_VBO[ELEMENT_BUFFER]);
-	glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	// dibujar el terreno (el VAO ya guarda su bfer de ndices)
+	GLState::GetInstance().BindVertexArray(m_VAO);
+	GLState::GetInstance().DrawElements(GL_TRIANGLES, m_indices.size());
+}
 
-	m_terrainShader.DeactivateProgram();
+// -------------------
+// Descripcin: funcin que enva el terreno a la cola de dibujo con sus seis texturas (ver RenderQueue)
+// -------------------
+void Terrain::Submit(RenderQueue& queue)
+{
+	DrawPacket packet;
+	packet.m_shader = &m_terrainShader;
+	packet.m_vao = m_VAO;
+	packet.m_count = (GLsizei)m_indices.size();
+	packet.m_model = m_model;
+	packet.m_flags = m_fog ? DrawPacket::FLAG_FOG : 0;
+	packet.m_totalTextures = 6;
+
+	for (unsigned int i = 0; i < packet.m_totalTextures; ++i)
+		packet.m_textures[i] = m_terrainTexture.GetTexture(i);
+
+	queue.Submit(RenderQueue::PASS_OPAQUE, packet);
 }
\ No newline at end of file
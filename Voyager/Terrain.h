@@ -11,6 +11,7 @@
 #include "PerlinNoise.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "RenderQueue.h"
 #include "DirectionalLight.h"
 #include "PointLight.h"
 #include "SpotLight.h"
@@ -28,8 +29,12 @@ public:
 	void CreateTerrainWithPerlinNoise();
 	glm::vec3 CalculateNormal(unsigned int x, unsigned int z);
 	void SetFog(bool fogState) { m_fog = fogState; }
+	void SetSeed(std::uint32_t terrainSeed) { seed = terrainSeed; }
+	float GetCellSpacing() const { return m_cellSpacing; }
+	float GetVertexHeight(int x, int z) const;
 
-	void Draw(Camera& cam, DirectionalLight* directionLight, PointLight* lamp, SpotLight* spotlight);
+	void Draw();
+	void Submit(RenderQueue& queue);
 
 private:
 	Shader m_terrainShader;
@@ -52,6 +57,7 @@ private:
 	bool m_fog;
 
 	std::vector<std::vector<float> > m_vHeights;
+	std::vector<float> m_vertexHeights;	// Altura final de cada vrtice subido a la GPU (bordes elevados incluidos), fila a fila
 	std::vector<unsigned int> m_indices;
 
 private:
@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "GLState.h"
 #include <cassert>
 #include "ResourceManager.h"
 
@@ -8,7 +9,7 @@ Texture::Texture()
 
 Texture::~Texture()
 {
-	glDeleteTextures(1, &m_texture);
+	GLState::GetInstance().DeleteTextures(1, &m_texture);
 }
 
 // -------------------
@@ -21,8 +22,8 @@ void Texture::GenerateTexture(char* textureId)
 	ResourceManager::GetInstance().GetImageDimension(textureId, imgDimension);
 
 	glGenTextures(1, &m_texture);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_texture);
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_texture);
 
 	// Envoltura de textura
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -51,8 +52,8 @@ void Texture::GenerateMultipleTextures(std::vector<char*>& textureIds)
 		images[i] = ResourceManager::GetInstance().GetTexture(textureIds.at(i));
 		ResourceManager::GetInstance().GetImageDimension(textureIds.at(i), imgDimension);
 
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+		GLState::GetInstance().ActiveTexture(GL_TEXTURE0 + i);
+		GLState::GetInstance().BindTexture(GL_TEXTURE_2D, m_textures[i]);
 
 		// Envoltura de textura
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -73,8 +74,8 @@ void Texture::GenerateMultipleTextures(std::vector<char*>& textureIds)
 void Texture::GenerateSkybox(unsigned short int beginIndex, unsigned short int finalIndex)
 {
 	glGenTextures(1, &m_texture);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, m_texture);
+	GLState::GetInstance().ActiveTexture(GL_TEXTURE0);
+	GLState::GetInstance().BindTexture(GL_TEXTURE_CUBE_MAP, m_texture);
 	int c = 0;
 	std::vector<int> imgDimension;
 
@@ -101,8 +102,7 @@ void Texture::ActivateTexture(unsigned int unit)
 {
 	assert(unit >= 0 && unit <= 31);
 
-	glActiveTexture(GL_TEXTURE0 + unit);
-	glBindTexture(GL_TEXTURE_2D, m_texture);
+	GLState::GetInstance().BindTextureUnit(unit, m_texture);
 }
 
 // -------------------
@@ -112,6 +112,5 @@ void Texture::ActivateTextures(unsigned int unit)
 {
 	assert(unit >= 0 && unit <= 31);
 
-	glActiveTexture(GL_TEXTURE0 + unit);
-	glBindTexture(GL_TEXTURE_2D, m_textures[unit]);
+	GLState::GetInstance().BindTextureUnit(unit, m_textures[unit]);
 }
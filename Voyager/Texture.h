@@ -18,6 +18,9 @@ public:
 	void ActivateTextures(unsigned int unit = 0);
 	void GenerateSkybox(unsigned short int startIndex = 0, unsigned short int lastIndex = 6);
 
+	GLuint GetTexture() const { return m_texture; }
+	GLuint GetTexture(unsigned int unit) const { return m_textures[unit]; }
+
 private:
 	GLuint m_texture;
 	GLuint m_textures[32];
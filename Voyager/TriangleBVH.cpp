@@ -0,0 +1,557 @@
+#include "TriangleBVH.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+TriangleBVH::TriangleBVH() :
+	m_sourceHash(0)
+{}
+
+TriangleBVH::~TriangleBVH()
+{}
+
+// -------------------
+// Descripción: Función que construye la jerarquía a partir de los vértices e índices (triángulos) de la malla
+// -------------------
+void TriangleBVH::Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+	unsigned int triangleCount = (unsigned int)indices.size() / 3;
+
+	m_nodes.clear();
+	m_vertices.clear();
+	m_sourceHash = HashSource(positions, indices);
+
+	if (triangleCount == 0)
+		return;
+
+	std::vector<glm::vec3> source(triangleCount * 3);
+	std::vector<glm::vec3> centroids(triangleCount);
+	std::vector<unsigned int> triangles(triangleCount);
+
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		source[i * 3 + 0] = positions[indices[i * 3 + 0]];
+		source[i * 3 + 1] = positions[indices[i * 3 + 1]];
+		source[i * 3 + 2] = positions[indices[i * 3 + 2]];
+		centroids[i] = (source[i * 3 + 0] + source[i * 3 + 1] + source[i * 3 + 2]) * (1.0f / 3.0f);
+		triangles[i] = i;
+	}
+
+	m_nodes.reserve(triangleCount * 2);
+
+	Node root;
+	root.m_leftFirst = 0;
+	root.m_count = triangleCount;
+	m_nodes.push_back(root);
+
+	UpdateBounds(0, triangles, source);
+	Subdivide(0, 0, triangles, centroids, source);
+
+	// Guardar los triángulos en el orden de las hojas
+	m_vertices.resize(triangleCount * 3);
+
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		m_vertices[i * 3 + 0] = source[triangles[i] * 3 + 0];
+		m_vertices[i * 3 + 1] = source[triangles[i] * 3 + 1];
+		m_vertices[i * 3 + 2] = source[triangles[i] * 3 + 2];
+	}
+}
+
+void TriangleBVH::UpdateBounds(unsigned int node, const std::vector<unsigned int>& triangles, const std::vector<glm::vec3>& source)
+{
+	Node& current = m_nodes[node];
+	current.m_min = glm::vec3(FLT_MAX);
+	current.m_max = glm::vec3(-FLT_MAX);
+
+	for (unsigned int i = current.m_leftFirst; i < current.m_leftFirst + current.m_count; ++i)
+	{
+		for (unsigned int v = 0; v < 3; ++v)
+		{
+			current.m_min = glm::min(current.m_min, source[triangles[i] * 3 + v]);
+			current.m_max = glm::max(current.m_max, source[triangles[i] * 3 + v]);
+		}
+	}
+}
+
+// -------------------
+// Descripción: Función que parte el nodo por el plano de menor costo SAH, probando SAH_BINS cubetas por eje
+// sobre los centroides. Si partir no sale más barato que dejar la hoja (y cabe en una hoja), se queda como hoja.
+// -------------------
+void TriangleBVH::Subdivide(unsigned int node, unsigned int depth, std::vector<unsigned int>& triangles, const std::vector<glm::vec3>& centroids, const std::vector<glm::vec3>& source)
+{
+	unsigned int first = m_nodes[node].m_leftFirst;
+	unsigned int count = m_nodes[node].m_count;
+
+	// La profundidad se limita para que las pilas fijas de las consultas no se desborden
+	if (count <= 1 || depth >= MAX_DEPTH)
+		return;
+
+	glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+
+	for (unsigned int i = first; i < first + count; ++i)
+	{
+		centroidMin = glm::min(centroidMin, centroids[triangles[i]]);
+		centroidMax = glm::max(centroidMax, centroids[triangles[i]]);
+	}
+
+	auto area = [](const glm::vec3& min, const glm::vec3& max)
+	{
+		glm::vec3 size = max - min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	};
+
+	int bestAxis = -1;
+	float bestSplit = 0.0f;
+	float bestCost = FLT_MAX;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float extent = centroidMax[axis] - centroidMin[axis];
+
+		if (extent <= 0.0f)
+			continue;
+
+		glm::vec3 binMin[SAH_BINS], binMax[SAH_BINS];
+		unsigned int binCount[SAH_BINS] = {};
+
+		for (int b = 0; b < SAH_BINS; ++b)
+		{
+			binMin[b] = glm::vec3(FLT_MAX);
+			binMax[b] = glm::vec3(-FLT_MAX);
+		}
+
+		float scale = SAH_BINS / extent;
+
+		for (unsigned int i = first; i < first + count; ++i)
+		{
+			unsigned int triangle = triangles[i];
+			int bin = std::min(SAH_BINS - 1, (int)((centroids[triangle][axis] - centroidMin[axis]) * scale));
+
+			++binCount[bin];
+
+			for (unsigned int v = 0; v < 3; ++v)
+			{
+				binMin[bin] = glm::min(binMin[bin], source[triangle * 3 + v]);
+				binMax[bin] = glm::max(binMax[bin], source[triangle * 3 + v]);
+			}
+		}
+
+		// Barridos desde los dos lados para tener el área y la cuenta de cada mitad en cada plano
+		float leftArea[SAH_BINS - 1], rightArea[SAH_BINS - 1];
+		unsigned int leftCount[SAH_BINS - 1], rightCount[SAH_BINS - 1];
+		glm::vec3 leftMin(FLT_MAX), leftMax(-FLT_MAX), rightMin(FLT_MAX), rightMax(-FLT_MAX);
+		unsigned int leftSum = 0, rightSum = 0;
+
+		for (int b = 0; b < SAH_BINS - 1; ++b)
+		{
+			leftSum += binCount[b];
+			leftMin = glm::min(leftMin, binMin[b]);
+			leftMax = glm::max(leftMax, binMax[b]);
+			leftCount[b] = leftSum;
+			leftArea[b] = leftSum ? area(leftMin, leftMax) : 0.0f;
+
+			int r = SAH_BINS - 1 - b;
+			rightSum += binCount[r];
+			rightMin = glm::min(rightMin, binMin[r]);
+			rightMax = glm::max(rightMax, binMax[r]);
+			rightCount[r - 1] = rightSum;
+			rightArea[r - 1] = rightSum ? area(rightMin, rightMax) : 0.0f;
+		}
+
+		for (int b = 0; b < SAH_BINS - 1; ++b)
+		{
+			float cost = leftCount[b] * leftArea[b] + rightCount[b] * rightArea[b];
+
+			if (leftCount[b] > 0 && rightCount[b] > 0 && cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = centroidMin[axis] + extent * (b + 1) / SAH_BINS;
+			}
+		}
+	}
+
+	float leafCost = count * area(m_nodes[node].m_min, m_nodes[node].m_max);
+
+	if (bestAxis < 0 || (bestCost >= leafCost && count <= MAX_LEAF_TRIANGLES))
+		return;
+
+	// Partir los índices en el sitio
+	unsigned int i = first;
+	unsigned int j = first + count;
+
+	while (i < j)
+	{
+		if (centroids[triangles[i]][bestAxis] < bestSplit)
+			++i;
+		else
+			std::swap(triangles[i], triangles[--j]);
+	}
+
+	unsigned int leftCount = i - first;
+
+	if (leftCount == 0 || leftCount == count)
+		return;
+
+	unsigned int left = (unsigned int)m_nodes.size();
+	Node child;
+	child.m_leftFirst = first;
+	child.m_count = leftCount;
+	m_nodes.push_back(child);
+	child.m_leftFirst = i;
+	child.m_count = count - leftCount;
+	m_nodes.push_back(child);
+
+	m_nodes[node].m_leftFirst = left;
+	m_nodes[node].m_count = 0;
+
+	UpdateBounds(left, triangles, source);
+	UpdateBounds(left + 1, triangles, source);
+	Subdivide(left, depth + 1, triangles, centroids, source);
+	Subdivide(left + 1, depth + 1, triangles, centroids, source);
+}
+
+// -------------------
+// Descripción: Función que carga la jerarquía guardada junto al recurso o, si no existe o la malla cambió, la construye y la guarda
+// -------------------
+bool TriangleBVH::LoadOrBuild(const std::string& assetPath, const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+	std::string path = assetPath + ".bvh";
+
+	if (Load(path, HashSource(positions, indices)))
+		return true;
+
+	Build(positions, indices);
+	return Save(path);
+}
+
+bool TriangleBVH::Save(const std::string& path)
+{
+	std::ofstream file(path, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		printf("ERROR: Unable to write collision file: %s\n", path.c_str());
+		return false;
+	}
+
+	uint32_t header[5] = { 0x48564256u, FILE_VERSION, m_sourceHash, (uint32_t)m_nodes.size(), (uint32_t)m_vertices.size() };
+
+	file.write((const char*)header, sizeof(header));
+	file.write((const char*)m_nodes.data(), sizeof(Node) * m_nodes.size());
+	file.write((const char*)m_vertices.data(), sizeof(glm::vec3) * m_vertices.size());
+	return file.good();
+}
+
+// -------------------
+// Descripción: Función que lee el archivo guardado; falla si no existe, es de otra versión o se hizo con otra malla
+// -------------------
+bool TriangleBVH::Load(const std::string& path, uint32_t sourceHash)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file.is_open())
+		return false;
+
+	uint32_t header[5];
+	file.read((char*)header, sizeof(header));
+
+	if (!file || header[0] != 0x48564256u || header[1] != FILE_VERSION || header[2] != sourceHash)
+		return false;
+
+	m_nodes.resize(header[3]);
+	m_vertices.resize(header[4]);
+	file.read((char*)m_nodes.data(), sizeof(Node) * m_nodes.size());
+	file.read((char*)m_vertices.data(), sizeof(glm::vec3) * m_vertices.size());
+
+	if (!file)
+	{
+		printf("ERROR: Collision file is truncated: %s\n", path.c_str());
+		m_nodes.clear();
+		m_vertices.clear();
+		return false;
+	}
+
+	m_sourceHash = sourceHash;
+	return true;
+}
+
+// -------------------
+// Descripción: Función que busca el triángulo más cercano que toca el rayo (por las dos caras).
+// Se baja primero por el hijo más cercano para recortar pronto la distancia máxima.
+// -------------------
+bool TriangleBVH::Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, float& distance, glm::vec3& normal) const
+{
+	if (m_nodes.empty())
+		return false;
+
+	glm::vec3 invDir = 1.0f / dir;
+	float best = maxDistance;
+	int bestTriangle = -1;
+
+	auto slab = [&](const Node& node)
+	{
+		glm::vec3 t1 = (node.m_min - origin) * invDir;
+		glm::vec3 t2 = (node.m_max - origin) * invDir;
+		glm::vec3 low = glm::min(t1, t2);
+		glm::vec3 high = glm::max(t1, t2);
+		float tNear = std::max(std::max(std::max(low.x, low.y), low.z), 0.0f);
+		float tFar = std::min(std::min(std::min(high.x, high.y), high.z), best);
+		return tNear <= tFar ? tNear : FLT_MAX;
+	};
+
+	unsigned int stack[STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+
+		if (slab(node) == FLT_MAX)
+			continue;
+
+		if (node.m_count == 0)
+		{
+			float nearLeft = slab(m_nodes[node.m_leftFirst]);
+			float nearRight = slab(m_nodes[node.m_leftFirst + 1]);
+
+			// El más cercano va arriba de la pila
+			if (nearLeft < nearRight)
+			{
+				if (nearRight != FLT_MAX) stack[stackSize++] = node.m_leftFirst + 1;
+				if (nearLeft != FLT_MAX) stack[stackSize++] = node.m_leftFirst;
+			}
+			else
+			{
+				if (nearLeft != FLT_MAX) stack[stackSize++] = node.m_leftFirst;
+				if (nearRight != FLT_MAX) stack[stackSize++] = node.m_leftFirst + 1;
+			}
+
+			continue;
+		}
+
+		// Möller-Trumbore
+		for (unsigned int i = node.m_leftFirst; i < node.m_leftFirst + node.m_count; ++i)
+		{
+			const glm::vec3& a = m_vertices[i * 3 + 0];
+			glm::vec3 edge1 = m_vertices[i * 3 + 1] - a;
+			glm::vec3 edge2 = m_vertices[i * 3 + 2] - a;
+			glm::vec3 p = glm::cross(dir, edge2);
+			float det = glm::dot(edge1, p);
+
+			if (std::fabs(det) < 1e-8f)
+				continue;
+
+			float invDet = 1.0f / det;
+			glm::vec3 s = origin - a;
+			float u = glm::dot(s, p) * invDet;
+
+			if (u < 0.0f || u > 1.0f)
+				continue;
+
+			glm::vec3 q = glm::cross(s, edge1);
+			float v = glm::dot(dir, q) * invDet;
+
+			if (v < 0.0f || u + v > 1.0f)
+				continue;
+
+			float t = glm::dot(edge2, q) * invDet;
+
+			if (t >= 0.0f && t < best)
+			{
+				best = t;
+				bestTriangle = (int)i;
+			}
+		}
+	}
+
+	if (bestTriangle < 0)
+		return false;
+
+	distance = best;
+	normal = glm::normalize(glm::cross(m_vertices[bestTriangle * 3 + 1] - m_vertices[bestTriangle * 3], m_vertices[bestTriangle * 3 + 2] - m_vertices[bestTriangle * 3]));
+
+	// La normal mira hacia el origen del rayo
+	if (glm::dot(normal, dir) > 0.0f)
+		normal = -normal;
+
+	return true;
+}
+
+// -------------------
+// Descripción: Función que mueve una esfera de 'start' a 'end' por avance conservador: en cada paso la esfera
+// puede avanzar lo que la separa de la malla sin atravesarla. Devuelve la fracción del recorrido al tocar y la normal.
+// -------------------
+bool TriangleBVH::SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, float& t, glm::vec3& normal) const
+{
+	const float skin = 0.01f;
+
+	glm::vec3 segment = end - start;
+	float length = glm::length(segment);
+	float travelled = 0.0f;
+
+	for (int step = 0; step < MAX_SWEEP_STEPS; ++step)
+	{
+		glm::vec3 center = length > 0.0f ? start + segment * (travelled / length) : start;
+		glm::vec3 closest;
+
+		if (!ClosestPoint(center, radius + (length - travelled) + skin, closest))
+			return false;
+
+		float separation = glm::length(center - closest);
+
+		if (separation <= radius + skin)
+		{
+			t = length > 0.0f ? travelled / length : 0.0f;
+			normal = separation > 0.0f ? (center - closest) / separation : -segment / std::max(length, 1e-6f);
+			return true;
+		}
+
+		travelled += separation - radius;
+
+		if (travelled > length)
+			return false;
+	}
+
+	// Rozando la malla sin terminar de acercarse: se trata como contacto
+	t = length > 0.0f ? travelled / length : 0.0f;
+	normal = length > 0.0f ? -segment / length : glm::vec3(0.0f, 1.0f, 0.0f);
+	return true;
+}
+
+// -------------------
+// Descripción: Función que busca el punto de la malla más cercano a 'point' dentro de 'maxDistance'
+// -------------------
+bool TriangleBVH::ClosestPoint(const glm::vec3& point, float maxDistance, glm::vec3& closest) const
+{
+	if (m_nodes.empty())
+		return false;
+
+	float best = maxDistance;
+	bool found = false;
+
+	unsigned int stack[STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+
+		if (DistanceToBox(point, node.m_min, node.m_max) > best)
+			continue;
+
+		if (node.m_count == 0)
+		{
+			const Node& left = m_nodes[node.m_leftFirst];
+			const Node& right = m_nodes[node.m_leftFirst + 1];
+
+			// Visitar primero la caja más cercana
+			if (DistanceToBox(point, left.m_min, left.m_max) < DistanceToBox(point, right.m_min, right.m_max))
+			{
+				stack[stackSize++] = node.m_leftFirst + 1;
+				stack[stackSize++] = node.m_leftFirst;
+			}
+			else
+			{
+				stack[stackSize++] = node.m_leftFirst;
+				stack[stackSize++] = node.m_leftFirst + 1;
+			}
+
+			continue;
+		}
+
+		for (unsigned int i = node.m_leftFirst; i < node.m_leftFirst + node.m_count; ++i)
+		{
+			glm::vec3 candidate = ClosestPointOnTriangle(point, m_vertices[i * 3 + 0], m_vertices[i * 3 + 1], m_vertices[i * 3 + 2]);
+			float distance = glm::length(point - candidate);
+
+			if (distance <= best)
+			{
+				best = distance;
+				closest = candidate;
+				found = true;
+			}
+		}
+	}
+
+	return found;
+}
+
+uint32_t TriangleBVH::HashSource(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+	// FNV-1a sobre los bytes de la malla
+	uint32_t hash = 2166136261u;
+
+	auto mix = [&hash](const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+
+		for (size_t i = 0; i < size; ++i)
+			hash = (hash ^ bytes[i]) * 16777619u;
+	};
+
+	mix(positions.data(), positions.size() * sizeof(glm::vec3));
+	mix(indices.data(), indices.size() * sizeof(unsigned int));
+	return hash;
+}
+
+float TriangleBVH::DistanceToBox(const glm::vec3& point, const glm::vec3& min, const glm::vec3& max)
+{
+	glm::vec3 outside = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+	return glm::length(outside);
+}
+
+// -------------------
+// Descripción: Función que calcula el punto del triángulo abc más cercano a p por regiones de Voronoi
+// -------------------
+glm::vec3 TriangleBVH::ClosestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+	glm::vec3 ab = b - a;
+	glm::vec3 ac = c - a;
+	glm::vec3 ap = p - a;
+
+	float d1 = glm::dot(ab, ap);
+	float d2 = glm::dot(ac, ap);
+
+	if (d1 <= 0.0f && d2 <= 0.0f)
+		return a;
+
+	glm::vec3 bp = p - b;
+	float d3 = glm::dot(ab, bp);
+	float d4 = glm::dot(ac, bp);
+
+	if (d3 >= 0.0f && d4 <= d3)
+		return b;
+
+	float vc = d1 * d4 - d3 * d2;
+
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		return a + ab * (d1 / (d1 - d3));
+
+	glm::vec3 cp = p - c;
+	float d5 = glm::dot(ab, cp);
+	float d6 = glm::dot(ac, cp);
+
+	if (d6 >= 0.0f && d5 <= d6)
+		return c;
+
+	float vb = d5 * d2 - d1 * d6;
+
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		return a + ac * (d2 / (d2 - d6));
+
+	float va = d3 * d6 - d5 * d4;
+
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	float denom = 1.0f / (va + vb + vc);
+	float v = vb * denom;
+	float w = vc * denom;
+	return a + ab * v + ac * w;
+}
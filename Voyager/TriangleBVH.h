@@ -0,0 +1,56 @@
+#pragma once
+#ifndef __TRIANGLEBVH_H__
+#define __TRIANGLEBVH_H__
+
+#include "Dependencies/glm-0.9.9-a2/glm/glm.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Jerarquía de volúmenes (BVH) sobre los triángulos de una malla estática, en el espacio del modelo.
+// Se construye con particiones SAH por cubetas y se guarda junto al recurso ("<modelo>.bvh") para no
+// reconstruirla en cada carga. Los triángulos se guardan reordenados en el orden de las hojas.
+class TriangleBVH
+{
+public:
+	TriangleBVH();
+	~TriangleBVH();
+
+	void Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+	bool LoadOrBuild(const std::string& assetPath, const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+	bool Save(const std::string& path);
+	bool Load(const std::string& path, uint32_t sourceHash);
+
+	bool Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, float& distance, glm::vec3& normal) const;
+	bool SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, float& t, glm::vec3& normal) const;
+	bool ClosestPoint(const glm::vec3& point, float maxDistance, glm::vec3& closest) const;
+
+	bool IsBuilt() const { return !m_nodes.empty(); }
+	unsigned int GetTriangleCount() const { return (unsigned int)m_vertices.size() / 3; }
+	unsigned int GetNodeCount() const { return (unsigned int)m_nodes.size(); }
+
+private:
+	enum { SAH_BINS = 12, MAX_LEAF_TRIANGLES = 4, MAX_DEPTH = 60, STACK_SIZE = 64, MAX_SWEEP_STEPS = 32, FILE_VERSION = 1 };
+
+	// 32 bytes: hoja si m_count > 0 (triángulos desde m_leftFirst), si no los hijos están en m_leftFirst y m_leftFirst + 1
+	struct Node
+	{
+		glm::vec3 m_min;
+		uint32_t m_leftFirst;
+		glm::vec3 m_max;
+		uint32_t m_count;
+	};
+
+	std::vector<Node> m_nodes;
+	std::vector<glm::vec3> m_vertices;	// Tres por triángulo
+	uint32_t m_sourceHash;
+
+	// Private functions
+	void Subdivide(unsigned int node, unsigned int depth, std::vector<unsigned int>& triangles, const std::vector<glm::vec3>& centroids, const std::vector<glm::vec3>& source);
+	void UpdateBounds(unsigned int node, const std::vector<unsigned int>& triangles, const std::vector<glm::vec3>& source);
+	static uint32_t HashSource(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+	static float DistanceToBox(const glm::vec3& point, const glm::vec3& min, const glm::vec3& max);
+	static glm::vec3 ClosestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+};
+
+#endif // !__TRIANGLEBVH_H__
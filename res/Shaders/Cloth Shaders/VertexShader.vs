@@ -7,13 +7,22 @@ in vec2 uv;
 out vec2 vUV;
 out vec3 vNormal;
 
-uniform mat4 mvp;
-uniform mat4 view;
+uniform mat4 model;
+
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
 
 void main ()
 {
 	mat3 normalMatrix = inverse(transpose(mat3(view)));
     vNormal = normalize(normalMatrix * normal);
     vUV = uv;
-    gl_Position = mvp * vec4(position, 1.0f);
+    gl_Position = viewProjection * model * vec4(position, 1.0f);
 }
\ No newline at end of file
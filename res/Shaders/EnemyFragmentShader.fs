@@ -1,5 +1,15 @@
 #version 440 core
 
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
+
 out vec4 FragColor;
 in vec4 vertexColor;
 in vec2 vertexUv;
@@ -9,25 +19,50 @@ in vec3 fragPos;
 uniform sampler2D meshTexture;
 
 uniform vec3 lightPos; 
-uniform vec3 viewPos;
 uniform bool damaged;
 
+// Light structs laid out for std140 (see SceneUniforms.h)
+struct DirectionalLight
+{
+	vec3 direction;
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+	vec3 lightColour;
+};
+
+struct PointLight
+{
+	vec3 position;
+	float constant;
+	vec3 ambient;
+	float linear;
+	vec3 diffuse;
+	float quadratic;
+	vec3 specular;
+	vec3 lightColour;
+};
+
 struct Spotlight
 {
 	vec3 position;
-	vec3 direction;
 	float cutOff;
+	vec3 direction;
 	float outerCutOff;
-	 
 	vec3 diffuse;
-	vec3 specular;
-	
 	float constant;
+	vec3 specular;
 	float linear;
 	float quadratic;
 };
 
-uniform Spotlight spotlight;
+// Shared light set, uploaded once per frame
+layout (std140) uniform LightBlock
+{
+	DirectionalLight dirLight;
+	PointLight pointLight;
+	Spotlight spotlight;
+};
 
 // Function prototype
 vec3 CalculateSpotlight(Spotlight light, vec3 normal, vec3 viewDir);
@@ -0,0 +1,135 @@
+#version 440 core
+
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
+
+out vec4 FragColor;
+in vec4 vertexColor;
+in vec2 vertexUv;
+in vec3 vertexNorms;
+in vec3 fragPos;
+flat in vec4 tint;
+flat in vec4 params;
+
+uniform sampler2D meshTexture;
+
+uniform vec3 lightPos; 
+uniform bool EnableSpotlight;
+
+// Light structs laid out for std140 (see SceneUniforms.h)
+struct DirectionalLight
+{
+	vec3 direction;
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+	vec3 lightColour;
+};
+
+struct PointLight
+{
+	vec3 position;
+	float constant;
+	vec3 ambient;
+	float linear;
+	vec3 diffuse;
+	float quadratic;
+	vec3 specular;
+	vec3 lightColour;
+};
+
+struct Spotlight
+{
+	vec3 position;
+	float cutOff;
+	vec3 direction;
+	float outerCutOff;
+	vec3 diffuse;
+	float constant;
+	vec3 specular;
+	float linear;
+	float quadratic;
+};
+
+// Shared light set, uploaded once per frame
+layout (std140) uniform LightBlock
+{
+	DirectionalLight dirLight;
+	PointLight pointLight;
+	Spotlight spotlight;
+};
+
+// Function prototype
+vec3 CalculateSpotlight(Spotlight light, vec3 normal, vec3 viewDir);
+
+void main()
+{
+	vec4 texColor = texture(meshTexture, vertexUv);
+
+	float ambientFactor = 0.3f;
+	vec3 lightColor = vec3(0.5f, 0.972f, 0.905f);
+	vec3 ambient = ambientFactor * lightColor;
+
+	vec3 norm = normalize(vertexNorms);
+	vec3 lightDir = normalize(lightPos - fragPos);
+
+	float diff = max(dot(norm, lightDir), 0.0f);
+	vec3 diffuse = diff * lightColor;	 
+
+	float specularFactor = 0.5f;
+	vec3 viewDir = normalize(viewPos - fragPos);
+	vec3 reflectDir = reflect(-lightDir, norm);
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+	vec3 specular = specularFactor * spec * lightColor;
+	vec3 spotlightResult = vec3(0.0f);
+
+	// Only lit by the player's torch while it is on
+	if (EnableSpotlight)
+		spotlightResult = CalculateSpotlight(spotlight, norm, viewDir);
+	
+	if (texColor.a < 0.1f) 
+		discard;
+	
+	vec3 result;
+	
+	// params.x = damage flash, params.z = unlit
+	if (params.x > 0.5f)
+		result = vec3(0.7f, 0.0f, 0.0f);
+	else if (params.z > 0.5f)
+		result = vec3(texColor) * vec3(tint);
+	else
+		result = (ambient + diffuse + specular + spotlightResult) * vec3(texColor) * vec3(tint);
+		
+    FragColor = vec4(result, tint.a);
+} 
+
+vec3 CalculateSpotlight(Spotlight light, vec3 normal, vec3 viewDir)
+{
+	vec3 lightDir = normalize(light.position - fragPos);
+	float diff = max(dot(normal, lightDir), 0.0);
+	
+	vec3 reflectDirection = reflect(-lightDir, normal);
+	float spec = pow(max(dot(viewDir, reflectDirection), 0), 32);
+	
+	float distance = length(light.position - fragPos);
+	float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+	
+	// Spotlight brightness
+	float theta = dot(lightDir, normalize(-light.direction));
+	float epsilon = light.cutOff - light.outerCutOff;
+	float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+	
+	vec3 diffuse = light.diffuse;
+	vec3 specular = light.specular;
+	diffuse *= attenuation * intensity;
+	specular *= attenuation * intensity;
+	
+	return (diffuse + specular);
+}
\ No newline at end of file
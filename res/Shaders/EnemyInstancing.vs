@@ -0,0 +1,49 @@
+#version 440 core
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_color;
+layout (location = 2) in vec2 vertex_uv;
+layout (location = 3) in vec3 vertex_normals;
+
+// Per-instance data (see InstancedBatch.h)
+layout (location = 5) in vec4 instancePosScale;
+layout (location = 6) in vec4 instanceTint;
+layout (location = 7) in vec4 instanceParams;
+
+out vec4 vertexColor; 
+out vec2 vertexUv;
+out vec3 vertexNorms;
+out vec3 fragPos;
+flat out vec4 tint;
+flat out vec4 params;
+
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
+
+void main()
+{
+	// Same spin angle on all three axes, like SetTransform with a uniform rotation
+	float angle = radians(instanceParams.y);
+	float c = cos(angle);
+	float s = sin(angle);
+	mat3 rotX = mat3(1.0f, 0.0f, 0.0f, 0.0f, c, s, 0.0f, -s, c);
+	mat3 rotY = mat3(c, 0.0f, -s, 0.0f, 1.0f, 0.0f, s, 0.0f, c);
+	mat3 rotZ = mat3(c, s, 0.0f, -s, c, 0.0f, 0.0f, 0.0f, 1.0f);
+	mat3 rotation = rotX * rotY * rotZ;
+
+	vec3 worldPos = rotation * (vertex_position * instancePosScale.w) + instancePosScale.xyz;
+
+    gl_Position = projection * view * vec4(worldPos, 1.0f);
+	vertexColor = vec4(vertex_color, 1.0f);
+	vertexUv = vertex_uv;
+	fragPos = worldPos;
+	vertexNorms = rotation * vertex_normals;
+	tint = instanceTint;
+	params = instanceParams;
+}
\ No newline at end of file
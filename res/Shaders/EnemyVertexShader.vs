@@ -10,8 +10,15 @@ out vec3 vertexNorms;
 out vec3 fragPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
 
 void main()
 {
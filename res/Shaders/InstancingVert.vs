@@ -2,7 +2,11 @@
 layout (location = 0) in vec3 vertex_position;
 layout (location = 1) in vec3 vertex_normals;
 layout (location = 2) in vec2 vertex_uv;
-layout (location = 3) in mat4 instanceMatrix;
+
+// Compact per-instance data, 24 bytes per asteroid (see AsteroidBelt.h)
+layout (location = 3) in vec4 instancePositionScale;	// xyz = position, w = uniform scale
+layout (location = 4) in vec2 instanceAxis;				// octahedral-encoded rotation axis (snorm16)
+layout (location = 5) in vec2 instanceSpin;				// x = angular speed (rad/s), y = initial phase (rad)
 
 out VS_OUT 
 {
@@ -11,13 +15,42 @@ out VS_OUT
     vec2 TexCoords;
 } vs_out;
 
-uniform mat4 view;
-uniform mat4 projection;
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
+
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -t : t;
+	n.y += n.y >= 0.0f ? -t : t;
+	return normalize(n);
+}
+
+// Rodrigues' rotation of v around the unit axis k
+vec3 Rotate(vec3 v, vec3 k, float c, float s)
+{
+	return v * c + cross(k, v) * s + k * dot(k, v) * (1.0f - c);
+}
 
 void main()
 {
-    gl_Position = projection * view *  instanceMatrix * vec4(vertex_position, 1.0f);
-	vs_out.FragPos = vec3(instanceMatrix * vec4(vertex_position, 1.0f));
+	vec3 axis = DecodeOctahedral(instanceAxis);
+	float angle = instanceSpin.y + instanceSpin.x * time;
+	float c = cos(angle);
+	float s = sin(angle);
+
+	vec3 worldPos = instancePositionScale.xyz + Rotate(vertex_position, axis, c, s) * instancePositionScale.w;
+
+    gl_Position = viewProjection * vec4(worldPos, 1.0f);
+	vs_out.FragPos = worldPos;
 	vs_out.TexCoords = vertex_uv;
-	vs_out.Normal = vertex_normals;
+	vs_out.Normal = Rotate(vertex_normals, axis, c, s);
 }
\ No newline at end of file
@@ -13,7 +13,16 @@ uniform sampler2D meshTexture;
 uniform sampler2D normalMap;
 
 uniform vec3 lightPos; 
-uniform vec3 viewPos;
+
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
 
 void main()
 {
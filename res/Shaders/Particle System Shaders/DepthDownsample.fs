@@ -0,0 +1,24 @@
+#version 440 core
+
+in vec2 VertexUv;
+
+uniform sampler2D sceneDepth;
+uniform int downsampleFactor;
+
+void main()
+{
+	// Conserva la profundidad mas lejana de cada bloque para que las particulas no desaparezcan en los bordes de la geometria
+	ivec2 base = ivec2(gl_FragCoord.xy) * downsampleFactor;
+	ivec2 maxCoord = textureSize(sceneDepth, 0) - 1;
+	float farthest = 0.0f;
+
+	for (int y = 0; y < downsampleFactor; ++y)
+	{
+		for (int x = 0; x < downsampleFactor; ++x)
+		{
+			farthest = max(farthest, texelFetch(sceneDepth, min(base + ivec2(x, y), maxCoord), 0).r);
+		}
+	}
+
+	gl_FragDepth = farthest;
+}
\ No newline at end of file
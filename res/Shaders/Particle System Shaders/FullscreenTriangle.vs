@@ -0,0 +1,11 @@
+#version 440 core
+
+out vec2 VertexUv;
+
+void main()
+{
+	// Triangulo que cubre toda la pantalla generado a partir de gl_VertexID (no necesita buffers)
+	vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	VertexUv = pos;
+	gl_Position = vec4(pos * 2.0f - 1.0f, 0.0f, 1.0f);
+}
\ No newline at end of file
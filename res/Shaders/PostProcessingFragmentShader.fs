@@ -12,10 +12,25 @@ uniform bool blurEffect;
 uniform bool grayScaleEffect;
 uniform bool thunderstormEffect;
 
+// Particulas dibujadas a resolucion reducida
+uniform bool lowResParticles;
+uniform sampler2D particleBuffer;
+uniform sampler2D particleDepth;
+uniform sampler2D sceneDepth;
+uniform float cameraNear;
+uniform float cameraFar;
+
+const float DEPTH_EPSILON = 0.05f;
+
+// Function prototype
+float LinearizeDepth(float depth);
+vec4 UpsampleParticles(vec2 uv);
+vec4 SampleScene(vec2 uv);
+
 void main()
 {	
 	// Normal
-	vec4 outputColor = texture(screenQuad, VertexUv);
+	vec4 outputColor = SampleScene(VertexUv);
 
 	// Change contrast of texture so dark colors are slightly more darker and brighter colors are slightly brighter
 	outputColor.rgb = (outputColor.rgb - 0.4f) * (1.0f + CONTRAST) + 0.4f;
@@ -100,7 +115,7 @@ void main()
 	else if (grayScaleEffect)
 	{
 		// Grayscale: Remove all colors except black, white and gray (average all color components)
-		FragColor = texture(screenQuad, VertexUv);
+		FragColor = SampleScene(VertexUv);
 		float average = (FragColor.r + FragColor.g + FragColor.b) / 3.0f;
 		FragColor = vec4(average, average, average, 1.0f);
 	}
@@ -108,4 +123,51 @@ void main()
 	{
 		FragColor = vec4(outputColor.rgb, 1.0f);
 	}
-} 
\ No newline at end of file
+} 
+
+vec4 SampleScene(vec2 uv)
+{
+	vec4 sceneColor = texture(screenQuad, uv);
+	
+	if (!lowResParticles)
+		return sceneColor;
+	
+	// Las particulas estan premultiplicadas: el alfa indica cuanto del fondo queda cubierto
+	vec4 particles = UpsampleParticles(uv);
+	return vec4(sceneColor.rgb * (1.0f - particles.a) + particles.rgb, 1.0f);
+}
+
+float LinearizeDepth(float depth)
+{
+	float z = depth * 2.0f - 1.0f;
+	return (2.0f * cameraNear * cameraFar) / (cameraFar + cameraNear - z * (cameraFar - cameraNear));
+}
+
+// Reescalado bilateral: pondera los 4 texels de baja resolucion mas cercanos por distancia bilineal y por similitud de profundidad
+vec4 UpsampleParticles(vec2 uv)
+{
+	ivec2 lowResSize = textureSize(particleBuffer, 0);
+	vec2 texel = uv * vec2(lowResSize) - 0.5f;
+	vec2 f = fract(texel);
+	ivec2 base = ivec2(floor(texel));
+	float fullResDepth = LinearizeDepth(texture(sceneDepth, uv).r);
+	
+	vec4 result = vec4(0.0f);
+	float totalWeight = 0.0f;
+	
+	for (int i = 0; i < 4; ++i)
+	{
+		ivec2 offset = ivec2(i & 1, i >> 1);
+		ivec2 coord = clamp(base + offset, ivec2(0), lowResSize - 1);
+		
+		float bilinearWeight = (offset.x == 1 ? f.x : 1.0f - f.x) * (offset.y == 1 ? f.y : 1.0f - f.y);
+		float lowResDepth = LinearizeDepth(texelFetch(particleDepth, coord, 0).r);
+		float depthWeight = 1.0f / (DEPTH_EPSILON + abs(fullResDepth - lowResDepth));
+		float weight = bilinearWeight * depthWeight;
+		
+		result += texelFetch(particleBuffer, coord, 0) * weight;
+		totalWeight += weight;
+	}
+	
+	return result / max(totalWeight, 0.00001f);
+}
\ No newline at end of file
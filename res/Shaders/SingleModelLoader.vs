@@ -14,8 +14,15 @@ const float fogDensity = 0.0022f;
 const float gradient = 7.0f;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
 
 void main()
 {
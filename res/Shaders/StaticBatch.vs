@@ -0,0 +1,47 @@
+#version 440 core
+
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_normal;
+layout (location = 2) in vec2 vertex_Uv;
+// Position of this draw inside the static batch: the instanced attribute returns the command's baseInstance
+layout (location = 3) in uint drawId;
+
+out vec2 TexCoords;
+out vec3 vertexNormal;
+out vec3 fragPos;
+
+// Fog items 
+out float visibility; 
+const float fogDensity = 0.0022f;
+const float gradient = 7.0f;
+
+// One transform per draw, uploaded once when the batch is built (see StaticBatcher.h)
+layout (std430, binding = 0) readonly buffer DrawTransforms
+{
+	mat4 transforms[];
+};
+
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
+
+void main()
+{
+	mat4 model = transforms[drawId];
+    TexCoords = vertex_Uv;    
+    gl_Position = projection * view * model * vec4(vertex_position, 1.0f);
+	vertexNormal = vertex_normal;
+	fragPos = vec3(model * vec4(vertex_position, 1.0f));
+	
+	// Fog calculation (calculate distance of this vertex to camera)
+	vec4 worldPos = model * vec4(vertex_position, 1.0f);
+	vec4 posRelativeToCamera = view * worldPos;
+	float distanceFromCamera = length(posRelativeToCamera.xyz);
+	visibility = exp(-pow((distanceFromCamera * fogDensity), gradient));
+}
\ No newline at end of file
@@ -1,46 +1,58 @@
 #version 440 core
 
+// Light structs laid out for std140 (see SceneUniforms.h)
 struct DirectionalLight
 {
 	vec3 direction;
-	
 	vec3 ambient;
 	vec3 diffuse;
 	vec3 specular;
-	
 	vec3 lightColour;
 };
 
 struct PointLight
 {
 	vec3 position;
-	
+	float constant;
 	vec3 ambient;
+	float linear;
 	vec3 diffuse;
+	float quadratic;
 	vec3 specular;
-	
-	float constant;
-	float linear;
-	float quadratic; 
-	
 	vec3 lightColour;
 };
 
 struct Spotlight
 {
 	vec3 position;
-	vec3 direction;
 	float cutOff;
+	vec3 direction;
 	float outerCutOff;
-	 
 	vec3 diffuse;
-	vec3 specular;
-	
 	float constant;
+	vec3 specular;
 	float linear;
 	float quadratic;
 };
 
+// Shared light set, uploaded once per frame
+layout (std140) uniform LightBlock
+{
+	DirectionalLight dirLight;
+	PointLight pointLight;
+	Spotlight spotlight;
+};
+
+// Shared camera data, uploaded once per frame (see SceneUniforms.h)
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec3 viewPos;
+	float time;
+};
+
 out vec4 FragColor;
 in vec4 vertexColor;
 in vec2 vertexUv;
@@ -61,11 +73,6 @@ uniform sampler2D grassNormalMap;
 
 uniform vec3 lightPos; 
 uniform vec3 cameraDir;
-uniform vec3 viewPos;
-
-uniform DirectionalLight dirLight;
-uniform PointLight pointLight;
-uniform Spotlight spotlight;
 
 vec4 totalColour;
 